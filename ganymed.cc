@@ -12,6 +12,7 @@
 #include "MArgs.h"
 #include "MArray.h"
 #include "MDirIter.h"
+#include "MDirIndex.h"
 
 #include "MStatusDisplay.h"
 
@@ -73,6 +74,7 @@ static void Usage()
     gLog << "   --out=path                Path to write all output to [def=local path]"       << endl;
     gLog << "   --ind=path                Path to data/star files [default=datacenter path]"  << endl;
     gLog << "   --ins=path                Path to sequence files [default=datacenter path]"   << endl;
+    gLog << "   --dir-index=file          Store/read the directory listings to/from file"   << endl;
     gLog << "   --outf=filename           Filename for output file (eg. status display)"      << endl;
     gLog << "   --sum[=filename]          Enable writing of summary file (events after cut0)" << endl;
 //    gLog << "   --res[=filename]          Enable writing of result file (surviving events)" << endl;
@@ -154,6 +156,7 @@ int main(int argc, char **argv)
     const TString kOutfile       = arg.GetStringAndRemove("--outf=",  "");
     const TString kPathDataFiles = arg.GetStringAndRemove("--ind=",  "");
     const TString kPathSequences = arg.GetStringAndRemove("--ins=",  "");
+    const TString kDirIndex      = arg.GetStringAndRemove("--dir-index=", "");
     const Bool_t  kWriteSummary  = arg.HasOnlyAndRemove("--sum");
     const TString kNameSummary   = arg.GetStringAndRemove("--sum=");
     const Bool_t  kSkipResult    = arg.HasOnlyAndRemove("--skip-res");
@@ -224,6 +227,13 @@ int main(int argc, char **argv)
     if (kDebugMem)
         TObject::SetObjectStat(kTRUE);
 
+    //
+    // Index of the directory listings to speed up finding the files
+    // (written back to the file at exit if it has changed)
+    //
+    MDirIndex index(kDirIndex.IsNull() ? 0 : kDirIndex.Data());
+    MDirIter::SetIndex(&index);
+
     //
     // Setup sequence and check its validity
     //
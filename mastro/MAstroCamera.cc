@@ -363,14 +363,18 @@ void MAstroCamera::AddPrimitives(TString o)
 
     const TRotation rot(GetGrid(kTRUE));
 
+    // Stars inside the field of view (fRadiusFOV) around the pointing
+    // position. Without time and observatory the rotation is the identity
+    // and not aligned with fRaDec, so the whole sky is searched.
+    TObjArray stars;
+    FindStars(stars, fRaDec, rot.IsIdentity() ? 180 : GetRadiusFOV(), GetLimMag());
+
     MVector3 *radec;
-    TIter Next(&fList);
+    TIter Next(&stars);
 
     while ((radec=(MVector3*)Next()))
     {
         const Double_t mag = radec->Magnitude();
-        if (mag>GetLimMag())
-            continue;
 
         TVector3 star(*radec);
 
@@ -109,6 +109,19 @@
 //    * the red lines are sky coordinate system
 //
 //
+//  Sky index:
+//  ----------
+//  For queries of the stars in a cone (FindStars) the list of stars is
+//  indexed in cells of roughly 1deg x 1deg: declination bands of 1deg
+//  which are divided into cells of equal right ascension, such that
+//  each cell spans about 1deg on the sky. Inside each cell the stars
+//  are sorted by magnitude (brightest first), so that a query with
+//  a limiting magnitude can stop early. The index is built when it is
+//  needed the first time after the list has changed. Hence, a query
+//  only touches the cells overlapping with the cone instead of all
+//  stars of the catalog. If the list returned by GetList() is changed
+//  directly, call ResetIndex().
+//
 //  ToDo:
 //  -----
 //   - replace MVetcor3 by a more convinient class. Maybe use TExMap, too.
@@ -177,7 +190,7 @@ const TString MAstroCatalog::kDefaultPath="/magic/datacenter/setup/";
 //   fLimMag    = 99
 //   fRadiusFOV = 90
 //
-MAstroCatalog::MAstroCatalog() : fLimMag(99), fRadiusFOV(90), fToolTip(0), fObservatory(0), fTime(0)
+MAstroCatalog::MAstroCatalog() : fLimMag(99), fRadiusFOV(90), fToolTip(0), fIndexValid(kFALSE), fObservatory(0), fTime(0)
 {
     fList.SetOwner();
     fMapG.SetOwner();
@@ -677,6 +690,8 @@ Int_t MAstroCatalog::ReadCompressed(TString catalog)
         add++;
     }
 
+    ResetIndex();
+
     gLog << inf << "Read " << add << " out of " << n << " (Total max mag=" << maxmag << ")" << endl;
 
     return add;
@@ -701,9 +716,194 @@ Bool_t MAstroCatalog::AddObject(Float_t ra, Float_t dec, Float_t mag, TString na
 
     SetBit(kHasChanged);
     fList.AddLast(star);
+    ResetIndex();
     return 1;
 }
 
+// --------------------------------------------------------------------------
+//
+// Delete the sky index. It is rebuilt by the next call to FindStars.
+//
+void MAstroCatalog::ResetIndex()
+{
+    fIndexStars.Clear();
+    fIndexValid = kFALSE;
+}
+
+// --------------------------------------------------------------------------
+//
+// Return the number of cells of the declination band b of the sky index
+//
+Int_t MAstroCatalog::GetNumIndexCells(Int_t b) const
+{
+    const Double_t dec = (b+0.5)*180/kNumIndexBands - 90;
+    const Int_t    n   = TMath::Nint(360*TMath::Cos(dec*TMath::DegToRad())*kNumIndexBands/180);
+    return TMath::Max(n, 1);
+}
+
+// --------------------------------------------------------------------------
+//
+// Return the cell of the sky index for the unit vector v
+//
+Int_t MAstroCatalog::GetIndexCell(const TVector3 &v) const
+{
+    const Double_t dec = 90 - v.Theta()*TMath::RadToDeg();
+    const Double_t ra  = v.Phi()*TMath::RadToDeg();
+
+    const Int_t b = TMath::Min(Int_t((dec+90)*kNumIndexBands/180), kNumIndexBands-1);
+    const Int_t n = fIndexBand[b+1]-fIndexBand[b];
+
+    const Int_t c = Int_t((ra<0 ? ra+360 : ra)*n/360);
+
+    return fIndexBand[b] + TMath::Min(c, n-1);
+}
+
+// --------------------------------------------------------------------------
+//
+// Build the sky index from the list of stars, see class description.
+//
+void MAstroCatalog::BuildIndex()
+{
+    // Layout of the cells
+    fIndexBand.Set(kNumIndexBands+1);
+
+    Int_t ncells = 0;
+    for (Int_t b=0; b<kNumIndexBands; b++)
+    {
+        fIndexBand[b] = ncells;
+        ncells += GetNumIndexCells(b);
+    }
+    fIndexBand[kNumIndexBands] = ncells;
+
+    // Magnitudes of all stars (in the order of fList)
+    const Int_t n = fList.GetEntries();
+
+    TObjArray stars(n);
+    MArrayD   mag(n);
+
+    Int_t i=0;
+
+    TIter Next(&fList);
+    MVector3 *v=0;
+    while ((v=(MVector3*)Next()))
+    {
+        stars.AddAt(v, i);
+        mag[i++] = v->Magnitude();
+    }
+
+    // Sort by magnitude. The counting sort into the cells below keeps
+    // this order inside each cell.
+    MArrayI order(n);
+    TMath::Sort(n, mag.GetArray(), order.GetArray(), kFALSE);
+
+    MArrayI cell(n);
+    fIndexCell.Set(ncells+1);
+    fIndexCell.Reset();
+
+    for (i=0; i<n; i++)
+    {
+        cell[i] = GetIndexCell(*static_cast<MVector3*>(stars.UncheckedAt(i)));
+        fIndexCell[cell[i]+1]++;
+    }
+
+    for (Int_t c=0; c<ncells; c++)
+        fIndexCell[c+1] += fIndexCell[c];
+
+    fIndexStars.Clear();
+    fIndexStars.Expand(n);
+    fIndexDir.Set(3*n);
+    fIndexMag.Set(n);
+
+    MArrayI pos(fIndexCell);
+    for (i=0; i<n; i++)
+    {
+        const Int_t k   = order[i];
+        const Int_t idx = pos[cell[k]]++;
+
+        const MVector3 &star = *static_cast<MVector3*>(stars.UncheckedAt(k));
+        const TVector3  u    = star.Unit();
+
+        fIndexStars.AddAt(stars.UncheckedAt(k), idx);
+        fIndexMag[idx]       = mag[k];
+        fIndexDir[3*idx]     = u.X();
+        fIndexDir[3*idx+1]   = u.Y();
+        fIndexDir[3*idx+2]   = u.Z();
+    }
+
+    fIndexValid = kTRUE;
+}
+
+// --------------------------------------------------------------------------
+//
+// Add all stars with a magnitude not larger than maxmag inside the cone
+// of the given radius [deg] around the direction dir to arr (which does
+// not own them). Inside the cells of the sky index (see class description)
+// the stars are ordered by magnitude. Returns the number of stars added.
+//
+Int_t MAstroCatalog::FindStars(TObjArray &arr, const TVector3 &dir, Double_t radius, Double_t maxmag)
+{
+    if (!fIndexValid || fIndexStars.GetEntriesFast()!=fList.GetEntries())
+        BuildIndex();
+
+    if (dir.Mag2()==0)
+        return 0;
+
+    const TVector3 u = dir.Unit();
+
+    radius = TMath::Min(radius, 180.);
+
+    const Double_t cosr = TMath::Cos(radius*TMath::DegToRad());
+
+    const Double_t dec0 = 90 - u.Theta()*TMath::RadToDeg();
+    const Double_t ra0  = u.Phi()*TMath::RadToDeg();
+
+    // Declination bands overlapping with the cone
+    const Int_t b0 = TMath::Max(Int_t(TMath::Floor((dec0-radius+90)*kNumIndexBands/180)), 0);
+    const Int_t b1 = TMath::Min(Int_t(TMath::Floor((dec0+radius+90)*kNumIndexBands/180)), kNumIndexBands-1);
+
+    // Maximum extension of the cone in right ascension (if it doesn't
+    // include a pole)
+    const Bool_t   pole = TMath::Abs(dec0)+radius>=90;
+    const Double_t dra  = pole ? 180 :
+        TMath::ASin(TMath::Sin(radius*TMath::DegToRad())/TMath::Cos(dec0*TMath::DegToRad()))*TMath::RadToDeg();
+
+    const Int_t n0 = arr.GetEntriesFast();
+
+    for (Int_t b=b0; b<=b1; b++)
+    {
+        const Int_t first = fIndexBand[b];
+        const Int_t n     = fIndexBand[b+1]-first;
+
+        // Cells of this band overlapping with the cone
+        Int_t c0 = 0;
+        Int_t nc = n;
+        if (2*dra<360)
+        {
+            c0 = TMath::FloorNint((ra0-dra)*n/360);
+            nc = TMath::Min(TMath::FloorNint((ra0+dra)*n/360)-c0+1, n);
+        }
+
+        for (Int_t j=0; j<nc; j++)
+        {
+            const Int_t c = first + ((c0+j)%n+n)%n;
+
+            for (Int_t k=fIndexCell[c]; k<fIndexCell[c+1]; k++)
+            {
+                if (fIndexMag[k]>maxmag)
+                    break;
+
+                const Double_t *d = fIndexDir.GetArray()+3*k;
+                if (d[0]*u.X()+d[1]*u.Y()+d[2]*u.Z()<cosr)
+                    continue;
+
+                arr.Add(fIndexStars.UncheckedAt(k));
+            }
+        }
+    }
+
+    return arr.GetEntriesFast()-n0;
+}
+
 // --------------------------------------------------------------------------
 //
 // Get the visibility curve (altitude vs time) for the current time
@@ -957,6 +1157,31 @@ Int_t MAstroCatalog::ConvertToPad(const TVector3 &w0, TVector2 &v) const
            v.X()<gPad->GetX2() && v.Y()<gPad->GetY2();
 }
 
+// --------------------------------------------------------------------------
+//
+// Return the radius [deg] of the cone around the pointing position which
+// contains all directions which ConvertToPad can accept: the pad
+// coordinates are the sine (tangent for a plain screen) of the distance
+// to the pointing position [deg].
+//
+Double_t MAstroCatalog::GetRadiusVisible() const
+{
+    Double_t r = fRadiusFOV;
+    if (!TestBit(kDrawingImage) && gPad)
+    {
+        const Double_t x = TMath::Max(TMath::Abs(gPad->GetX1()), TMath::Abs(gPad->GetX2()));
+        const Double_t y = TMath::Max(TMath::Abs(gPad->GetY1()), TMath::Abs(gPad->GetY2()));
+        r = TMath::Hypot(x, y);
+    }
+
+    const Double_t t = r*TMath::DegToRad();
+
+    if (TestBit(kPlainScreen))
+        return TMath::ATan(t)*TMath::RadToDeg();
+
+    return t>=1 ? 90 : TMath::ASin(t)*TMath::RadToDeg();
+}
+
 // --------------------------------------------------------------------------
 //
 // Convert theta/phi coordinates of v by TRotation into new coordinate
@@ -1298,13 +1523,16 @@ void MAstroCatalog::AddPrimitives(TString o)
 
     const TRotation rot(GetGrid(local));
 
-    TIter Next(&fList);
+    // Only stars inside this cone can be inside the drawing area. Without
+    // time and observatory the local view is not aligned with fRaDec
+    // (identity rotation), so the whole sky is searched.
+    TObjArray stars;
+    FindStars(stars, fRaDec, rot.IsIdentity() ? 180 : GetRadiusVisible(), fLimMag);
+
+    TIter Next(&stars);
     MVector3 *v=0;
     while ((v=(MVector3*)Next()))
     {
-        if (v->Magnitude()>fLimMag)
-            continue;
-
         TVector2 s(v->Phi(), v->Theta());
         if (Convert(rot, s)==kTRUE)
             DrawStar(s.X(), s.Y(), *v, yellow?kYellow:(white?kWhite:kBlack), 0, size);
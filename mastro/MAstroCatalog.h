@@ -7,6 +7,9 @@
 #ifndef ROOT_TList
 #include <TList.h>
 #endif
+#ifndef ROOT_TObjArray
+#include <TObjArray.h>
+#endif
 #ifndef ROOT_TAttLine
 #include <TAttLine.h>
 #endif
@@ -16,6 +19,12 @@
 #ifndef MARS_MGMap
 #include <MGMap.h>
 #endif
+#ifndef MARS_MArrayI
+#include "MArrayI.h"
+#endif
+#ifndef MARS_MArrayD
+#include "MArrayD.h"
+#endif
 
 class MTime;
 class MObservatory;
@@ -44,9 +53,23 @@ private:
     MAttLine fAttLineSky;   // Line Style and color for sky coordinates
     MAttLine fAttLineLocal; // Line Style and color for local coordinates
 
+    // Sky index of fList (see class description)
+    enum { kNumIndexBands = 180 };
+
+    Bool_t    fIndexValid;  //! Sky index is up-to-date
+    MArrayI   fIndexBand;   //! First cell of each declination band
+    MArrayI   fIndexCell;   //! First star of each cell
+    TObjArray fIndexStars;  //! Stars sorted by cell and magnitude (not owner)
+    MArrayD   fIndexDir;    //! Unit vectors of the stars (x,y,z)
+    MArrayD   fIndexMag;    //! Magnitudes of the stars
+
     void ShowToolTip(Int_t px, Int_t py, const char *txt);
     void SetLineAttributes(MAttLine &att);
 
+    Int_t GetNumIndexCells(Int_t band) const;
+    Int_t GetIndexCell(const TVector3 &v) const;
+    void  BuildIndex();
+
     TString FindToken(TString &line, Char_t tok=',');
 
     Int_t   atoi(const TString &s);
@@ -58,6 +81,7 @@ private:
 //#endif
 
     virtual Int_t ConvertToPad(const TVector3 &w, TVector2 &v) const;
+    Double_t      GetRadiusVisible() const;
     virtual void  AddPrimitives(TString o);
     virtual void  SetRangePad(Option_t *o);
 
@@ -153,10 +177,13 @@ public:
     TObject *FindObject(const TObject *obj) const { return fList.FindObject(obj); }
     void MarkObject(const char *name) const { TObject *o=FindObject(name); if (o) o->SetBit(kMark); }
 
+    Int_t FindStars(TObjArray &arr, const TVector3 &dir, Double_t radius, Double_t maxmag=99);
+    void  ResetIndex();
+
     void GetVisibilityCurve(TGraph &g, const char *name=0) const;
 
     // TObject
-    void Delete(Option_t * = "") { fList.Delete(); fMapG.Delete(); } // Delete list of stars
+    void Delete(Option_t * = "") { ResetIndex(); fList.Delete(); fMapG.Delete(); } // Delete list of stars
     void Print(Option_t * = "") const { fList.Print(); } // Print all stars
     void Draw(Option_t * = "");
     void SetDrawOption(Option_t *option="")
@@ -24,9 +24,11 @@
 // Basic Tools
 #pragma link C++ namespace MARS;
 #pragma link C++ namespace MMath;
+#pragma link C++ namespace MParse;
 #pragma link C++ namespace UTF8;
 
 #pragma link C++ class MSpline3+;
+#pragma link C++ class MRandomPhilox+;
 #pragma link C++ class MQuaternion+;
 #pragma link C++ class MReflection+;
 
@@ -34,6 +36,7 @@
 #pragma link C++ class MEnv+;
 #pragma link C++ class MIter+;
 #pragma link C++ class MDirIter+;
+#pragma link C++ class MDirIndex+;
 //#pragma link C++ class MRunIter+;
 #pragma link C++ class MThread+;
 
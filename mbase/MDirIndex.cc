@@ -0,0 +1,295 @@
+/* ======================================================================== *\
+!
+! *
+! * This file is part of MARS, the MAGIC Analysis and Reconstruction
+! * Software. It is distributed to you in the hope that it can be a useful
+! * and timesaving tool in analysing Data of imaging Cerenkov telescopes.
+! * It is distributed WITHOUT ANY WARRANTY.
+! *
+! * Permission to use, copy, modify and distribute this software and its
+! * documentation for any purpose is hereby granted without fee,
+! * provided that the above copyright notice appear in all copies and
+! * that both that copyright notice and this permission notice appear
+! * in supporting documentation. It is provided "as is" without express
+! * or implied warranty.
+! *
+!
+!
+!   Copyright: MAGIC Software Development, 2000-2026
+!
+!
+\* ======================================================================== */
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+//  MDirIndex
+//
+// An index of directory listings used by MDirIter (and hence by
+// MSequence, MDataSet and MRunIter) instead of reading the directories
+// again and again.
+//
+// For each directory the names of all entries are stored together with
+// the modification time of the directory. Whenever a listing is
+// requested the modification time of the directory is checked (a single
+// stat). Only if the directory has changed (entries were added or
+// removed) it is read again. Listings taken within the same second as
+// the last modification are not trusted.
+//
+// The index can be stored in a file and read again, so that subsequent
+// programs don't have to read the directories of the data archive at all.
+//
+// To use an index with MDirIter do:
+//
+//   MDirIndex index("dirindex.txt");  // Read index if file exists
+//   MDirIter::SetIndex(&index);
+//
+//   [...]
+//
+//   MDirIter::SetIndex();
+//
+// When the index is deleted and it has changed it is written back to
+// its file, if a file name was given.
+//
+/////////////////////////////////////////////////////////////////////////////
+#include "MDirIndex.h"
+
+#include <time.h>
+#include <stdio.h>
+#include <errno.h>
+#include <fstream>
+
+#include <TNamed.h>
+#include <TSystem.h>
+#include <TObjArray.h>
+#include <TObjString.h>
+
+#include "MLog.h"
+#include "MLogManip.h"
+
+#include "MDirIter.h"
+
+ClassImp(MDirIndex);
+
+using namespace std;
+
+// --------------------------------------------------------------------------
+//
+// The listing of a single directory. The name is the directory.
+//
+class MDirIndexEntry : public TNamed
+{
+private:
+    Long_t    fModTime;   // Modification time of the directory
+    Long_t    fListTime;  // Time at which the listing was taken
+    TObjArray fEntries;   // Names of the entries (TObjString)
+
+public:
+    MDirIndexEntry(const char *dir, Long_t modtime, Long_t listtime)
+        : TNamed(dir, ""), fModTime(modtime), fListTime(listtime)
+    {
+        fEntries.SetOwner();
+    }
+
+    void Add(const char *name) { fEntries.Add(new TObjString(name)); }
+
+    Long_t GetModTime() const  { return fModTime; }
+    Long_t GetListTime() const { return fListTime; }
+
+    const TObjArray &GetEntries() const { return fEntries; }
+
+    // Up-to-date if the directory wasn't modified after the listing
+    Bool_t IsValid(Long_t modtime) const { return modtime==fModTime && fModTime<fListTime; }
+};
+
+// --------------------------------------------------------------------------
+//
+// Default constructor. If a file name is given and the file exists the
+// index is read from the file.
+//
+MDirIndex::MDirIndex(const char *fname) : fChanged(kFALSE)
+{
+    fDirs.SetOwner();
+    fOld.SetOwner();
+
+    if (!fname)
+        return;
+
+    fFileName = fname;
+    gSystem->ExpandPathName(fFileName);
+
+    if (!gSystem->AccessPathName(fFileName, kFileExists))
+        ReadFile(fFileName);
+}
+
+// --------------------------------------------------------------------------
+//
+// Write the index back to its file if it has changed.
+//
+MDirIndex::~MDirIndex()
+{
+    if (MDirIter::GetIndex()==this)
+        MDirIter::SetIndex();
+
+    if (fChanged && !fFileName.IsNull())
+        WriteFile(fFileName);
+}
+
+// --------------------------------------------------------------------------
+//
+// Return the listing (TObjString) of the directory dir. If it is not
+// yet in the index or the directory has changed, the directory is read.
+// Returns NULL if the directory cannot be accessed or opened.
+//
+// Listings which are replaced are kept until the index is deleted, so
+// that iterators which still use them stay valid.
+//
+const TObjArray *MDirIndex::GetListing(const char *dir)
+{
+    Long_t id, size, flags, modtime;
+    if (gSystem->GetPathInfo(dir, &id, &size, &flags, &modtime))
+        return NULL;
+
+    MDirIndexEntry *entry = static_cast<MDirIndexEntry*>(fDirs.FindObject(dir));
+    if (entry && entry->IsValid(modtime))
+        return &entry->GetEntries();
+
+    void *ptr = gSystem->OpenDirectory(dir);
+    if (!ptr)
+        return NULL;
+
+    if (entry)
+    {
+        fDirs.Remove(entry);
+        fOld.Add(entry);
+    }
+
+    entry = new MDirIndexEntry(dir, modtime, time(NULL));
+
+    const char *name = 0;
+    while ((name=gSystem->GetDirEntry(ptr)))
+        entry->Add(name);
+
+    gSystem->FreeDirectory(ptr);
+
+    fDirs.Add(entry);
+    fChanged = kTRUE;
+
+    return &entry->GetEntries();
+}
+
+// --------------------------------------------------------------------------
+//
+// Read the index from a file. The listings are added to the existing
+// ones. The format is:
+//
+//   D modtime listtime n directory
+//   entry-1
+//   [...]
+//   entry-n
+//
+Bool_t MDirIndex::ReadFile(const char *fname)
+{
+    ifstream fin(fname);
+    if (!fin)
+    {
+        gLog << err << "Cannot open file " << fname << ": ";
+        gLog << strerror(errno) << endl;
+        return kFALSE;
+    }
+
+    Int_t num = 0;
+
+    TString line;
+    while (1)
+    {
+        line.ReadLine(fin);
+        if (!fin)
+            break;
+
+        if (line.IsNull() || line[0]=='#')
+            continue;
+
+        Long_t modtime, listtime;
+        Int_t  n, len;
+        if (sscanf(line.Data(), "D %ld %ld %d %n", &modtime, &listtime, &n, &len)!=3 || n<0)
+        {
+            gLog << err << "ERROR - Invalid line in " << fname << ": " << line << endl;
+            return kFALSE;
+        }
+
+        MDirIndexEntry *entry = new MDirIndexEntry(line.Data()+len, modtime, listtime);
+        for (Int_t i=0; i<n; i++)
+        {
+            line.ReadLine(fin);
+            entry->Add(line);
+        }
+
+        if (!fin)
+        {
+            delete entry;
+            gLog << err << "ERROR - Unexpected end of file " << fname << endl;
+            return kFALSE;
+        }
+
+        TObject *old = fDirs.FindObject(entry->GetName());
+        if (old)
+        {
+            fDirs.Remove(old);
+            fOld.Add(old);
+        }
+
+        fDirs.Add(entry);
+        num++;
+    }
+
+    gLog << inf << "Read " << num << " directory listings from " << fname << endl;
+
+    return kTRUE;
+}
+
+// --------------------------------------------------------------------------
+//
+// Write the index to a file (see ReadFile for the format). If no file
+// name is given the file name of the index is used.
+//
+Bool_t MDirIndex::WriteFile(const char *fname)
+{
+    if (!fname)
+        fname = fFileName;
+
+    ofstream fout(fname);
+    if (!fout)
+    {
+        gLog << err << "Cannot open file " << fname << ": ";
+        gLog << strerror(errno) << endl;
+        return kFALSE;
+    }
+
+    fout << "# MDirIndex" << endl;
+
+    TIter Next(&fDirs);
+    MDirIndexEntry *entry = 0;
+    while ((entry=static_cast<MDirIndexEntry*>(Next())))
+    {
+        const TObjArray &arr = entry->GetEntries();
+
+        fout << "D " << entry->GetModTime() << " " << entry->GetListTime() << " ";
+        fout << arr.GetEntriesFast() << " " << entry->GetName() << endl;
+
+        for (Int_t i=0; i<arr.GetEntriesFast(); i++)
+            fout << arr.UncheckedAt(i)->GetName() << endl;
+    }
+
+    if (!fout)
+    {
+        gLog << err << "ERROR - Writing " << fname << " failed." << endl;
+        return kFALSE;
+    }
+
+    fChanged = kFALSE;
+
+    gLog << inf << "Wrote " << fDirs.GetSize() << " directory listings to " << fname << endl;
+
+    return kTRUE;
+}
@@ -0,0 +1,33 @@
+#ifndef MARS_MDirIndex
+#define MARS_MDirIndex
+
+#ifndef ROOT_THashList
+#include <THashList.h>
+#endif
+
+class TObjArray;
+
+class MDirIndex : public TObject
+{
+private:
+    TString   fFileName; // File to store the index
+    THashList fDirs;     // Listings of the directories
+    TList     fOld;      // Replaced listings (kept for running iterators)
+    Bool_t    fChanged;  // Index has changed since it was read or written
+
+public:
+    MDirIndex(const char *fname=0);
+    ~MDirIndex();
+
+    const TObjArray *GetListing(const char *dir);
+
+    Bool_t ReadFile(const char *fname);
+    Bool_t WriteFile(const char *fname=0);
+
+    Bool_t HasChanged() const { return fChanged; }
+    UInt_t GetNumDirs() const { return fDirs.GetSize(); }
+
+    ClassDef(MDirIndex, 0) // Index of directory listings for MDirIter
+};
+
+#endif
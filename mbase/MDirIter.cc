@@ -59,6 +59,10 @@
 //          result may depend on the current working directory! Better use
 //          absolute paths.
 //
+// If an index of directory listings is set by SetIndex (see MDirIndex)
+// the directories are not read, but their listings are taken from the
+// index.
+//
 /////////////////////////////////////////////////////////////////////////////
 #include "MDirIter.h"
 
@@ -74,10 +78,14 @@
 #include "MLog.h"
 #include "MLogManip.h"
 
+#include "MDirIndex.h"
+
 ClassImp(MDirIter);
 
 using namespace std;
 
+MDirIndex *MDirIter::fgIndex = 0;
+
 // --------------------------------------------------------------------------
 //
 //  Add a directory, eg dir="../data"
@@ -230,8 +238,19 @@ void *MDirIter::Open()
     // Get Next entry of list
     fCurrentPath=fNext();
 
+    if (!fCurrentPath)
+        return NULL;
+
+    // Take the listing from the index if available
+    if (fgIndex)
+    {
+        fListing = fgIndex->GetListing(fCurrentPath->GetName());
+        fEntry   = 0;
+        return (void*)fListing;
+    }
+
     // Open directory if new entry was found
-    return fCurrentPath ? gSystem->OpenDirectory(fCurrentPath->GetName()) : NULL;
+    return gSystem->OpenDirectory(fCurrentPath->GetName());
 }
 
 // --------------------------------------------------------------------------
@@ -240,9 +259,22 @@ void *MDirIter::Open()
 //
 void MDirIter::Close()
 {
-    if (fDirPtr)
+    if (fDirPtr && !fListing)
         gSystem->FreeDirectory(fDirPtr);
-    fDirPtr = NULL;
+    fDirPtr  = NULL;
+    fListing = NULL;
+}
+
+// --------------------------------------------------------------------------
+//
+//  Return the next entry of the current directory or NULL
+//
+const char *MDirIter::GetDirEntry()
+{
+    if (!fListing)
+        return gSystem->GetDirEntry(fDirPtr);
+
+    return fEntry<fListing->GetEntriesFast() ? fListing->UncheckedAt(fEntry++)->GetName() : NULL;
 }
 
 // --------------------------------------------------------------------------
@@ -288,6 +320,17 @@ Bool_t MDirIter::MatchFilter(const TString &n, TString f) const
         return !n(regex).IsNull();
     }
 
+    // Names which don't begin with the literal part of the filter can't
+    // match. This avoids the regular expression for most entries.
+    // (A ? makes the preceding character optional)
+    Ssiz_t p = f.First("*?[\\^$");
+    if (p<0)
+        return n==f;
+    if (p>0 && f[p]=='?')
+        p--;
+    if (n.Length()<p || strncmp(n.Data(), f.Data(), p))
+        return kFALSE;
+
     f.Prepend("^");
     f.ReplaceAll(".", "\\.");
     f.ReplaceAll("+", "\\+");
@@ -379,7 +422,7 @@ TString MDirIter::Next(Bool_t nocheck)
             break;
 
         // Get next entry in dir, if existing check validity
-        const char *n = gSystem->GetDirEntry(fDirPtr);
+        const char *n = GetDirEntry();
         if (!n)
         {
             // Otherwise close directory and try to get next entry
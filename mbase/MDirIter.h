@@ -5,9 +5,13 @@
 #include <TObjArray.h>
 #endif
 
+class MDirIndex;
+
 class MDirIter : public TObject
 {
 private:
+    static MDirIndex *fgIndex; //! Index of directory listings (if any)
+
     TObjArray fList;
     TString   fFilter;
 
@@ -15,8 +19,12 @@ private:
     void     *fDirPtr;      //!
     TObject  *fCurrentPath; //!
 
+    const TObjArray *fListing; //! Listing of the current directory from the index
+    Int_t            fEntry;   //! Next entry of fListing
+
     void   *Open();
     void    Close();
+    const char *GetDirEntry();
     Bool_t  CheckEntry(const TString n) const;
     Int_t   IsDir(const char *dir) const;
     Bool_t  MatchFilter(const TString &name, TString filter) const;
@@ -24,11 +32,11 @@ private:
     void    PrintEntry(const TObject &o) const;
 
 public:
-    MDirIter() : fNext(&fList), fDirPtr(NULL)
+    MDirIter() : fNext(&fList), fDirPtr(NULL), fListing(NULL), fEntry(0)
     {
         fList.SetOwner();
     }
-    MDirIter(const MDirIter &dir) : TObject(), fNext(&fList), fDirPtr(NULL)
+    MDirIter(const MDirIter &dir) : TObject(), fNext(&fList), fDirPtr(NULL), fListing(NULL), fEntry(0)
     {
         fList.SetOwner();
 
@@ -37,7 +45,7 @@ public:
         while ((o=NextD()))
             AddDirectory(o->GetName(), o->GetTitle());
     }
-    MDirIter(const char *dir, const char *filter="", Int_t rec=0) : fNext(&fList), fDirPtr(NULL)
+    MDirIter(const char *dir, const char *filter="", Int_t rec=0) : fNext(&fList), fDirPtr(NULL), fListing(NULL), fEntry(0)
     {
         fList.SetOwner();
         AddDirectory(dir, filter, rec);
@@ -69,6 +77,9 @@ public:
 
     void Print(const Option_t *o="") const;
 
+    static void       SetIndex(MDirIndex *index=0) { fgIndex = index; }
+    static MDirIndex *GetIndex() { return fgIndex; }
+
     ClassDef(MDirIter, 1) // Iterator for files in several directories (with filters)
 };
 
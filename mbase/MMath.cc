@@ -900,13 +900,15 @@ void MMath::Format(Double_t &v, Double_t &e)
     e = error.Atof();
 }
 
-Double_t MMath::RndmExp(Double_t tau)
+Double_t MMath::RndmExp(Double_t tau, TRandom *rnd)
 {
     // returns an exponential deviate.
     //
     //          exp( -t/tau )
+    //
+    // If no generator is given gRandom is used.
 
-    const Double_t x = gRandom->Rndm(); // uniform on ] 0, 1 ]
+    const Double_t x = (rnd ? rnd : gRandom)->Rndm(); // uniform on ] 0, 1 ]
 
     return -tau * TMath::Log(x);       // convert to exponential distribution
 }
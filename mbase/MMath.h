@@ -12,6 +12,7 @@
 class TVector2;
 class TVector3;
 class TArrayD;
+class TRandom;
 
 namespace MMath
 {
@@ -89,7 +90,7 @@ namespace MMath
 
     void Format(Double_t &v, Double_t &e);
 
-    Double_t RndmExp(Double_t tau);
+    Double_t RndmExp(Double_t tau, TRandom *rnd=0);
 }
 
 #endif
@@ -103,6 +103,7 @@ const
 
     virtual MParContainer *New() const;
     virtual void   SetLogStream(MLog *lg) { fLog = lg; }
+    MLog          *GetLogStream() const   { return fLog; }
     virtual void   Reset();
     virtual Bool_t IsReadyToSave() const             { return fReadyToSave; }
     virtual void   SetReadyToSave(Bool_t flag=kTRUE) { fReadyToSave=flag; }
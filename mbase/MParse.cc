@@ -0,0 +1,198 @@
+/* ======================================================================== *\
+!
+! *
+! * This file is part of MARS, the MAGIC Analysis and Reconstruction
+! * Software. It is distributed to you in the hope that it can be a useful
+! * and timesaving tool in analysing Data of imaging Cerenkov telescopes.
+! * It is distributed WITHOUT ANY WARRANTY.
+! *
+! * Permission to use, copy, modify and distribute this software and its
+! * documentation for any purpose is hereby granted without fee,
+! * provided that the above copyright notice appear in all copies and
+! * that both that copyright notice and this permission notice appear
+! * in supporting documentation. It is provided "as is" without express
+! * or implied warranty.
+! *
+!
+!
+!   Copyright: MAGIC Software Development, 2000-2026
+!
+!
+\* ======================================================================== */
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// MParse
+//
+// Fast tokenizer for numbers in plain text lines (eg. the lines of the
+// central control report files), which works on the character buffer
+// directly without copying it into TStrings and without sscanf.
+//
+// All Read-functions take a reference to the current position. Leading
+// blanks are skipped, the number is converted and, like the format
+// " %d %n" of sscanf, the trailing blanks are skipped, too. Only in case
+// of success the position is advanced, otherwise it is left untouched.
+//
+//   const char *pos = str.Data();
+//
+//   Int_t   i;
+//   Float_t f;
+//   if (!MParse::ReadInt(pos, i) || !MParse::ReadFloat(pos, f))
+//       return kCONTINUE;
+//
+//   str.Remove(0, pos-str.Data());
+//
+// Integers are accepted in decimal notation with an optional sign.
+// Floating point numbers are converted with strtod/strtof and hence
+// accept the same notations as sscanf.
+//
+// ReadHex converts a fixed-width field of hexadecimal digits as used in
+// the DC-, HV- and IPR-sections of the reports.
+//
+/////////////////////////////////////////////////////////////////////////////
+#include "MParse.h"
+
+#include <stdlib.h> // strtod, strtof
+
+// --------------------------------------------------------------------------
+//
+// Convert a decimal integer with optional sign. Returns kFALSE if no
+// digit was found.
+//
+template<class T>
+static Bool_t ReadInteger(const char *&pos, T &val)
+{
+    const char *p = MParse::SkipBlanks(pos);
+
+    const Bool_t neg = *p=='-';
+    if (*p=='-' || *p=='+')
+        p++;
+
+    if (*p<'0' || *p>'9')
+        return kFALSE;
+
+    Long64_t v = 0;
+    while (*p>='0' && *p<='9')
+        v = v*10 + (*p++ - '0');
+
+    val = neg ? -v : v;
+    pos = MParse::SkipBlanks(p);
+
+    return kTRUE;
+}
+
+// --------------------------------------------------------------------------
+//
+// Read a decimal integer, see class description
+//
+Bool_t MParse::ReadShort(const char *&pos, Short_t &val)
+{
+    return ReadInteger(pos, val);
+}
+
+// --------------------------------------------------------------------------
+//
+// Read a decimal integer, see class description
+//
+Bool_t MParse::ReadInt(const char *&pos, Int_t &val)
+{
+    return ReadInteger(pos, val);
+}
+
+// --------------------------------------------------------------------------
+//
+// Read a decimal integer, see class description
+//
+Bool_t MParse::ReadLong(const char *&pos, Long_t &val)
+{
+    return ReadInteger(pos, val);
+}
+
+// --------------------------------------------------------------------------
+//
+// Read a floating point number, see class description
+//
+Bool_t MParse::ReadDouble(const char *&pos, Double_t &val)
+{
+    const char *p = SkipBlanks(pos);
+
+    char *end = 0;
+    const Double_t v = strtod(p, &end);
+    if (end==p)
+        return kFALSE;
+
+    val = v;
+    pos = SkipBlanks(end);
+
+    return kTRUE;
+}
+
+// --------------------------------------------------------------------------
+//
+// Read a floating point number, see class description
+//
+Bool_t MParse::ReadFloat(const char *&pos, Float_t &val)
+{
+    const char *p = SkipBlanks(pos);
+
+    char *end = 0;
+    const Float_t v = strtof(p, &end);
+    if (end==p)
+        return kFALSE;
+
+    val = v;
+    pos = SkipBlanks(end);
+
+    return kTRUE;
+}
+
+// --------------------------------------------------------------------------
+//
+// Convert the field of n characters starting at pos into an unsigned
+// integer. As for sscanf with a format like "%4x" leading blanks are
+// skipped and the conversion stops at the first character which is not
+// a hexadecimal digit. Returns kFALSE if no digit was found or the string
+// ends inside the field. The position is not changed.
+//
+Bool_t MParse::ReadHex(const char *pos, Int_t n, UInt_t &val)
+{
+    const char *end = pos+n;
+
+    while (pos<end && IsBlank(*pos))
+        pos++;
+
+    UInt_t v = 0;
+
+    const char *beg = pos;
+    while (pos<end)
+    {
+        const char c = *pos;
+
+        UInt_t d;
+        if (c>='0' && c<='9')
+            d = c-'0';
+        else
+            if (c>='a' && c<='f')
+                d = c-'a'+10;
+            else
+                if (c>='A' && c<='F')
+                    d = c-'A'+10;
+                else
+                    break;
+
+        v = (v<<4) | d;
+        pos++;
+    }
+
+    if (pos==beg)
+        return kFALSE;
+
+    // The string must not end inside the field
+    while (pos<end)
+        if (*pos++==0)
+            return kFALSE;
+
+    val = v;
+    return kTRUE;
+}
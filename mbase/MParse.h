@@ -0,0 +1,22 @@
+#ifndef MARS_MParse
+#define MARS_MParse
+
+#ifndef ROOT_Rtypes
+#include <Rtypes.h>
+#endif
+
+namespace MParse
+{
+    inline Bool_t IsBlank(char c) { return c==' ' || (c>='\t' && c<='\r'); }
+    inline const char *SkipBlanks(const char *pos) { while (IsBlank(*pos)) pos++; return pos; }
+
+    Bool_t ReadShort(const char *&pos, Short_t &val);
+    Bool_t ReadInt(const char *&pos, Int_t &val);
+    Bool_t ReadLong(const char *&pos, Long_t &val);
+    Bool_t ReadDouble(const char *&pos, Double_t &val);
+    Bool_t ReadFloat(const char *&pos, Float_t &val);
+
+    Bool_t ReadHex(const char *pos, Int_t n, UInt_t &val);
+}
+
+#endif
@@ -0,0 +1,235 @@
+/* ======================================================================== *\
+!
+! *
+! * This file is part of MARS, the MAGIC Analysis and Reconstruction
+! * Software. It is distributed to you in the hope that it can be a useful
+! * and timesaving tool in analysing Data of imaging Cerenkov telescopes.
+! * It is distributed WITHOUT ANY WARRANTY.
+! *
+! * Permission to use, copy, modify and distribute this software and its
+! * documentation for any purpose is hereby granted without fee,
+! * provided that the above copyright notice appear in all copies and
+! * that both that copyright notice and this permission notice appear
+! * in supporting documentation. It is provided "as is" without express
+! * or implied warranty.
+! *
+!
+!
+!   Copyright: MAGIC Software Development, 2000-2026
+!
+!
+\* ======================================================================== */
+
+
+//////////////////////////////////////////////////////////////////////////////
+//
+//  MRandomPhilox
+//
+//  Counter-based random number generator Philox4x32-10 (J. K. Salmon et
+//  al., "Parallel random numbers: as easy as 1, 2, 3", SC11). Each block
+//  of four 32-bit numbers is a bijective function of a 128-bit counter
+//  and a 64-bit key, so there is no state apart from the counter.
+//
+//  The key is made of the seed (TRandom::SetSeed) and a second word set
+//  with SetStream. The upper three words of the counter identify the
+//  stream (e.g. run, event and reuse number), the lowest word counts the
+//  blocks within the stream. Thus every stream can be reproduced
+//  independently of all others, in any order and in any thread, by
+//  calling SetStream with the same arguments.
+//
+//  Since it derives from TRandom all distributions of TRandom are
+//  available. Additionally, arrays of uniform, Gaussian, exponential and
+//  Poisson distributed numbers can be filled at once.
+//
+//  See also: MSimRandom
+//
+//////////////////////////////////////////////////////////////////////////////
+#include "MRandomPhilox.h"
+
+#include <TMath.h>
+
+ClassImp(MRandomPhilox);
+
+using namespace std;
+
+// --------------------------------------------------------------------------
+//
+// Default constructor. Initializes stream 0 with the given seed.
+//
+MRandomPhilox::MRandomPhilox(UInt_t seed) : TRandom(seed), fKey(0), fPos(4)
+{
+    fName  = "MRandomPhilox";
+    fTitle = "Counter-based random number generator (Philox4x32-10)";
+
+    fCounter[0] = fCounter[1] = fCounter[2] = fCounter[3] = 0;
+}
+
+// --------------------------------------------------------------------------
+//
+// Calculate one block (four 32-bit words) from the counter ctr and the
+// key (k0, k1) with ten rounds.
+//
+void MRandomPhilox::Philox(const UInt_t ctr[4], UInt_t k0, UInt_t k1, UInt_t out[4])
+{
+    UInt_t c0 = ctr[0];
+    UInt_t c1 = ctr[1];
+    UInt_t c2 = ctr[2];
+    UInt_t c3 = ctr[3];
+
+    for (Int_t i=0; i<10; i++)
+    {
+        const ULong64_t p0 = ULong64_t(0xD2511F53)*c0;
+        const ULong64_t p1 = ULong64_t(0xCD9E8D57)*c2;
+
+        const UInt_t hi0 = p0>>32;
+        const UInt_t hi1 = p1>>32;
+
+        c0 = hi1^c1^k0;
+        c1 = UInt_t(p1);
+        c2 = hi0^c3^k1;
+        c3 = UInt_t(p0);
+
+        k0 += 0x9E3779B9;
+        k1 += 0xBB67AE85;
+    }
+
+    out[0] = c0;
+    out[1] = c1;
+    out[2] = c2;
+    out[3] = c3;
+}
+
+// --------------------------------------------------------------------------
+//
+// Calculate the next block and increase the counter
+//
+void MRandomPhilox::Next()
+{
+    Philox(fCounter, fSeed, fKey, fBuffer);
+
+    fCounter[0]++;
+    fPos = 0;
+}
+
+// --------------------------------------------------------------------------
+//
+// Start the stream identified by the second key word key and the
+// counter words s0, s1, s2 from its beginning.
+//
+void MRandomPhilox::SetStream(UInt_t key, UInt_t s0, UInt_t s1, UInt_t s2)
+{
+    fKey = key;
+
+    fCounter[0] = 0;
+    fCounter[1] = s0;
+    fCounter[2] = s1;
+    fCounter[3] = s2;
+
+    fPos = 4;
+}
+
+// --------------------------------------------------------------------------
+//
+// Return a uniformly distributed number in ]0, 1[
+//
+Double_t MRandomPhilox::Rndm()
+{
+    return (NextWord()+0.5)*2.3283064365386963e-10; // 2^-32
+}
+
+// --------------------------------------------------------------------------
+//
+// Fill n uniformly distributed numbers in ]0, 1[ into x (24 bit)
+//
+void MRandomPhilox::RndmArray(Int_t n, Float_t *x)
+{
+    for (Int_t i=0; i<n; i++)
+        x[i] = ((NextWord()>>8)+0.5f)*5.9604645e-8f; // 2^-24
+}
+
+// --------------------------------------------------------------------------
+//
+// Fill n uniformly distributed numbers in ]0, 1[ into x
+//
+void MRandomPhilox::RndmArray(Int_t n, Double_t *x)
+{
+    for (Int_t i=0; i<n; i++)
+        x[i] = (NextWord()+0.5)*2.3283064365386963e-10; // 2^-32
+}
+
+// --------------------------------------------------------------------------
+//
+// Fill n uniformly distributed numbers in ]min, max[ into x
+//
+void MRandomPhilox::FillUniform(Int_t n, Float_t *x, Float_t min, Float_t max)
+{
+    RndmArray(n, x);
+
+    const Float_t w = max-min;
+    for (Int_t i=0; i<n; i++)
+        x[i] = min + w*x[i];
+}
+
+// --------------------------------------------------------------------------
+//
+// Fill n Gaussian distributed numbers with mean and sigma into x. The
+// numbers are calculated in pairs with the Box-Muller method.
+//
+void MRandomPhilox::FillGaus(Int_t n, Float_t *x, Float_t mean, Float_t sigma)
+{
+    for (Int_t i=0; i<n; i+=2)
+    {
+        const Double_t r   = sigma*TMath::Sqrt(-2*TMath::Log(Rndm()));
+        const Double_t phi = TMath::TwoPi()*Rndm();
+
+        x[i] = mean + r*TMath::Cos(phi);
+        if (i+1<n)
+            x[i+1] = mean + r*TMath::Sin(phi);
+    }
+}
+
+// --------------------------------------------------------------------------
+//
+// Fill n exponentially distributed numbers with decay constant tau into x
+//
+void MRandomPhilox::FillExp(Int_t n, Float_t *x, Float_t tau)
+{
+    for (Int_t i=0; i<n; i++)
+        x[i] = -tau*TMath::Log(Rndm());
+}
+
+// --------------------------------------------------------------------------
+//
+// Fill n Poisson distributed numbers with the given mean into x. For
+// means below 25 the numbers are calculated by multiplication of uniform
+// numbers, otherwise TRandom::Poisson is used.
+//
+void MRandomPhilox::FillPoisson(Int_t n, Int_t *x, Double_t mean)
+{
+    if (mean<=0)
+    {
+        for (Int_t i=0; i<n; i++)
+            x[i] = 0;
+        return;
+    }
+
+    if (mean>=25)
+    {
+        for (Int_t i=0; i<n; i++)
+            x[i] = Poisson(mean);
+        return;
+    }
+
+    const Double_t lim = TMath::Exp(-mean);
+    for (Int_t i=0; i<n; i++)
+    {
+        Int_t    k = 0;
+        Double_t p = Rndm();
+        while (p>lim)
+        {
+            p *= Rndm();
+            k++;
+        }
+        x[i] = k;
+    }
+}
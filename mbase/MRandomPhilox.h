@@ -0,0 +1,43 @@
+#ifndef MARS_MRandomPhilox
+#define MARS_MRandomPhilox
+
+#ifndef ROOT_TRandom
+#include <TRandom.h>
+#endif
+
+class MRandomPhilox : public TRandom
+{
+private:
+    UInt_t fCounter[4]; // Counter: [0] block within the stream, [1-3] stream
+    UInt_t fKey;        // Second word of the key (the first is the seed)
+
+    UInt_t fBuffer[4];  //! Output of the current block
+    UInt_t fPos;        //! Next unused word in fBuffer
+
+    void   Next();
+    UInt_t NextWord() { if (fPos>3) Next(); return fBuffer[fPos++]; }
+
+public:
+    MRandomPhilox(UInt_t seed=65539);
+
+    static void Philox(const UInt_t ctr[4], UInt_t k0, UInt_t k1, UInt_t out[4]);
+
+    void SetStream(UInt_t key, UInt_t s0=0, UInt_t s1=0, UInt_t s2=0);
+
+    // TRandom
+    Double_t Rndm();
+    Double_t Rndm(Int_t) { return Rndm(); }
+
+    void RndmArray(Int_t n, Float_t *x);
+    void RndmArray(Int_t n, Double_t *x);
+
+    // Bulk generation
+    void FillUniform(Int_t n, Float_t *x, Float_t min=0, Float_t max=1);
+    void FillGaus(Int_t n, Float_t *x, Float_t mean=0, Float_t sigma=1);
+    void FillExp(Int_t n, Float_t *x, Float_t tau=1);
+    void FillPoisson(Int_t n, Int_t *x, Double_t mean);
+
+    ClassDef(MRandomPhilox, 1) // Counter-based random number generator (Philox4x32-10)
+};
+
+#endif
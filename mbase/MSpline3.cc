@@ -237,54 +237,56 @@ Double_t MSpline3::IntegralSolidAngle() const
 }
 
 
-// FIXME: As soon as TSpline3 allows access to fPoly we can implement
-//        a much faster evaluation of the spline, especially in
-//        special conditions like in MAnalogSignal::AddPulse
-//        This will be the case for root > 5.22/00
+// --------------------------------------------------------------------------
+//
+// Return the index of the knot left of x starting the search from the
+// given index (cursor). The cursor is updated. If the values of x are
+// evaluated in ascending (or descending) order this takes amortized
+// constant time instead of the binary search of TSpline3::FindX.
+//
+// For x inside (fXmin, fXmax) the result is identical to the binary
+// search: the largest k with x(k)<x. Outside of this range the result
+// is 0 or fNp-1 respectively, as in TSpline3::FindX.
+//
+Int_t MSpline3::FindFast(Double_t x, Int_t &cursor) const
+{
+    if (x<=fXmin)
+        return 0;
+    if (x>=fXmax)
+        return fNp-1;
+
+    Int_t k = cursor<0 ? 0 : (cursor>fNp-2 ? fNp-2 : cursor);
+
+    while (k<fNp-2 && x>fPoly[k+1].X())
+        k++;
+    while (k>0 && x<=fPoly[k].X())
+        k--;
+
+    cursor = k;
+    return k;
+}
 
-/*
-Double_t MSpline3::EvalFast(Double_t x) const
+// --------------------------------------------------------------------------
+//
+// Evaluate the spline at x using FindFast to find the knot. The result
+// is identical to TSpline3::Eval, which is used for equidistant knots
+// and outside of the range [fXmin, fXmax].
+//
+Double_t MSpline3::EvalFast(Double_t x, Int_t &cursor) const
 {
-    // Eval this spline at x
-    const Int_t klow=FindFast(x);
-    return fPoly[klow].Eval(x);
+    if (fKstep || x<=fXmin || x>=fXmax)
+        return Eval(x);
+
+    return fPoly[FindFast(x, cursor)].Eval(x);
 }
 
-Int_t MSpline3::FindFast(Double_t x) const
+// --------------------------------------------------------------------------
+//
+// Evaluate the spline at the n values x and store the result in y.
+// Ordering x ascending gives best performance.
+//
+void MSpline3::EvalFast(Int_t n, const Double_t *x, Double_t *y, Int_t &cursor) const
 {
-    //
-    // If out of boundaries, extrapolate
-    // It may be badly wrong
-
-    // if (x<=fXmin)
-    //     return 0;
-    //
-    // if (x>=fXmax)
-    //     return fNp-1;
-
-    //
-    // Equidistant knots, use histogramming
-    if (fKstep)
-        return TMath::Min(Int_t((x-fXmin)/fDelta),fNp-1);
-
-    //
-    // Non equidistant knots, binary search
-    Int_t klow = 0;
-    Int_t khig = fNp-1;
-
-    Int_t khalf;
-    while (khig-klow>1)
-        if(x>fPoly[khalf=(klow+khig)/2].X())
-            klow=khalf;
-        else
-            khig=khalf;
-
-    // This could be removed, sanity check
-    //if(!(fPoly[klow].X()<=x && x<=fPoly[klow+1].X()))
-    //    Error("Eval",
-    //          "Binary search failed x(%d) = %f < %f < x(%d) = %f\n",
-    //          klow,fPoly[klow].X(),x,fPoly[klow+1].X());
-
-    return klow;
+    for (Int_t i=0; i<n; i++)
+        y[i] = EvalFast(x[i], cursor);
 }
-*/
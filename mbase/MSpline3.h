@@ -63,6 +63,11 @@ public:
 
     Double_t IntegralSolidAngle() const;
 
+    // Evaluation with a cursor for (mainly) ordered access
+    Int_t    FindFast(Double_t x, Int_t &cursor) const;
+    Double_t EvalFast(Double_t x, Int_t &cursor) const;
+    void     EvalFast(Int_t n, const Double_t *x, Double_t *y, Int_t &cursor) const;
+
     ClassDef(MSpline3, 1) // An extension of the TSpline3
 };
 
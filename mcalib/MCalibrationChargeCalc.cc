@@ -201,17 +201,27 @@
 //  ClassVersion 6:
 //   -  Bool_t fContinousCalibration
 //
+//  ClassVersion 7:
+//   +  Int_t  fNumThreads
+//
 //////////////////////////////////////////////////////////////////////////////
 #include "MCalibrationChargeCalc.h"
 
+#include <thread>
+#include <vector>
+
 #include <TSystem.h>
 #include <TH1.h>
 #include <TF1.h>
+#include <TStopwatch.h>
 
 #include "MLog.h"
 #include "MLogManip.h"
+#include "MLogPlugin.h"
 
 #include "MMath.h"
+#include "MString.h"
+#include "MArrayB.h"
 
 #include "MParList.h"
 
@@ -247,6 +257,47 @@ ClassImp(MCalibrationChargeCalc);
 
 using namespace std;
 
+// --------------------------------------------------------------------------
+//
+// Log plugin storing the output of a MLog together with its output level,
+// so that it can be written to another log later with the same levels.
+// It is used to keep the output of the pixels while they are processed in
+// several threads (see FinalizePixels). If a target is set, the output is
+// stored in the target instead.
+//
+class MLogBuffer : public MLogPlugin
+{
+private:
+    Int_t       fLevel;  // Output level of the text written next
+    MLogBuffer *fTarget; // Buffer to which the output is redirected (0: this)
+
+    vector<pair<Int_t, TString>> fText; // Output level and text
+
+public:
+    MLogBuffer() : fLevel(0), fTarget(0) { }
+
+    void SetTarget(MLogBuffer *buf) { fTarget = buf; }
+
+    void SetColor(int level) { fLevel = level; }
+
+    void WriteBuffer(const char *str, int len)
+    {
+        vector<pair<Int_t, TString>> &txt = fTarget ? fTarget->fText : fText;
+
+        if (txt.empty() || txt.back().first!=fLevel)
+            txt.push_back(make_pair(fLevel, TString()));
+
+        txt.back().second.Append(str, len);
+    }
+
+    // Write the stored output to log with the original output levels
+    void WriteTo(MLog &log) const
+    {
+        for (auto it=fText.begin(); it!=fText.end(); it++)
+            log << debug(it->first) << it->second << flush;
+    }
+};
+
 const Float_t MCalibrationChargeCalc::fgChargeLimit            = 4.5;
 const Float_t MCalibrationChargeCalc::fgChargeErrLimit         = 0.;
 const Float_t MCalibrationChargeCalc::fgChargeRelErrLimit      = 1.;
@@ -293,6 +344,7 @@ const char *MCalibrationChargeCalc::fgNamePedestalCam = "MPedestalCam";
 // - IsUseExternalNumPhes to kFALSE
 // - fExternalNumPhes     to 0.
 // - fExternalNumPhesRelVar to 0.
+// - fNumThreads          to 0 (number of cores)
 //
 // Sets all checks
 //
@@ -301,7 +353,7 @@ const char *MCalibrationChargeCalc::fgNamePedestalCam = "MPedestalCam";
 //
 MCalibrationChargeCalc::MCalibrationChargeCalc(const char *name, const char *title)
     : fPulserColor(MCalibrationCam::kNONE), fContinousCalibration(kFALSE),
-    fGeom(NULL), fSignal(NULL), fCalibPattern(NULL), fExtractor(NULL)
+    fNumThreads(0), fGeom(NULL), fSignal(NULL), fCalibPattern(NULL), fExtractor(NULL)
 {
         
   fName  = name  ? name  : "MCalibrationChargeCalc";
@@ -777,7 +829,8 @@ void MCalibrationChargeCalc::FinalizeAbsTimes()
 //  - FinalizePedestals() 
 //  - FinalizeCharges()
 // for every entry. Count number of valid pixels in loop and return kFALSE
-// if there are none (the "Michele check").
+// if there are none (the "Michele check"). The loop over the pixels is
+// distributed over several threads (see FinalizePixels()).
 //
 // Call FinalizeBadPixels()
 //
@@ -797,6 +850,8 @@ void MCalibrationChargeCalc::FinalizeAbsTimes()
 //
 // Print out some statistics
 //
+// The time needed by each stage is written to the log (level inf2)
+//
 Int_t MCalibrationChargeCalc::Finalize()
 {
     // The number of used slices are just a mean value
@@ -817,26 +872,16 @@ Int_t MCalibrationChargeCalc::Finalize()
         fPINDiode = NULL;
       }
 
+  TStopwatch clock;
+
   //
   // First loop over pixels, call FinalizePedestals and FinalizeCharges
   //
-  Int_t nvalid = 0;
-  for (Int_t pixid=0; pixid<fPedestals->GetSize(); pixid++)
-  {
-      //
-      // Check if the pixel has been excluded from the fits
-      //
-      MCalibrationChargePix &pix = (MCalibrationChargePix&)(*fCam)[pixid];
-      if (pix.IsExcluded())
-          continue;
-
-      FinalizePedestals((*fPedestals)[pixid], pix, (*fGeom)[pixid].GetAidx());
-
-      if (FinalizeCharges(pix, (*fBadPixels)[pixid], "Pixel  "))
-          nvalid++;
-  }
+  const Int_t nvalid = FinalizePixels();
+  PrintTiming("Pedestals and charges", clock);
 
   FinalizeAbsTimes();
+  PrintTiming("Arrival times", clock);
 
   *fLog << endl;  
 
@@ -874,7 +919,7 @@ Int_t MCalibrationChargeCalc::Finalize()
       pix.SetPedRMS(pix.GetPedRms()*sqrtnum, pix.GetPedRmsErr()*sqrtnum);
       pix.SetSigma (pix.GetSigma()/pix.GetFFactorFADC2Phe());
 
-      FinalizeCharges(pix, fCam->GetAverageBadArea(aidx),"area id");
+      FinalizeCharges(pix, fCam->GetAverageBadArea(aidx),"area id", *fLog);
     }
   
   *fLog << endl;
@@ -890,15 +935,21 @@ Int_t MCalibrationChargeCalc::Finalize()
   
   *fLog << endl;
 
+  PrintTiming("Area and sector averages", clock);
+
   //
   // Finalize Bad Pixels
   // 
   FinalizeBadPixels();
+  PrintTiming("Bad pixels", clock);
 
   // 
   // Finalize F-Factor method
   //
-  if (FinalizeFFactorMethod())
+  const Bool_t ffactor = FinalizeFFactorMethod();
+  PrintTiming("F-Factor method", clock);
+
+  if (ffactor)
     fCam->SetFFactorMethodValid(kTRUE);
   else
     {
@@ -914,11 +965,13 @@ Int_t MCalibrationChargeCalc::Finalize()
   // Finalize Blind Pixel
   //
   fQECam->SetBlindPixelMethodValid(FinalizeBlindCam());
+  PrintTiming("Blind pixel", clock);
 
   // 
   // Finalize PIN Diode
   //
   fQECam->SetBlindPixelMethodValid(FinalizePINDiode());
+  PrintTiming("PIN diode", clock);
 
   //
   // Finalize QE Cam
@@ -927,6 +980,7 @@ Int_t MCalibrationChargeCalc::Finalize()
   FinalizeBlindPixelQECam();
   FinalizePINDiodeQECam();
   FinalizeCombinedQECam();
+  PrintTiming("Quantum efficiencies", clock);
 
   //
   // Re-direct the output to an ascii-file from now on:
@@ -992,6 +1046,141 @@ Int_t MCalibrationChargeCalc::Finalize()
   return FinalizeUnsuitablePixels();
 }
 
+// ----------------------------------------------------------------------------------
+//
+// Write the time elapsed since the last call (or the start of the clock)
+// to the log and restart the clock.
+//
+void MCalibrationChargeCalc::PrintTiming(const char *stage, TStopwatch &clock) const
+{
+  clock.Stop();
+  *fLog << inf2 << GetDescriptor() << ": " << stage << " finalized in "
+        << Form("%.3fs (CPU %.3fs)", clock.RealTime(), clock.CpuTime()) << endl;
+  clock.Start();
+}
+
+// ----------------------------------------------------------------------------------
+//
+// Call FinalizePedestals and FinalizeCharges for the pixels [first, last).
+//
+// This is the worker of FinalizePixels. The pixels are independent of
+// each other, thus it can run in several threads. Therefore, the
+// log-stream of the pixel containers and the messages of FinalizeCharges
+// are redirected to log (owned by the thread) while they are processed.
+// Its output is stored by the plugin buf in msg[idx]. Whether the pixel
+// has a valid calibration is stored in valid[idx].
+//
+void MCalibrationChargeCalc::FinalizePixelRange(Int_t first, Int_t last, MLog *log, MLogBuffer *buf, MLogBuffer *msg, Byte_t *valid)
+{
+  for (Int_t pixid=first; pixid<last; pixid++)
+  {
+      //
+      // Check if the pixel has been excluded from the fits
+      //
+      MCalibrationChargePix &pix = (MCalibrationChargePix&)(*fCam)[pixid];
+      if (pix.IsExcluded())
+          continue;
+
+      MLog *prev = pix.GetLogStream();
+
+      buf->SetTarget(&msg[pixid]);
+      pix.SetLogStream(log);
+
+      FinalizePedestals((*fPedestals)[pixid], pix, (*fGeom)[pixid].GetAidx());
+      valid[pixid] = FinalizeCharges(pix, (*fBadPixels)[pixid], "Pixel  ", *log);
+
+      *log << flush;
+
+      pix.SetLogStream(prev);
+      buf->SetTarget(0);
+  }
+}
+
+// ----------------------------------------------------------------------------------
+//
+// First loop over pixels: Call FinalizePedestals and FinalizeCharges.
+//
+// The pixels are distributed in contiguous blocks over fNumThreads threads
+// (<=0: number of cores). The messages of the pixel containers and of
+// FinalizeCharges are written to the log afterwards in the order of the
+// pixels, so that the output doesn't depend on the number of threads.
+// In debug mode everything is done in the main thread.
+//
+// Returns the number of pixels with a valid calibration.
+//
+Int_t MCalibrationChargeCalc::FinalizePixels()
+{
+  const Int_t npix = fPedestals->GetSize();
+
+  Int_t nthreads = IsDebug() ? 1 : fNumThreads;
+  if (nthreads<=0)
+    nthreads = thread::hardware_concurrency();
+  if (nthreads>npix)
+    nthreads = npix;
+
+  if (nthreads<=1)
+  {
+      Int_t nvalid = 0;
+      for (Int_t pixid=0; pixid<npix; pixid++)
+      {
+          MCalibrationChargePix &pix = (MCalibrationChargePix&)(*fCam)[pixid];
+          if (pix.IsExcluded())
+              continue;
+
+          FinalizePedestals((*fPedestals)[pixid], pix, (*fGeom)[pixid].GetAidx());
+
+          if (FinalizeCharges(pix, (*fBadPixels)[pixid], "Pixel  ", *fLog))
+              nvalid++;
+      }
+      return nvalid;
+  }
+
+  MLogBuffer *msg = new MLogBuffer[npix];
+  MArrayB valid(npix);
+
+  // MLog registers itself in gROOT, thus the streams are created here.
+  // They don't write to any device, their output is collected by the
+  // plugins and written to fLog in the order of the pixels.
+  MLog       *logs = new MLog[nthreads];
+  MLogBuffer *bufs = new MLogBuffer[nthreads];
+
+  const Int_t step = (npix+nthreads-1)/nthreads;
+
+  vector<thread> threads;
+  for (Int_t first=0; first<npix; first+=step)
+  {
+      MLog       *log = logs + threads.size();
+      MLogBuffer *buf = bufs + threads.size();
+
+      log->SetOutputDevice(0);
+      log->SetDebugLevel(fLog->GetDebugLevel());
+      log->AddPlugin(buf);
+
+      threads.push_back(thread(&MCalibrationChargeCalc::FinalizePixelRange, this,
+                               first, TMath::Min(first+step, npix), log, buf,
+                               msg, valid.GetArray()));
+  }
+
+  for (auto it=threads.begin(); it!=threads.end(); it++)
+      it->join();
+
+  delete [] logs;
+  delete [] bufs;
+
+  Int_t nvalid = 0;
+  for (Int_t pixid=0; pixid<npix; pixid++)
+  {
+      msg[pixid].WriteTo(*fLog);
+
+      if (valid[pixid])
+          nvalid++;
+  }
+
+  delete [] msg;
+
+  return nvalid;
+}
+
 // ----------------------------------------------------------------------------------
 //  
 // Retrieves pedestal and pedestal RMS from MPedestalPix 
@@ -1041,6 +1230,8 @@ void MCalibrationChargeCalc::FinalizePedestals(const MPedestalPix &ped, MCalibra
 //
 // Check fit results validity. Bad Pixels flags are set if:
 //
+// All messages are written to out (which doesn't need to be an MLog).
+//
 // 1) Pixel has a mean smaller than fChargeLimit*PedRMS    ( Flag: MBadPixelsPix::kChargeIsPedestal)
 // 2) Pixel has a mean error smaller than fChargeErrLimit  ( Flag: MBadPixelsPix::kChargeErrNotValid)
 // 3) Pixel has mean smaller than fChargeRelVarLimit times its mean error 
@@ -1058,63 +1249,63 @@ void MCalibrationChargeCalc::FinalizePedestals(const MPedestalPix &ped, MCalibra
 // Calls MCalibrationChargePix::CalcConvFFactor()and sets flag: MBadPixelsPix::kDeviatingNumPhes) 
 //       and returns kFALSE if not succesful.
 //
-Bool_t MCalibrationChargeCalc::FinalizeCharges(MCalibrationChargePix &cal, MBadPixelsPix &bad, const char* what)
+Bool_t MCalibrationChargeCalc::FinalizeCharges(MCalibrationChargePix &cal, MBadPixelsPix &bad, const char* what, ostream &out)
 {
 
   if (bad.IsUnsuitable(MBadPixelsPix::kUnsuitableRun))
     return kFALSE;
 
-  const TString desc = Form("%7s%4d: ", what, cal.GetPixId());
+  const TString desc = MString::Format("%7s%4d: ", what, cal.GetPixId());
 
   if (cal.GetMean()<0)
   {
-      *fLog << warn << desc << "Charge not fitted." << endl;
+      out << warn << desc << "Charge not fitted." << endl;
       bad.SetUncalibrated( MBadPixelsPix::kChargeIsPedestal);
       return kFALSE;
   }
 
   if (cal.GetSigma()<0)
   {
-      *fLog << warn << desc << "Charge Sigma invalid." << endl;
+      out << warn << desc << "Charge Sigma invalid." << endl;
       bad.SetUncalibrated( MBadPixelsPix::kChargeIsPedestal);
       return kFALSE;
   }
 
   if (cal.GetMean() < fChargeLimit*cal.GetPedRms())
     {
-      *fLog << warn << desc
-            << Form("Fitted Charge: %5.2f < %2.1f",cal.GetMean(),fChargeLimit)
-            << Form(" * Pedestal RMS %5.2f",cal.GetPedRms()) << endl;
+      out << warn << desc
+            << MString::Format("Fitted Charge: %5.2f < %2.1f",cal.GetMean(),fChargeLimit)
+            << MString::Format(" * Pedestal RMS %5.2f",cal.GetPedRms()) << endl;
       bad.SetUncalibrated( MBadPixelsPix::kChargeIsPedestal);
     }
   
    if (cal.GetMean() < fChargeRelErrLimit*cal.GetMeanErr()) 
     {
-      *fLog << warn << desc
-            << Form("Fitted Charge: %4.2f < %2.1f",cal.GetMean(),fChargeRelErrLimit)
-            << Form(" * its error %4.2f",cal.GetMeanErr()) << endl;
+      out << warn << desc
+            << MString::Format("Fitted Charge: %4.2f < %2.1f",cal.GetMean(),fChargeRelErrLimit)
+            << MString::Format(" * its error %4.2f",cal.GetMeanErr()) << endl;
       bad.SetUncalibrated( MBadPixelsPix::kChargeRelErrNotValid );
     }
 
   if (cal.GetSigma() < cal.GetPedRms())
     {
-      *fLog << warn << desc << "Sigma of Fitted Charge: "
-            << Form("%6.2f <",cal.GetSigma()) << " Ped. RMS="
-            << Form("%5.2f", cal.GetPedRms()) << endl;
+      out << warn << desc << "Sigma of Fitted Charge: "
+            << MString::Format("%6.2f <",cal.GetSigma()) << " Ped. RMS="
+            << MString::Format("%5.2f", cal.GetPedRms()) << endl;
       bad.SetUncalibrated( MBadPixelsPix::kChargeSigmaNotValid );
       return kFALSE;
     }
 
   if (!cal.CalcReducedSigma())
     {
-      *fLog << warn << desc << "Could not calculate the reduced sigma" << endl;
+      out << warn << desc << "Could not calculate the reduced sigma" << endl;
       bad.SetUncalibrated( MBadPixelsPix::kChargeSigmaNotValid );
       return kFALSE;
     }
 
   if (!cal.CalcFFactor())
     {
-      *fLog << warn << desc << "Could not calculate the F-Factor"<< endl;
+      out << warn << desc << "Could not calculate the F-Factor"<< endl;
       bad.SetUncalibrated(MBadPixelsPix::kDeviatingNumPhes);
       bad.SetUnsuitable(MBadPixelsPix::kUnsuitableRun);
       return kFALSE;
@@ -1130,7 +1321,7 @@ Bool_t MCalibrationChargeCalc::FinalizeCharges(MCalibrationChargePix &cal, MBadP
 
   if (!cal.CalcConvFFactor())
     {
-      *fLog << warn << desc << "Could not calculate the Conv. FADC counts to Phes"<< endl;
+      out << warn << desc << "Could not calculate the Conv. FADC counts to Phes"<< endl;
       bad.SetUncalibrated(MBadPixelsPix::kDeviatingNumPhes);
       return kFALSE;
     }
@@ -1140,7 +1331,7 @@ Bool_t MCalibrationChargeCalc::FinalizeCharges(MCalibrationChargePix &cal, MBadP
 
   if (!fExtractor)
     {
-      *fLog << err << "Extractor resolution has been chosen, but no extractor is set. Cannot calibrate." << endl;
+      out << err << "Extractor resolution has been chosen, but no extractor is set. Cannot calibrate." << endl;
       return kFALSE;
     }
 
@@ -1154,21 +1345,21 @@ Bool_t MCalibrationChargeCalc::FinalizeCharges(MCalibrationChargePix &cal, MBadP
 
   if (resinfadc > 3.0*cal.GetPedRms() )
     {
-      *fLog << warn << desc << "Extractor Resolution " << Form("%5.2f", resinfadc) << " bigger than 3 Pedestal RMS "
-            << Form("%4.2f", cal.GetPedRms()) << endl;
+      out << warn << desc << "Extractor Resolution " << MString::Format("%5.2f", resinfadc) << " bigger than 3 Pedestal RMS "
+            << MString::Format("%4.2f", cal.GetPedRms()) << endl;
       resinfadc = 3.0*cal.GetPedRms();
     }
 
   if (!cal.CalcReducedSigma(resinfadc))
     {
-        *fLog << warn << desc << "Could not calculate the reduced sigma" << endl;
+        out << warn << desc << "Could not calculate the reduced sigma" << endl;
         bad.SetUncalibrated( MBadPixelsPix::kChargeSigmaNotValid );
         return kFALSE;
     }
 
   if (!cal.CalcFFactor())
     {
-        *fLog << warn << desc << "Could not calculate the F-Factor" << endl;
+        out << warn << desc << "Could not calculate the F-Factor" << endl;
       bad.SetUncalibrated(MBadPixelsPix::kDeviatingNumPhes);
       bad.SetUnsuitable(MBadPixelsPix::kUnsuitableRun);
       return kFALSE;
@@ -1184,7 +1375,7 @@ Bool_t MCalibrationChargeCalc::FinalizeCharges(MCalibrationChargePix &cal, MBadP
 
   if (!cal.CalcConvFFactor())
     {
-      *fLog << warn << desc << "Could not calculate the conv. FADC cts to phes" << endl;
+      out << warn << desc << "Could not calculate the conv. FADC cts to phes" << endl;
       bad.SetUncalibrated(MBadPixelsPix::kDeviatingNumPhes);
       return kFALSE;
     }
@@ -2391,6 +2582,12 @@ Int_t MCalibrationChargeCalc::ReadEnv(const TEnv &env, TString prefix, Bool_t pr
        SetUnreliablesLimit(GetEnvValue(env, prefix, "UnreliablesLimit", fUnreliablesLimit));
        rc = kTRUE;
      }
+
+  if (IsEnvDefined(env, prefix, "NumThreads", print))
+    {
+      SetNumThreads(GetEnvValue(env, prefix, "NumThreads", fNumThreads));
+      rc = kTRUE;
+    }
  
 
   return rc;
@@ -31,6 +31,9 @@ class MGeomCam;
 class MExtractedSignalCam;
 class MBadPixelsCam;
 class MExtractor;
+class TStopwatch;
+class MLog;
+class MLogBuffer;
 
 class MCalibrationChargeCalc : public MTask
 {
@@ -81,6 +84,8 @@ private:
 
   Bool_t fContinousCalibration;
 
+  Int_t   fNumThreads;                         // Number of threads for the per-pixel finalization (<=0: number of cores)
+
   // Pointers
   MBadPixelsCam                  *fBadPixels;      //!  Bad Pixels
   MCalibrationChargeCam          *fCam;            //!  Calibrated Charges results of all pixels
@@ -129,7 +134,7 @@ private:
   void   FinalizeBadPixels       ();
   Bool_t FinalizeBlindCam        ();  
   void   FinalizeBlindPixelQECam ();
-  Bool_t FinalizeCharges         ( MCalibrationChargePix &cal, MBadPixelsPix &bad, const char* what);
+  Bool_t FinalizeCharges         ( MCalibrationChargePix &cal, MBadPixelsPix &bad, const char* what, std::ostream &out);
   void   FinalizeCombinedQECam   ();
   void   FinalizeFFactorQECam    ();  
   Bool_t FinalizeFFactorMethod   ();
@@ -138,6 +143,10 @@ private:
   void   FinalizePINDiodeQECam   ();
   Bool_t FinalizeUnsuitablePixels();
 
+  Int_t  FinalizePixels          ();
+  void   FinalizePixelRange      ( Int_t first, Int_t last, MLog *log, MLogBuffer *buf, MLogBuffer *msg, Byte_t *valid );
+  void   PrintTiming             ( const char *stage, TStopwatch &clock ) const;
+
   void FinalizeAbsTimes();
 
   const char* GetOutputFile();
@@ -196,6 +205,7 @@ public:
   void SetUseExternalNumPhes(const Bool_t b=kTRUE)     { b ? SETBIT(fFlags, kUseExternalNumPhes)         : CLRBIT(fFlags, kUseExternalNumPhes); }
 
   void SetContinousCalibration(const Bool_t b=kTRUE)   { fContinousCalibration = b; }
+  void SetNumThreads(const Int_t n=0)                  { fNumThreads = n; }
 
   // pointers
   void SetPedestals(MPedestalCam *cam) { fPedestals=cam; }
@@ -217,7 +227,7 @@ public:
   void SetPheErrUpperLimit     ( const Float_t f=fgPheErrUpperLimit       ) { fPheErrUpperLimit  = f;    }    
   void SetPulserColor          ( const MCalibrationCam::PulserColor_t col ) { fPulserColor       = col;  }
 
-  ClassDef(MCalibrationChargeCalc, 6)   // Task calculating Calibration Containers and Quantum Efficiencies
+  ClassDef(MCalibrationChargeCalc, 7)   // Task calculating Calibration Containers and Quantum Efficiencies
 };
 
 #endif
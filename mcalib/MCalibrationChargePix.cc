@@ -124,6 +124,7 @@
 
 #include "MLog.h"
 #include "MLogManip.h"
+#include "MString.h"
 
 #include "MBadPixelsPix.h"
 
@@ -911,7 +912,7 @@ Bool_t MCalibrationChargePix::CalcConvFFactor()
   if (convrelvar > limit || convrelvar < 0.)
     {
         *fLog << warn << "pixel  " << setw(4) << fPixId << ": Conv. F-Factor Method Rel. Var.: "
-            << Form("%4.3f out of limits: [0,%3.2f]",convrelvar,limit) << endl;
+            << MString::Format("%4.3f out of limits: [0,%3.2f]",convrelvar,limit) << endl;
         return kFALSE;
     }
   
@@ -39,6 +39,7 @@
 
 #include "MLog.h"
 #include "MLogManip.h"
+#include "MParse.h"
 
 ClassImp(MCameraDC);
 
@@ -67,16 +68,13 @@ Int_t MCameraDC::Interprete(TString &str, Int_t len)
     Int_t i=0;
     while (pos<end)
     {
-        Int_t c;
-        const Char_t hex[5] = { pos[0], pos[1], pos[2], pos[3], 0 };
-        pos += 4;
-
-        const Int_t nn=sscanf(hex, "%4x", &c);
-        if (nn!=1)
+        UInt_t c;
+        if (!MParse::ReadHex(pos, 4, c))
         {
             *fLog << warn << "WARNING - Reading hexadecimal DC information." << endl;
             return kCONTINUE;
         }
+        pos += 4;
 
         fArray[i++] = 0.001*c;
     }
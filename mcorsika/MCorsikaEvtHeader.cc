@@ -61,7 +61,7 @@ using namespace std;
 // Default constructor. Create the array to store the data.
 //
 MCorsikaEvtHeader::MCorsikaEvtHeader(const char *name, const char *title)
-    : fNumReuse((UInt_t)-1), fX(0), fY(0)
+    : fEvtNumber(0), fNumReuse((UInt_t)-1), fX(0), fY(0)
 {
     fName  = name  ? name  : "MCorsikaEvtHeader";
     fTitle = title ? title : "Raw Event Header Information";
@@ -41,6 +41,7 @@
 #include <errno.h>
 #include <fstream>
 
+#include <TMath.h>
 #include <TSystem.h>
 
 #include "MLog.h"
@@ -322,6 +323,46 @@ Bool_t MCorsikaRead::CalcNumTotalEvents()
     return rc;
 }
 
+// --------------------------------------------------------------------------
+//
+// Sort the indices of the photon bunches of the raw event by their reuse
+// (counting sort, the order within one reuse is kept). Afterwards the
+// bunches of reuse i are fReuseIndex[fReuseFirst[i]] to
+// fReuseIndex[fReuseFirst[i+1]-1]. Thus the buffer is scanned only once
+// per shower instead of once per reuse. Empty bunches and bunches of
+// reuses not in the run header are skipped.
+//
+void MCorsikaRead::IndexRawEvent()
+{
+    const Int_t nreuse = fRunHeader->GetNumReuse();
+    const Int_t num    = fRawEvemtBuffer.size()/7;
+
+    // The reuse index is stored (one-based) in the first number of a bunch
+    vector<Int_t> reuse(num);
+    for (Int_t i=0; i<num; i++)
+    {
+        const Int_t n = TMath::Nint(fRawEvemtBuffer[7*i]);
+        reuse[i] = n==0 ? -1 : (n/1000)%100 - 1;
+    }
+
+    // Count the bunches of each reuse
+    fReuseFirst.assign(nreuse+1, 0);
+    for (Int_t i=0; i<num; i++)
+        if (reuse[i]>=0 && reuse[i]<nreuse)
+            fReuseFirst[reuse[i]+1]++;
+
+    for (Int_t r=0; r<nreuse; r++)
+        fReuseFirst[r+1] += fReuseFirst[r];
+
+    // Distribute the indices
+    vector<Int_t> pos(fReuseFirst.begin(), fReuseFirst.end()-1);
+
+    fReuseIndex.resize(fReuseFirst[nreuse]);
+    for (Int_t i=0; i<num; i++)
+        if (reuse[i]>=0 && reuse[i]<nreuse)
+            fReuseIndex[pos[reuse[i]]++] = i;
+}
+
 // --------------------------------------------------------------------------
 //
 // Reads the the position of all telescopes in one array
@@ -639,9 +680,17 @@ Int_t MCorsikaRead::Process()
 
             case 1109:  // save corsika events
                fEvtHeader->InitXY();
-               status = fEvent->ReadCorsikaEvt(&fRawEvemtBuffer[0], 
-                                               fRawEvemtBuffer.size() / 7, 
-                                               fEvtHeader->GetNumReuse()+1);
+
+               // sort the bunches of all reuses once per shower
+               if (fEvtHeader->GetNumReuse() == 0)
+                  IndexRawEvent();
+
+               {
+               const UInt_t reuse = fEvtHeader->GetNumReuse();
+               status = fEvent->ReadCorsikaEvt(fRawEvemtBuffer.data(),
+                                               fReuseIndex.data() + fReuseFirst[reuse],
+                                               fReuseFirst[reuse+1] - fReuseFirst[reuse]);
+               }
                fEvtHeader->IncNumReuse();
 
                if (fEvtHeader->GetNumReuse() == fRunHeader->GetNumReuse())
@@ -649,6 +698,7 @@ Int_t MCorsikaRead::Process()
                   // this was the last reuse. Set fBlockType to EVTE to save
                   // it the next time.
                   fRawEvemtBuffer.resize(0);
+                  fReuseIndex.resize(0);
 
                   fReadState = 3;
                   fBlockType = 1209;
@@ -63,6 +63,8 @@ private:
     Int_t   fTopBlockLength;   // remaining length of the current top-level block 1204
 
     std::vector<Float_t>  fRawEvemtBuffer;     //! buffer of raw event data
+    std::vector<Int_t>    fReuseIndex;         //! bunch indices in fRawEvemtBuffer sorted by reuse
+    std::vector<Int_t>    fReuseFirst;         //! first entry in fReuseIndex of each reuse
     //UInt_t    fInterleave;
     //Bool_t    fForce;
 
@@ -71,6 +73,7 @@ private:
     Bool_t CalcNumTotalEvents();
     Int_t  ReadTelescopePosition();
     Int_t  ReadNextBlockHeader();
+    void   IndexRawEvent();
 
     // MTask
     Int_t PreProcess(MParList *pList);
@@ -39,6 +39,7 @@
 #include "MLog.h"
 #include "MLogManip.h"
 
+#include "MArrayI.h"
 #include "MSpline3.h"
 #include "MDigitalSignal.h"
 
@@ -107,6 +108,46 @@ Bool_t MAnalogSignal::AddPulse(const MSpline3 &spline, Float_t t, Float_t f)
     return rc;
 }
 
+// ------------------------------------------------------------------------
+//
+// Add a pulse tabulated in steps of 1/nsub samples at the time c/nsub
+// multiplied by f. tab[k-kmin] is the pulse at k/nsub. Sample i gets
+// the entry with k=i*nsub-c, i.e. the tabulated value at i-c/nsub.
+// Contrary to the spline no interpolation is done, thus the pulse time
+// is quantized to 1/nsub samples.
+//
+// Return kTRUE if the full range of the table could be added to the
+// analog signal, kFALSE otherwise.
+//
+Bool_t MAnalogSignal::AddPulse(const MArrayF &tab, Int_t kmin, UInt_t nsub, Int_t c, Float_t f)
+{
+    const Int_t kmax = kmin+tab.GetSize()-1;
+
+    // Samples with kmin<=i*nsub-c<=kmax
+    Int_t first = TMath::CeilNint (Double_t(c+kmin)/nsub);
+    Int_t last  = TMath::FloorNint(Double_t(c+kmax)/nsub)+1;
+
+    Bool_t rc = kTRUE;
+    if (first<0)
+    {
+        first=0;
+        rc = kFALSE;
+    }
+    if (last>(Int_t)GetSize())
+    {
+        last=GetSize();
+        rc = kFALSE;
+    }
+
+    const Float_t *ptr = tab.GetArray() - c - kmin;
+
+    Float_t *arr = GetArray();
+    for (Int_t i=first; i<last; i++)
+        arr[i] += ptr[i*nsub]*f;
+
+    return rc;
+}
+
 // ------------------------------------------------------------------------
 //
 // Evaluate the spline an add the result between t+xmin and t+xmax
@@ -160,7 +201,7 @@ void MAnalogSignal::AddSignal(const MAnalogSignal &s, Int_t delay,
 
 
 // Deprecated. Use MSimRandomPhotons instead
-void MAnalogSignal::AddRandomPulses(const MSpline3 &spline, Float_t num)
+void MAnalogSignal::AddRandomPulses(const MSpline3 &spline, Float_t num, TRandom *rnd)
 {
     // Average number (1./freq) of pulses per slice
 
@@ -170,11 +211,13 @@ void MAnalogSignal::AddRandomPulses(const MSpline3 &spline, Float_t num)
     const UInt_t first = TMath::CeilNint(start);
     const UInt_t last  = TMath::CeilNint(end); // Ceil:< Floor:<=
 
+    TRandom &r = rnd ? *rnd : *gRandom;
+
     Double_t d = first;
 
     while (d<last)
     {
-        d += gRandom->Exp(num);
+        d += r.Exp(num);
         AddPulse(spline, d);
     }
 }
@@ -183,11 +226,86 @@ void MAnalogSignal::AddRandomPulses(const MSpline3 &spline, Float_t num)
 //
 // Add a random gaussian with amplitude and offset to every bin
 // of the analog signal. The default offset is 0. The default amplitude 1.
+// If no generator rnd is given gRandom is used.
 //
-void MAnalogSignal::AddGaussianNoise(Float_t amplitude, Float_t offset)
+// The uniform random numbers are requested in blocks (RndmArray) and
+// converted pairwise with the Box-Muller method in a loop without
+// dependencies between the iterations, instead of calling
+// TRandom::Gaus for every sample.
+//
+void MAnalogSignal::AddGaussianNoise(Float_t amplitude, Float_t offset, TRandom *rnd)
 {
-    for (Float_t *ptr = GetArray(); ptr<GetArray()+fN; ptr++)
-        *ptr += gRandom->Gaus(offset, amplitude);
+    TRandom &r = rnd ? *rnd : *gRandom;
+
+    const UInt_t kBlock = 256;
+
+    Double_t u[kBlock];
+
+    Float_t *arr = GetArray();
+    for (UInt_t i=0; i<fN; i+=kBlock)
+    {
+        const UInt_t n = TMath::Min(fN-i, kBlock);
+        const UInt_t m = (n+1)&~1U;
+
+        // Uniform numbers in ]0, 1[
+        r.RndmArray(m, u);
+
+        for (UInt_t j=0; j<m; j+=2)
+        {
+            const Double_t rad = amplitude*TMath::Sqrt(-2*TMath::Log(u[j]));
+            const Double_t phi = TMath::TwoPi()*u[j+1];
+
+            u[j]   = rad*TMath::Cos(phi);
+            u[j+1] = rad*TMath::Sin(phi);
+        }
+
+        for (UInt_t j=0; j<n; j++)
+            arr[i+j] += offset + u[j];
+    }
+}
+
+// ------------------------------------------------------------------------
+//
+// Add noise from a library of recorded (baseline subtracted) traces to
+// the analog signal. The traces are stored one after the other in lib,
+// trace k are the samples first[k] to first[k+1]-1. The samples are
+// copied starting at a random sample of a random trace, multiplied by
+// scale and offset is added. If the end of the trace is reached before
+// the end of the signal, it is continued with the beginning of another
+// random trace. If no generator rnd is given gRandom is used.
+//
+// Empty traces are not allowed.
+//
+void MAnalogSignal::AddNoise(const MArrayF &lib, const MArrayI &first, Float_t offset, Float_t scale, TRandom *rnd)
+{
+    if (first.GetSize()<2)
+        return;
+
+    TRandom &r = rnd ? *rnd : *gRandom;
+
+    const UInt_t num = first.GetSize()-1;
+
+    // Random trace and random start sample
+    UInt_t k   = r.Integer(num);
+    UInt_t pos = first[k] + r.Integer(first[k+1]-first[k]);
+
+    Float_t *arr = GetArray();
+
+    UInt_t i = 0;
+    while (i<fN)
+    {
+        const UInt_t n = TMath::Min(fN-i, first[k+1]-pos);
+
+        const Float_t *src = lib.GetArray()+pos;
+        for (UInt_t j=0; j<n; j++)
+            arr[i+j] += src[j]*scale + offset;
+
+        i += n;
+
+        // Continue with the beginning of another trace
+        k   = r.Integer(num);
+        pos = first[k];
+    }
 }
 
 // ------------------------------------------------------------------------
@@ -6,6 +6,8 @@
 #endif
 
 class TF1;
+class TRandom;
+class MArrayI;
 class MSpline3;
 
 class MAnalogSignal : public MArrayF/*TObject*/
@@ -20,12 +22,14 @@ public:
     void   Set(UInt_t n);
     Bool_t AddPulse(const MSpline3 &spline, Float_t t, Float_t f=1);
     Bool_t AddPulse(const TF1 &f1, Float_t t, Float_t f=1);
+    Bool_t AddPulse(const MArrayF &tab, Int_t kmin, UInt_t nsub, Int_t c, Float_t f=1);
     void   AddSignal(const MAnalogSignal &s, Int_t delay=0,Float_t dampingFact=1.0);
 
     // Deprecated. Use MSimRandomPhotons instead
-    void AddRandomPulses(const MSpline3 &spline, Float_t num);
+    void AddRandomPulses(const MSpline3 &spline, Float_t num, TRandom *rnd=0);
 
-    void AddGaussianNoise(Float_t amplitude=1, Float_t offset=0);
+    void AddGaussianNoise(Float_t amplitude=1, Float_t offset=0, TRandom *rnd=0);
+    void AddNoise(const MArrayF &lib, const MArrayI &first, Float_t offset=0, Float_t scale=1, TRandom *rnd=0);
 
     TObjArray *Discriminate(Float_t threshold, Double_t start, Double_t end, Float_t len=-1) const;
     TObjArray *Discriminate(Float_t threshold, Float_t len=-1) const { return Discriminate(threshold, 0, fN-1, len); }
@@ -126,7 +126,7 @@ public:
 APD::APD(Int_t n, Float_t prob, Float_t dt, Float_t rt)
     : fHist("APD", "", n, 0.5, n+0.5, n, 0.5, n+0.5),
     fCrosstalkProb(prob), fDeadTime(dt), fRecoveryTime(rt),
-    fTime(-1)
+    fTime(-1), fRandom(0)
 {
     fHist.SetDirectory(0);
 
@@ -139,6 +139,15 @@ APD::APD(Int_t n, Float_t prob, Float_t dt, Float_t rt)
     fAfterpulseTau[1] = 85;
 }
 
+// --------------------------------------------------------------------------
+//
+// Return the generator set by SetRandom or gRandom if none was set.
+//
+TRandom &APD::GetRandom() const
+{
+    return fRandom ? *fRandom : *gRandom;
+}
+
 // --------------------------------------------------------------------------
 //
 // This is the time a chips needs after an external signal to relax to
@@ -240,12 +249,12 @@ Float_t APD::HitCellImp(Int_t x, Int_t y, Float_t t)
     Float_t n = weight;
 
     // Get random number of emitted and possible converted crosstalk photons
-    const UInt_t rndm = gRandom->Poisson(prob);
+    const UInt_t rndm = GetRandom().Poisson(prob);
 
     for (UInt_t i=0; i<rndm; i++)
     {
         // Get a random neighbor which is hit.
-        switch (gRandom->Integer(4))
+        switch (GetRandom().Integer(4))
         {
         case 0: if (x<fHist.GetNbinsX()) n += HitCellImp(x+1, y, t); break;
         case 1: if (x>1)                 n += HitCellImp(x-1, y, t); break;
@@ -288,7 +297,7 @@ Float_t APD::HitRandomCell(Float_t t)
     const UInt_t nx  = fHist.GetNbinsX();
     const UInt_t ny  = fHist.GetNbinsY();
 
-    const UInt_t idx = gRandom->Integer(nx*ny);
+    const UInt_t idx = GetRandom().Integer(nx*ny);
 
     const UInt_t x   = idx%nx;
     const UInt_t y   = idx/nx;
@@ -366,7 +375,7 @@ void APD::FillRandom(Float_t rate, Float_t t)
 
         for (int x=1; x<=nx; x++)
             for (int y=1; y<=ny; y++)
-                HitCellImp(x, y, t-MMath::RndmExp(f));
+                HitCellImp(x, y, t-MMath::RndmExp(f, &GetRandom()));
 
     }
 
@@ -433,7 +442,7 @@ Float_t APD::Evolve(Double_t freq, Double_t dt)
         Double_t time = fTime;
         while (1)
         {
-            const Double_t deltat = MMath::RndmExp(avglen);
+            const Double_t deltat = MMath::RndmExp(avglen, &GetRandom());
             if (time+deltat>end)
                 break;
 
@@ -516,7 +525,7 @@ void APD::GenerateAfterpulse(UInt_t cell, Int_t idx, Double_t charge, Double_t t
 {
     // The cell had a single avalanche with signal height weight.
     // This cell now can produce an afterpulse photon/avalanche.
-    const Double_t p = gRandom->Uniform();
+    const Double_t p = GetRandom().Uniform();
 
     // It's probability scales with the charge of the pulse
     if (p>charge*fAfterpulseProb[idx])
@@ -524,7 +533,7 @@ void APD::GenerateAfterpulse(UInt_t cell, Int_t idx, Double_t charge, Double_t t
 
     // Afterpulses come with a well defined time-constant
     // after the normal pulse
-    const Double_t dt = MMath::RndmExp(fAfterpulseTau[idx]);
+    const Double_t dt = MMath::RndmExp(fAfterpulseTau[idx], &GetRandom());
 
     fAfterpulses.Add(new Afterpulse(cell, t+dt));
 
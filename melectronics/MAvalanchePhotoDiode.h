@@ -9,6 +9,8 @@
 #include <TSortedList.h>
 #endif
 
+class TRandom;
+
 class APD : public TObject  // FIXME: Derive from TH2?
 {
     friend class Afterpulse;
@@ -26,6 +28,10 @@ private:
 
     Float_t fTime;              // A user settable time of the system
 
+    TRandom *fRandom;           //! Random number generator (gRandom if NULL)
+
+    TRandom &GetRandom() const;
+
     // The implementation of the cell behaviour (crosstalk and afterpulses)
     Float_t HitCellImp(Int_t x, Int_t y, Float_t t=0);
 
@@ -46,6 +52,9 @@ public:
     // Set the afterpulse probability for distribution 1 and 2
     void SetAfterpulseProb(Double_t p1, Double_t p2) { fAfterpulseProb[0]=p1; fAfterpulseProb[1]=p2; }
 
+    // Set the random number generator (NULL: gRandom)
+    void SetRandom(TRandom *rnd) { fRandom = rnd; }
+
     // Getter functions
     Float_t GetCellContent(Int_t x, Int_t y) const { return fHist.GetBinContent(x, y); }
     Int_t   GetNumCellsX() const { return fHist.GetNbinsX(); }
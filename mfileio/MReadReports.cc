@@ -58,11 +58,25 @@
 // set to this name. This means that only tasks having this stream id
 // are executed.
 //
+// Only the time stamps of the next entries of all trees are read in
+// advance (the chains in fChains have only the time branch enabled), the
+// full entry is read only from the tree which is processed next. The
+// trees are kept in a binary heap ordered by the time stamp of their next
+// entry (ties are resolved by the order in which the trees were added),
+// so that finding the next tree and re-inserting it after reading the
+// next time stamp scales with the logarithm of the number of trees.
+//
+//
+// Class Version 1:
+// ----------------
+//  - TList     *fChains;
+//  + TObjArray *fChains;
+//
 /////////////////////////////////////////////////////////////////////////////
 #include "MReadReports.h"
 
 #include <TChain.h>
-#include <TChainElement.h>
+#include <TObjArray.h>
 
 #include "MLog.h"
 #include "MLogManip.h"
@@ -82,13 +96,14 @@ using namespace std;
 // Default constructor. Set fName and fTitle. Instatiate fTrees and fChains.
 // Call SetOwner for fTrees and fChains
 //
-MReadReports::MReadReports() : fEnableAutoScheme(kFALSE)
+MReadReports::MReadReports()
+    : fTimes(0), fHeapSize(-1), fNumActive(0), fEnableAutoScheme(kFALSE)
 {
     fName  = "MRead";
     fTitle = "Reads events and reports from a root file ordered in time";
 
     fTrees  = new MTaskList("MReadReports");
-    fChains = new TList;
+    fChains = new TObjArray;
 
     fTrees->SetOwner();
     fChains->SetOwner();
@@ -100,15 +115,47 @@ MReadReports::MReadReports() : fEnableAutoScheme(kFALSE)
 //
 MReadReports::~MReadReports()
 {
-    TObject *o=0;
-    TIter NextC(fChains);
-    while ((o=NextC()))
-        delete *GetTime((TChain*)o);
+    DeleteChains();
 
     delete fTrees;
     delete fChains;
 }
 
+// --------------------------------------------------------------------------
+//
+// Delete the chain i (and its time stamp) and decrease the number of
+// active chains.
+//
+void MReadReports::RemoveChain(Int_t i)
+{
+    delete fChains->RemoveAt(i);
+
+    delete *fTimes[i];
+    delete fTimes[i];
+    fTimes[i] = 0;
+
+    fNumActive--;
+}
+
+// --------------------------------------------------------------------------
+//
+// Delete all chains in fChains and the time stamps.
+//
+void MReadReports::DeleteChains()
+{
+    for (Int_t i=0; i<fChains->GetSize(); i++)
+        if (fChains->At(i))
+            RemoveChain(i);
+
+    fChains->Clear();
+
+    delete [] fTimes;
+    fTimes = 0;
+
+    fNumActive = 0;
+    fHeapSize  = -1;
+}
+
 // --------------------------------------------------------------------------
 //
 // Return the number of entries in all trees.
@@ -250,7 +297,9 @@ void MReadReports::ForceRequired()
 //
 Int_t MReadReports::PreProcess(MParList *plist)
 {
-    fChains->Delete();
+    DeleteChains();
+
+    fTimes = new MTime**[fTrees->GetList()->GetSize()];
 
     Int_t i=0;
 
@@ -304,7 +353,8 @@ Int_t MReadReports::PreProcess(MParList *plist)
         c->Add((TChain*)tree->fChain);
         c->GetEntry(0);
 
-        fChains->Add(c);
+        fChains->AddAtAndExpand(c, i);
+        fTimes[i] = tx;
 
         i++;
     }
@@ -318,6 +368,10 @@ Int_t MReadReports::PreProcess(MParList *plist)
     fPosEntry.Set(i);
     fPosEntry.Reset();
 
+    fHeap.Set(i);
+    fHeapSize  = -1;
+    fNumActive = i;
+
     // Force that with the next call to Process the required events are read
     ForceRequired();
     //fFirstReInit=kTRUE;
@@ -343,31 +397,78 @@ Bool_t MReadReports::ReInit(MParList *plist)
 
 // --------------------------------------------------------------------------
 //
-// Return the number of the tree which is the next one to be read.
-// The condition for this decision is the time-stamp.
+// Return whether the next entry of chain i is to be read before the next
+// entry of chain j, i.e. its time-stamp is earlier. In case of identical
+// time-stamps the chain added first is read first.
 //
-Int_t MReadReports::FindNextTime()
+Bool_t MReadReports::IsBefore(Int_t i, Int_t j) const
 {
-    TIter NextC(fChains);
-    TChain *c=0;
+    const MTime &ti = **fTimes[i];
+    const MTime &tj = **fTimes[j];
 
-    Int_t nmin=0;
-    MTime tmin(**GetTime((TChain*)NextC()));
+    if (ti<tj)
+        return kTRUE;
+    if (tj<ti)
+        return kFALSE;
 
-    Int_t i=0;
+    return i<j;
+}
+
+// --------------------------------------------------------------------------
+//
+// Restore the heap condition for the element at position pos of fHeap
+//
+void MReadReports::SiftDown(Int_t pos)
+{
+    const Int_t idx = fHeap[pos];
 
-    while ((c=(TChain*)NextC()))
+    while (1)
     {
-        MTime &t = **GetTime(c);
-        i++;
+        Int_t child = 2*pos+1;
+        if (child>=fHeapSize)
+            break;
 
-        if (t >= tmin)
-            continue;
+        if (child+1<fHeapSize && IsBefore(fHeap[child+1], fHeap[child]))
+            child++;
+
+        if (!IsBefore(fHeap[child], idx))
+            break;
 
-        tmin = t;
-        nmin = i;
+        fHeap[pos] = fHeap[child];
+        pos = child;
     }
-    return nmin;
+
+    fHeap[pos] = idx;
+}
+
+// --------------------------------------------------------------------------
+//
+// Fill the indices of all active chains into the heap and order it
+//
+void MReadReports::BuildHeap()
+{
+    fHeapSize = 0;
+    for (Int_t i=0; i<fChains->GetSize(); i++)
+        if (fChains->At(i))
+            fHeap[fHeapSize++] = i;
+
+    for (Int_t pos=fHeapSize/2-1; pos>=0; pos--)
+        SiftDown(pos);
+}
+
+// --------------------------------------------------------------------------
+//
+// Return the number of the tree which is the next one to be read.
+// The condition for this decision is the time-stamp. This is the tree
+// on top of the heap. If the heap is not valid (after reading the
+// required trees) it is rebuilt.
+//
+Int_t MReadReports::FindNextTime()
+{
+    if (fHeapSize<0)
+        BuildHeap();
+
+    return fHeapSize>0 ? fHeap[0] : -1;
 }
 
 // --------------------------------------------------------------------------
@@ -387,23 +488,18 @@ Int_t MReadReports::FindNextRequired()
         {
             o->SetBit(kIsProcessed);
             fNumRequired--;
-            *fLog << dbg << "Reading from tree " << n << " " << o->GetName() << endl;
-            return n;
+
+            // Skip trees without further entries
+            if (fChains->At(n))
+            {
+                *fLog << dbg << "Reading from tree " << n << " " << o->GetName() << endl;
+                return n;
+            }
         }
         n++;
     }
 
-    return -1;
-}
-
-// --------------------------------------------------------------------------
-//
-// Return the MTime corresponding to this TChain...
-//
-MTime** MReadReports::GetTime(TChain *c) const
-{
-    TChainElement *e=(TChainElement*)c->GetStatus()->At(1);
-    return (MTime**)e->GetBaddress();
+    return fNumRequired==0 ? FindNextTime() : -1;
 }
 
 // --------------------------------------------------------------------------
@@ -413,7 +509,7 @@ MTime** MReadReports::GetTime(TChain *c) const
 //
 Int_t MReadReports::Process()
 {
-    while (fChains->GetSize())
+    while (fNumActive>0)
     {
         // Find the next tree to read from checking the time-stamps
         // of the next events which would be read
@@ -437,36 +533,21 @@ Int_t MReadReports::Process()
         // be checked for reading the next events, because there is none.
         if (cnt<=0 || rc==kFALSE)
         {
-            *fLog << inf << "Removing chain " << chain->GetName() << " from list" << flush;
-
-            // Find index of chain to be removed
-            const Int_t idx = fChains->IndexOf(chain);
-            *fLog << " (" << idx << ")" << flush;
+            *fLog << inf << "Removing chain " << chain->GetName() << " from list (" << nmin << ")..." << flush;
 
-            delete *GetTime(chain);        // Delete MTime*
-            *fLog << "." << flush;
-            delete fChains->Remove(chain); // Remove chain from TList
-            *fLog << "." << flush;
+            RemoveChain(nmin);
 
-            // Change array accordingly
-            if (fPosEntry.GetSize()>1)
-            {
-                for (int i=idx; i<fPosEntry.GetSize()-1; i++)
-                    fPosEntry[i] = fPosEntry[i+1];
-                fPosEntry[fPosEntry.GetSize()-1] = 0;
-            }
+            // If the heap is in use the chain is on its top
+            if (fHeapSize>0)
+                fHeap[0] = fHeap[--fHeapSize];
 
-            // FIXME: Maybe MTaskList should have a member function to
-            //        reorder the tasks?
-
-            // Move this task to the end of the list so that nmin still
-            // corresponds to the correct task in the list.
-            const_cast<TList*>(fTrees->GetList())->Remove(task);
-            *fLog << "." << flush;
-            const_cast<TList*>(fTrees->GetList())->AddLast(task);
             *fLog << "done." << endl;
         }
 
+        // Move the chain (or the one replacing it) to its new position
+        if (fHeapSize>0)
+            SiftDown(0);
+
         // If something else than kFALSE (means: stop reading from this
         // tree) has happened we return the return code of the processing
         if (rc!=kFALSE)
@@ -8,8 +8,12 @@
 #ifndef ROOT_TArrayL
 #include <TArrayL.h>
 #endif
+#ifndef ROOT_TArrayI
+#include <TArrayI.h>
+#endif
 
 class TChain;
+class TObjArray;
 class MTime;
 class MTaskList;
 class MReadTree;
@@ -25,17 +29,26 @@ public:
 
 private:
     MTaskList *fTrees;    // Hold the trees which are scheduled for reading
-    TList     *fChains;   // Hold TChains to read the times in advance
+    TObjArray *fChains;   // Hold TChains to read the times in advance (NULL if exhausted)
 
     TArrayL    fPosEntry; // Store the position in each tree/chain
     TArrayL    fPosTree;  // Number of Tree in file.
 
+    MTime   ***fTimes;    //! Branch addresses of the time stamps in fChains
+    TArrayI    fHeap;     //! Min-heap of the indices of the active chains ordered by time
+    Int_t      fHeapSize; //! Number of chains in fHeap (-1 if it must be rebuilt)
+    Int_t      fNumActive;//! Number of chains with further entries
+
     Bool_t     fEnableAutoScheme;
     Int_t      fNumRequired;
     //Bool_t     fFirstReInit;
 
     void    ForceRequired();
-    MTime** GetTime(TChain *c) const;
+    Bool_t  IsBefore(Int_t i, Int_t j) const;
+    void    SiftDown(Int_t pos);
+    void    BuildHeap();
+    void    RemoveChain(Int_t i);
+    void    DeleteChains();
     Int_t   FindNextTime();
     Int_t   FindNextRequired();
     Int_t   FindNext() { return fNumRequired==0 ? FindNextTime() : FindNextRequired(); }
@@ -72,7 +85,7 @@ public:
 
     MReadTree *GetReader(const char *tree) const;
 
-    ClassDef(MReadReports, 0) // Reads events and reports from a root file ordered in time
+    ClassDef(MReadReports, 1) // Reads events and reports from a root file ordered in time
 };
 
 #endif
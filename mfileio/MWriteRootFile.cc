@@ -423,6 +423,27 @@ void MWriteRootFile::AddContainer(const char *cname, const char *tname, Bool_t m
         AddToBranchList(Form("%s.%s", (const char*)AddSerialNumber(cname), tname));
 }
 
+// --------------------------------------------------------------------------
+//
+// Return whether a container with the name cname is scheduled to be
+// written (independent of the tree).
+//
+Bool_t MWriteRootFile::HasContainer(const char *cname) const
+{
+    TIter Next(&fBranches);
+    MRootFileBranch *entry=0;
+    while ((entry=(MRootFileBranch*)Next()))
+    {
+        if (TString(entry->GetContName())==cname)
+            return kTRUE;
+
+        if (entry->GetContainer() && TString(entry->GetContainer()->GetName())==cname)
+            return kTRUE;
+    }
+
+    return kFALSE;
+}
+
 // --------------------------------------------------------------------------
 //
 // Add a new Container to list of containers which should be written to the
@@ -138,6 +138,8 @@ public:
         AddCopySource(tname, NULL, force);
     }
 
+    Bool_t HasContainer(const char *cname) const;
+
     void AddTree(const char *name, Bool_t force=kTRUE)
     {
         AddContainer(Form("MReport%s", name), name, force);
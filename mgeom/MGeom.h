@@ -25,6 +25,10 @@ public:
         kBottom
     };
 
+    enum {
+        kMaxCorners = 6   // Maximum number of corners returned by GetCorners
+    };
+
 private:
     enum {
         kIsInOutermostRing = 0,
@@ -104,6 +108,7 @@ public:
 
     Int_t DistancetoPrimitive(Int_t px, Int_t py);
 
+    virtual Int_t GetCorners(Double_t *x, Double_t *y, Double_t scalexy=1, Double_t scaled=1) const = 0;
     virtual void PaintPrimitive(const TAttLine &line, const TAttFill &fill, Double_t scalexy=1, Double_t scaled=1) const = 0;
 
     ClassDef(MGeom, 1) // Geometry class describing the basics of a pixel
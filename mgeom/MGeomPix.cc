@@ -102,13 +102,12 @@ void MGeomPix::Print(Option_t *opt) const
 
 // ------------------------------------------------------------------------
 //
-// Implementation of PaintPrimitive drwaing a hexagonal pixel
+// Return the six corners of the hexagon in x and y (which must have
+// a size of at least kMaxCorners). The position is scaled by scalexy,
+// the size by scaled. Returns the number of corners.
 //
-void MGeomPix::PaintPrimitive(const TAttLine &line, const TAttFill &fill, Double_t scalexy, Double_t scaled) const
+Int_t MGeomPix::GetCorners(Double_t *x, Double_t *y, Double_t scalexy, Double_t scaled) const
 {
-    const_cast<TAttLine&>(line).Modify();  //Change line attributes only if necessary
-    const_cast<TAttFill&>(fill).Modify();  //Change fill area attributes only if necessary
-
     const Double_t fx       = fX*scalexy;
     const Double_t fy       = fY*scalexy;
     const Double_t fd       = fD*scaled;
@@ -125,24 +124,38 @@ void MGeomPix::PaintPrimitive(const TAttLine &line, const TAttFill &fill, Double
     const Double_t gsTan30c = gsTan30*c;
     const Double_t gsTan30s = gsTan30*s;
 
+    // FIXME: Do not rotate fX/fY.
+    //        Instead implement MGeomCam::Rotate or similar.
+    x[0] = fx +  gsCos60c-gsSin60s;
+    x[1] = fx -  gsTan30s;
+    x[2] = fx + -gsCos60c-gsSin60s;
+    x[3] = fx + -gsCos60c+gsSin60s;
+    x[4] = fx +  gsTan30s;
+    x[5] = fx +  gsCos60c+gsSin60s;
+
+    y[0] = fy +  gsCos60s+gsSin60c;
+    y[1] = fy +  gsTan30c;
+    y[2] = fy + -gsCos60s+gsSin60c;
+    y[3] = fy + -gsCos60s-gsSin60c;
+    y[4] = fy -  gsTan30c;
+    y[5] = fy +  gsCos60s-gsSin60c;
+
+    return 6;
+}
 
-    Double_t x[7] = {
-         gsCos60c-gsSin60s,  -gsTan30s,  -gsCos60c-gsSin60s,
-        -gsCos60c+gsSin60s,   gsTan30s,   gsCos60c+gsSin60s
-    };
+// ------------------------------------------------------------------------
+//
+// Implementation of PaintPrimitive drwaing a hexagonal pixel
+//
+void MGeomPix::PaintPrimitive(const TAttLine &line, const TAttFill &fill, Double_t scalexy, Double_t scaled) const
+{
+    const_cast<TAttLine&>(line).Modify();  //Change line attributes only if necessary
+    const_cast<TAttFill&>(fill).Modify();  //Change fill area attributes only if necessary
 
-    Double_t y[7] = {
-         gsCos60s+gsSin60c,   gsTan30c,  -gsCos60s+gsSin60c,
-        -gsCos60s-gsSin60c,  -gsTan30c,   gsCos60s-gsSin60c,
-    };
+    Double_t x[7];
+    Double_t y[7];
 
-    for (Int_t i=0; i<6; i++)
-    {
-        // FIXME: Do not rotate fX/fY.
-        //        Instead implement MGeomCam::Rotate or similar.
-        x[i] += fx;
-        y[i] += fy;
-    }
+    GetCorners(x, y, scalexy, scaled);
 
     x[6] = x[0];
     y[6] = y[0];
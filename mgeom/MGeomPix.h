@@ -59,6 +59,7 @@ public:
 
     // Helper
     Bool_t  IsInside(Float_t px, Float_t py) const;
+    Int_t   GetCorners(Double_t *x, Double_t *y, Double_t scalexy=1, Double_t scaled=1) const;
     void    PaintPrimitive(const TAttLine &line, const TAttFill &fill, Double_t scalexy=1, Double_t scaled=1) const;
 
     ClassDef(MGeomPix, 5) // Geometry class describing the geometry of one pixel
@@ -70,6 +70,27 @@ Bool_t MGeomRectangle::IsInside(Float_t px, Float_t py) const
     return kTRUE;
 }
 
+// ------------------------------------------------------------------------
+//
+// Return the four corners of the rectangle in x and y (which must have
+// a size of at least kMaxCorners). The position is scaled by scalexy,
+// the size by scaled. Returns the number of corners.
+//
+Int_t MGeomRectangle::GetCorners(Double_t *x, Double_t *y, Double_t scalexy, Double_t scaled) const
+{
+    const Double_t w  = fW*scaled/2;
+    const Double_t h  = fH*scaled/2;
+    const Double_t cx = fX*scalexy;
+    const Double_t cy = fY*scalexy;
+
+    x[0] = cx-w; y[0] = cy-h;
+    x[1] = cx+w; y[1] = cy-h;
+    x[2] = cx+w; y[2] = cy+h;
+    x[3] = cx-w; y[3] = cy+h;
+
+    return 4;
+}
+
 // ------------------------------------------------------------------------
 //
 // Implementation of PaintPrimitive drwaing a rectangular pixel
@@ -33,6 +33,7 @@ public:
     Float_t GetL() const;
 
     Bool_t  IsInside(Float_t px, Float_t py) const;
+    Int_t   GetCorners(Double_t *x, Double_t *y, Double_t scalexy=1, Double_t scaled=1) const;
     void    PaintPrimitive(const TAttLine &line, const TAttFill &fill, Double_t scalexy=1, Double_t scaled=1) const;
 
     void Print(Option_t *opt=NULL) const;
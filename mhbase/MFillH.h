@@ -67,6 +67,8 @@ public:
     void SetWeight(MParameterD *w)   { fWeight = w; }
     void SetWeight(const char *name="MWeight") { fWeightName = name; }
 
+    const TString &GetParContainerName() const { return fParContainerName; }
+
     void      SetDrawOption(Option_t *option="");
     Option_t *GetDrawOption() const { return fDrawOption; }
 
@@ -5,6 +5,7 @@
 #pragma link off all functions;
 
 #pragma link C++ class MHCalibrationCam+;
+#pragma link C++ class MHCalibrationFlat+;
 #pragma link C++ class MHCalibrationPix+;
 #pragma link C++ class MHCalibrationChargeCam+;
 #pragma link C++ class MHCalibrationChargePix+;
@@ -51,6 +51,15 @@
 // The flag kLoGain steers if the low-gain signal is treated at all or not.
 // The flag kAverageing steers if the event-by-event averages are treated at all.
 //
+// With SetFlatFill() the pixel histograms are not filled event-by-event.
+// Instead a derived class fills fFlatHiGain and fFlatLoGain (see
+// MHCalibrationFlat). In Finalize() their contents are copied into the
+// pixel histograms (for display and the checks for empty histograms)
+// and all pixels are fitted in closed form, distributed over fNumThreads
+// threads (SetNumThreads(), <=0: number of cores). The averaged areas and
+// sectors are filled and fitted as usual. If fit ranges are given, the
+// standard fit is used for all histograms.
+//
 // Class Version 5:
 //  + Double_t fLowerFitLimitHiGain;          // Lower limit for the fit range for the hi-gain hist
 //  + Double_t fUpperFitLimitHiGain;          // Upper limit for the fit range for the hi-gain hist
@@ -59,13 +68,17 @@
 //  + Bool_t   fIsHiGainFitRanges;            // Are high-gain fit ranges defined?
 //  + Bool_t   fIsLoGainFitRanges;            // Are low-gain fit ranges defined?
 //
-// Class Version 5:
+// Class Version 6:
 //  + Int_t   fMaxNumEvts;                    // Max Number of events
 //
+// Class Version 7:
+//  + Int_t   fNumThreads;                    // Number of threads for the fits in flat-fill mode
+//
 /////////////////////////////////////////////////////////////////////////////
 #include "MHCalibrationCam.h"
 #include "MHCalibrationPix.h"
 
+#include <TH1.h>
 #include <TVirtualPad.h>
 #include <TCanvas.h>
 #include <TPad.h>
@@ -136,6 +149,8 @@ const TString MHCalibrationCam::gsHistYTitle = "Nr. events";
 //-  SetUpperFitLimitHiGain();
 //-  SetLowerFitLimitLoGain();
 //-  SetUpperFitLimitLoGain();
+//-  SetFlatFill    (kFALSE);
+//-  SetNumThreads  ();
 //
 MHCalibrationCam::MHCalibrationCam(const char *name, const char *title)
     :  fIsHiGainFitRanges(kFALSE), fIsLoGainFitRanges(kFALSE),
@@ -175,6 +190,8 @@ MHCalibrationCam::MHCalibrationCam(const char *name, const char *title)
     SetOscillations(kTRUE);
     SetSizeCheck   (kTRUE);
     SetIsReset     (kTRUE);
+    SetFlatFill    (kFALSE);
+    SetNumThreads  ();
 
     SetLowerFitLimitHiGain();
     SetUpperFitLimitHiGain();
@@ -398,6 +415,9 @@ void MHCalibrationCam::ResetHists()
   
   ResetHistTitles();
 
+  fFlatHiGain.Reset();
+  fFlatLoGain.Reset();
+
   if (fHiGainArray)
     { fHiGainArray->R__FOR_EACH(MHCalibrationPix,Reset)();  }
 
@@ -662,6 +682,8 @@ Bool_t MHCalibrationCam::ReInit(MParList *pList)
   if (!ReInitHists(pList))
     return kFALSE;
 
+  InitFlatArrays();
+
   ResetHistTitles();
 
   if (!fRunHeader)
@@ -1009,6 +1031,8 @@ Bool_t MHCalibrationCam::Finalize()
         }
     }
   
+  FinalizeFlatArrays();
+
   if (!FinalizeHists())
     return kFALSE;
 
@@ -1019,6 +1043,78 @@ Bool_t MHCalibrationCam::Finalize()
   return kTRUE;
 }
 
+// --------------------------------------------------------------------------
+//
+// In flat-fill mode initialize fFlatHiGain and fFlatLoGain with the
+// binning of the first pixel histogram, if the number of pixels has
+// changed. The contents are kept otherwise (as for the histograms).
+//
+void MHCalibrationCam::InitFlatArrays()
+{
+  if (!IsFlatFill())
+    return;
+
+  const Int_t npix = fHiGainArray->GetSize();
+  if (npix>0 && fFlatHiGain.GetNumPixels()!=(UInt_t)npix)
+    {
+      const TH1F *h = (*this)[0].GetHGausHist();
+      fFlatHiGain.Init(npix, h->GetNbinsX(), h->GetXaxis()->GetXmin(), h->GetXaxis()->GetXmax());
+    }
+
+  const Int_t nlo = IsLoGain() ? fLoGainArray->GetSize() : 0;
+  if (nlo>0 && fFlatLoGain.GetNumPixels()!=(UInt_t)nlo)
+    {
+      const TH1F *h = (*this)(0).GetHGausHist();
+      fFlatLoGain.Init(nlo, h->GetNbinsX(), h->GetXaxis()->GetXmin(), h->GetXaxis()->GetXmax());
+    }
+}
+
+// --------------------------------------------------------------------------
+//
+// In flat-fill mode copy the contents of fFlatHiGain and fFlatLoGain
+// into the pixel histograms and fit all pixels (see MHCalibrationFlat::FitAll)
+//
+void MHCalibrationCam::FinalizeFlatArrays()
+{
+  if (!IsFlatFill())
+    return;
+
+  if (fFlatHiGain.IsFilled())
+    {
+      for (Int_t i=0; i<fHiGainArray->GetSize(); i++)
+        fFlatHiGain.CopyTo(i, *(*this)[i].GetHGausHist());
+
+      if (fHiGainArray->GetSize()>0)
+        fFlatHiGain.FitAll((*this)[0].GetProbLimit(), (*this)[0].GetNDFLimit(), fNumThreads);
+    }
+
+  if (IsLoGain() && fFlatLoGain.IsFilled())
+    {
+      for (Int_t i=0; i<fLoGainArray->GetSize(); i++)
+        fFlatLoGain.CopyTo(i, *(*this)(i).GetHGausHist());
+
+      if (fLoGainArray->GetSize()>0)
+        fFlatLoGain.FitAll((*this)(0).GetProbLimit(), (*this)(0).GetNDFLimit(), fNumThreads);
+    }
+}
+
+// --------------------------------------------------------------------------
+//
+// Copy the result of the closed-form fit of pixel i in flat into hist.
+// Returns whether the fit was accepted.
+//
+Bool_t MHCalibrationCam::FitFlat(MHCalibrationPix &hist, const MHCalibrationFlat &flat, const Int_t i) const
+{
+  hist.SetMean    (flat.GetMean(i));
+  hist.SetMeanErr (flat.GetMeanErr(i));
+  hist.SetSigma   (flat.GetSigma(i));
+  hist.SetSigmaErr(flat.GetSigmaErr(i));
+  hist.SetProb    (flat.GetProb(i));
+  hist.SetGausFitOK(flat.IsFitOK(i));
+
+  return flat.IsFitOK(i);
+}
+
 // -------------------------------------------------------------
 //
 // If MBadPixelsPix::IsUnsuitable(MBadPixelsPix::kUnsuitableRun):
@@ -1077,6 +1173,8 @@ void MHCalibrationCam::FitHiGainArrays(MCalibrationCam &calcam, MBadPixelsCam &b
 {
   fIsHiGainFitRanges = TMath::Abs(fUpperFitLimitHiGain - fLowerFitLimitHiGain) > 1E-5;
 
+  const Bool_t flat = IsFlatFill() && fFlatHiGain.IsFilled() && !fIsHiGainFitRanges;
+
   for (Int_t i=0; i<fHiGainArray->GetSize(); i++)
     {
       
@@ -1088,7 +1186,7 @@ void MHCalibrationCam::FitHiGainArrays(MCalibrationCam &calcam, MBadPixelsCam &b
       MCalibrationPix &pix    = calcam[i];
       MBadPixelsPix   &bad    = badcam[i];
       
-      FitHiGainHists(hist,pix,bad,fittyp,osctyp);
+      FitHiGainHists(hist,pix,bad,fittyp,osctyp,flat?i:-1);
     }
 
   if (!IsAverageing())
@@ -1130,6 +1228,8 @@ void MHCalibrationCam::FitLoGainArrays(MCalibrationCam &calcam, MBadPixelsCam &b
   if (!IsLoGain())
     return;
 
+  const Bool_t flat = IsFlatFill() && fFlatLoGain.IsFilled() && !fIsLoGainFitRanges;
+
   for (Int_t i=0; i<fLoGainArray->GetSize(); i++)
     {
       
@@ -1141,7 +1241,7 @@ void MHCalibrationCam::FitLoGainArrays(MCalibrationCam &calcam, MBadPixelsCam &b
       MCalibrationPix &pix    = calcam[i];
       MBadPixelsPix   &bad    = badcam[i];
       
-      FitLoGainHists(hist,pix,bad,fittyp,osctyp);
+      FitLoGainHists(hist,pix,bad,fittyp,osctyp,flat?i:-1);
       
     }
 
@@ -1233,7 +1333,8 @@ void MHCalibrationCam::FitHiGainHists(MHCalibrationPix &hist,
                                       MCalibrationPix &pix, 
                                       MBadPixelsPix &bad, 
                                       MBadPixelsPix::UncalibratedType_t fittyp,
-                                      MBadPixelsPix::UncalibratedType_t osctyp)
+                                      MBadPixelsPix::UncalibratedType_t osctyp,
+                                      const Int_t flatidx)
 {
   if (hist.IsEmpty())
   {
@@ -1256,7 +1357,17 @@ void MHCalibrationCam::FitHiGainHists(MHCalibrationPix &hist,
 
   //
   // 2) Fit the Hi Gain histograms with a Gaussian
+  //    (in flat-fill mode the closed-form fit has already been done)
   //
+  if (flatidx>=0)
+  {
+      if (!FitFlat(hist, fFlatHiGain, flatidx))
+      {
+          hist.BypassFit();
+          bad.SetUncalibrated( fittyp );
+      }
+  }
+  else
   if (fIsHiGainFitRanges)
   {
       if (!hist.FitGaus("R",fLowerFitLimitHiGain,fUpperFitLimitHiGain))
@@ -1337,7 +1448,8 @@ void MHCalibrationCam::FitLoGainHists(MHCalibrationPix &hist,
                                       MCalibrationPix &pix, 
                                       MBadPixelsPix &bad, 
                                       MBadPixelsPix::UncalibratedType_t fittyp,
-                                      MBadPixelsPix::UncalibratedType_t osctyp)
+                                      MBadPixelsPix::UncalibratedType_t osctyp,
+                                      const Int_t flatidx)
 {
 
   if (hist.IsEmpty())
@@ -1361,7 +1473,18 @@ void MHCalibrationCam::FitLoGainHists(MHCalibrationPix &hist,
 
   //
   // 2) Fit the Hi Gain histograms with a Gaussian
+  //    (in flat-fill mode the closed-form fit has already been done)
   //
+  if (flatidx>=0)
+  {
+      if (!FitFlat(hist, fFlatLoGain, flatidx))
+      {
+          hist.BypassFit();
+          if (pix.IsHiGainSaturation())
+              bad.SetUncalibrated( fittyp );
+      }
+  }
+  else
   if (fIsLoGainFitRanges)
   {
       if (!hist.FitGaus("R",fLowerFitLimitLoGain,fUpperFitLimitLoGain))
@@ -1506,6 +1629,8 @@ void MHCalibrationCam::DrawAverageSigma(Bool_t sat, Bool_t inner,
 //  Oscillations
 //  SizeCheck
 //  Averageing
+//  FlatFill
+//  NumThreads
 //  Nbins
 //  First
 //  Last
@@ -1546,6 +1671,16 @@ Int_t MHCalibrationCam::ReadEnv(const TEnv &env, TString prefix, Bool_t print)
       SetAverageing(GetEnvValue(env, prefix, "Averageing", IsAverageing()));
       rc = kTRUE;
     }
+  if (IsEnvDefined(env, prefix, "FlatFill", print))
+    {
+      SetFlatFill(GetEnvValue(env, prefix, "FlatFill", IsFlatFill()));
+      rc = kTRUE;
+    }
+  if (IsEnvDefined(env, prefix, "NumThreads", print))
+    {
+      SetNumThreads(GetEnvValue(env, prefix, "NumThreads", fNumThreads));
+      rc = kTRUE;
+    }
   
   if (IsEnvDefined(env, prefix, "Nbins", print))
     {
@@ -22,6 +22,10 @@
 #include "MCalibrationCam.h"
 #endif
 
+#ifndef MARS_MHCalibrationFlat
+#include "MHCalibrationFlat.h"
+#endif
+
 class TText;
 class TOrdCollection;
 
@@ -107,13 +111,19 @@ protected:
 
   Int_t  fPulserFrequency;                // Light pulser frequency
 
+  Int_t  fNumThreads;                     // Number of threads for the fits in flat-fill mode (<=0: number of cores)
+
+  MHCalibrationFlat fFlatHiGain;          //! Flat hi-gain histograms of all pixels (flat-fill mode)
+  MHCalibrationFlat fFlatLoGain;          //! Flat lo-gain histograms of all pixels (flat-fill mode)
+
   enum {
       kDebug,
       kLoGain,
       kAverageing,
       kOscillations,
       kSizeCheck,
-      kIsReset
+      kIsReset,
+      kFlatFill
   };     // Possible global flags
    
   Byte_t  fFlags;                         // Bit-field to hold the global flags
@@ -144,7 +154,8 @@ protected:
                          MCalibrationPix &pix, 
                          MBadPixelsPix &bad, 
                          MBadPixelsPix::UncalibratedType_t fittyp,
-                         MBadPixelsPix::UncalibratedType_t osctyp);
+                         MBadPixelsPix::UncalibratedType_t osctyp,
+                         const Int_t flatidx=-1);
   
   void FitLoGainArrays ( MCalibrationCam &calcam, MBadPixelsCam &badcam,
                          MBadPixelsPix::UncalibratedType_t fittyp,
@@ -154,9 +165,13 @@ protected:
                          MCalibrationPix &pix, 
                          MBadPixelsPix &bad, 
                          MBadPixelsPix::UncalibratedType_t fittyp,
-                         MBadPixelsPix::UncalibratedType_t osctyp);
+                         MBadPixelsPix::UncalibratedType_t osctyp,
+                         const Int_t flatidx=-1);
 
   void   InitHists     ( MHCalibrationPix &hist, MBadPixelsPix &bad, const Int_t i);
+  void   InitFlatArrays();
+  void   FinalizeFlatArrays();
+  Bool_t FitFlat       ( MHCalibrationPix &hist, const MHCalibrationFlat &flat, const Int_t i) const;
   Bool_t InitCams      ( MParList *plist, const TString name );
   
   Bool_t IsLoGain() const;
@@ -165,6 +180,7 @@ protected:
   Bool_t IsOscillations() const  { return TESTBIT(fFlags,kOscillations); }
   Bool_t IsSizeCheck   () const  { return TESTBIT(fFlags,kSizeCheck);    }
   Bool_t IsReset       () const  { return TESTBIT(fFlags,kIsReset);      }
+  Bool_t IsFlatFill    () const  { return TESTBIT(fFlags,kFlatFill);     }
 
   void ToggleFlag(Bool_t b, Byte_t flag) { b ? SETBIT(fFlags, flag) : CLRBIT(fFlags,flag); }
 
@@ -221,6 +237,8 @@ public:
   void SetOscillations(const Bool_t b=kTRUE) { ToggleFlag(b,kOscillations); }
   void SetSizeCheck(const Bool_t b=kTRUE)    { ToggleFlag(b,kSizeCheck); }
   void SetIsReset(const Bool_t b=kTRUE)      { ToggleFlag(b,kIsReset); }
+  void SetFlatFill(const Bool_t b=kTRUE)     { ToggleFlag(b,kFlatFill); }
+  void SetNumThreads(const Int_t n=0)        { fNumThreads = n; }
 
   void SetHistName  ( const char *name )  { fHistName  = name;  }
   void SetHistTitle ( const char *name )  { fHistTitle = name;  }
@@ -243,7 +261,7 @@ public:
   void SetOverflowLimit        ( const Float_t f=fgOverflowLimit ) { fOverflowLimit = f; }
   void SetPulserFrequency      ( const Int_t   i=fgPulserFrequency )   { fPulserFrequency  = i; }
   
-  ClassDef(MHCalibrationCam, 6)	// Base Histogram class for Calibration Camera
+  ClassDef(MHCalibrationCam, 7)	// Base Histogram class for Calibration Camera
 };
 
 #endif
@@ -631,7 +631,8 @@ void MHCalibrationChargeCam::InitLoGainArrays(const Int_t npixels, const Int_t n
 //
 // For all TOrdCollection's (including the averaged ones), the following steps are performed: 
 //
-// 1) Fill Charges histograms (MHGausEvents::FillHistAndArray()) with:
+// 1) Fill Charges histograms (MHGausEvents::FillHistAndArray()) with
+//    (in flat-fill mode the pixels are filled into fFlatHiGain/fFlatLoGain):
 // - MExtractedSignalPix::GetExtractedSignalHiGain();
 // - MExtractedSignalPix::GetExtractedSignalLoGain();
 //
@@ -698,10 +699,17 @@ Bool_t MHCalibrationChargeCam::FillHists(const MParContainer *par, const Stat_t
       if (pix.IsHiGainValid())
       {
           const Float_t sumhi = pix.GetExtractedSignalHiGain();
-          if (IsOscillations())
-              histhi.FillHistAndArray(sumhi);
+          if (IsFlatFill())
+          {
+              fFlatHiGain.Fill(i, sumhi);
+              if (IsOscillations())
+                  histhi.FillArray(sumhi);
+          }
           else
-              histhi.FillHist(sumhi);
+              if (IsOscillations())
+                  histhi.FillHistAndArray(sumhi);
+              else
+                  histhi.FillHist(sumhi);
 
           fSumhiarea[aidx]     += sumhi;
           fSumhisector[sector] += sumhi;
@@ -730,10 +738,17 @@ Bool_t MHCalibrationChargeCam::FillHists(const MParContainer *par, const Stat_t
       {
           const Float_t sumlo = pix.GetExtractedSignalLoGain();
 
-          if (IsOscillations())
-              histlo.FillHistAndArray(sumlo);
+          if (IsFlatFill())
+          {
+              fFlatLoGain.Fill(i, sumlo);
+              if (IsOscillations())
+                  histlo.FillArray(sumlo);
+          }
           else
-              histlo.FillHist(sumlo);
+              if (IsOscillations())
+                  histlo.FillHistAndArray(sumlo);
+              else
+                  histlo.FillHist(sumlo);
 
           fSumloarea[aidx]     += sumlo;
           fSumlosector[sector] += sumlo;
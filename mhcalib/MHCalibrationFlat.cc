@@ -0,0 +1,321 @@
+/* ======================================================================== *\
+!
+! *
+! * This file is part of MARS, the MAGIC Analysis and Reconstruction
+! * Software. It is distributed to you in the hope that it can be a useful
+! * and timesaving tool in analysing Data of imaging Cerenkov telescopes.
+! * It is distributed WITHOUT ANY WARRANTY.
+! *
+! * Permission to use, copy, modify and distribute this software and its
+! * documentation for any purpose is hereby granted without fee,
+! * provided that the above copyright notice appear in all copies and
+! * that both that copyright notice and this permission notice appear
+! * in supporting documentation. It is provided "as is" without express
+! * or implied warranty.
+! *
+!
+!
+!   Copyright: MAGIC Software Development, 2000-2026
+!
+!
+\* ======================================================================== */
+
+//////////////////////////////////////////////////////////////////////////////
+//
+//  MHCalibrationFlat
+//
+//  Histograms of all pixels of a camera with identical binning stored
+//  in one flat array of integer counts (pixel by bin, including under-
+//  and overflow bins) together with the moments of the values inside the
+//  histogram range.
+//
+//  Filling is a single increment in a contiguous array, the memory
+//  consumption is independent of the number of events.
+//
+//  The distributions are fitted with a Gaussian in closed form: The
+//  moments inside a window of +/-3 sigma around the current estimate are
+//  calculated from the binned counts and corrected for the truncation
+//  (truncated normal distribution). This is iterated until mean and sigma
+//  converge. The probability is calculated from the chi-square of the
+//  result w.r.t. the non-empty bins in the window (as for a chi-square
+//  fit of a histogram). Since the fits of the pixels are independent
+//  FitAll() distributes them over several threads.
+//
+//  The counts and moments can be copied into a histogram with CopyTo(),
+//  e.g. for display or to use the standard (TH1-based) fit.
+//
+//  See also: MHCalibrationCam
+//
+//////////////////////////////////////////////////////////////////////////////
+#include "MHCalibrationFlat.h"
+
+#include <thread>
+#include <vector>
+
+#include <TH1.h>
+#include <TMath.h>
+
+ClassImp(MHCalibrationFlat);
+
+using namespace std;
+
+// --------------------------------------------------------------------------
+//
+// Default constructor.
+//
+MHCalibrationFlat::MHCalibrationFlat()
+    : fNbins(0), fFirst(0), fLast(0), fScale(0), fNumPixels(0), fNumEntries(0)
+{
+}
+
+// --------------------------------------------------------------------------
+//
+// Initialize the arrays for npix pixels with nbins bins between first
+// and last and reset their contents.
+//
+void MHCalibrationFlat::Init(UInt_t npix, Int_t nbins, Axis_t first, Axis_t last)
+{
+    fNumPixels = npix;
+    fNbins     = nbins;
+    fFirst     = first;
+    fLast      = last;
+    fScale     = last>first ? nbins/(last-first) : 0;
+
+    fCounts.Set(npix*(nbins+2));
+
+    fSumw.Set(npix);
+    fSumx.Set(npix);
+    fSumx2.Set(npix);
+
+    fMean.Set(npix);
+    fMeanErr.Set(npix);
+    fSigma.Set(npix);
+    fSigmaErr.Set(npix);
+    fProb.Set(npix);
+    fFitOK.Set(npix);
+
+    Reset();
+}
+
+// --------------------------------------------------------------------------
+//
+// Reset all counts, moments and fit results
+//
+void MHCalibrationFlat::Reset()
+{
+    fNumEntries = 0;
+
+    fCounts.Reset();
+
+    fSumw.Reset();
+    fSumx.Reset();
+    fSumx2.Reset();
+
+    fMean.Reset();
+    fMeanErr.Reset();
+    fSigma.Reset();
+    fSigmaErr.Reset();
+    fProb.Reset();
+    fFitOK.Reset();
+}
+
+// --------------------------------------------------------------------------
+//
+// Copy the counts (including under- and overflow) and the moments of
+// pixel idx into the histogram h. The histogram must have the same
+// binning.
+//
+void MHCalibrationFlat::CopyTo(UInt_t idx, TH1 &h) const
+{
+    if (h.GetNbinsX()!=fNbins || idx>=fNumPixels)
+        return;
+
+    h.Reset();
+
+    const Int_t *cnt = fCounts.GetArray()+idx*(fNbins+2);
+
+    Double_t entries = 0;
+    for (Int_t i=0; i<fNbins+2; i++)
+    {
+        h.SetBinContent(i, cnt[i]);
+        entries += cnt[i];
+    }
+
+    // sumw, sumw2, sumwx, sumwx2 (all weights are 1)
+    Double_t stats[4] = { fSumw[idx], fSumw[idx], fSumx[idx], fSumx2[idx] };
+    h.PutStats(stats);
+
+    h.SetEntries(entries);
+}
+
+// --------------------------------------------------------------------------
+//
+// Fit the distribution of pixel idx with a Gaussian in closed form
+// (see class description). The fit is accepted if the results are finite,
+// the number of degrees of freedom is not smaller than ndflim and the
+// probability is not smaller than problim.
+//
+// Returns whether the fit was accepted. The results are available from
+// GetMean(), GetMeanErr(), GetSigma(), GetSigmaErr() and GetProb().
+//
+Bool_t MHCalibrationFlat::Fit(UInt_t idx, Float_t problim, Int_t ndflim)
+{
+    fMean[idx]     = 0;
+    fMeanErr[idx]  = 0;
+    fSigma[idx]    = 0;
+    fSigmaErr[idx] = 0;
+    fProb[idx]     = 0;
+    fFitOK[idx]    = kFALSE;
+
+    const Double_t n = fSumw[idx];
+    if (n<2 || fScale<=0)
+        return kFALSE;
+
+    const Int_t   *cnt = fCounts.GetArray()+idx*(fNbins+2);
+    const Double_t w   = 1./fScale;
+
+    // Start values from the moments of all entries in range
+    Double_t mean  = fSumx[idx]/n;
+    Double_t var   = fSumx2[idx]/n - mean*mean;
+    if (var<=0)
+        return kFALSE;
+
+    Double_t sigma = TMath::Sqrt(var);
+    Double_t ntot  = n;
+
+    Int_t b0 = 1;
+    Int_t b1 = fNbins;
+
+    for (Int_t it=0; it<20; it++)
+    {
+        // Window of +/- 3 sigma (in bins)
+        b0 = TMath::Max(1,      1+TMath::FloorNint((mean-3*sigma-fFirst)*fScale));
+        b1 = TMath::Min(fNbins, 1+TMath::FloorNint((mean+3*sigma-fFirst)*fScale));
+        if (b1<b0)
+            return kFALSE;
+
+        Double_t s0 = 0;
+        Double_t s1 = 0;
+        Double_t s2 = 0;
+        for (Int_t b=b0; b<=b1; b++)
+        {
+            const Double_t x = fFirst+(b-0.5)*w;
+            s0 += cnt[b];
+            s1 += cnt[b]*x;
+            s2 += cnt[b]*x*x;
+        }
+        if (s0<2)
+            return kFALSE;
+
+        // Moments of the binned data inside the window (Sheppard's correction)
+        const Double_t mt = s1/s0;
+        const Double_t vt = s2/s0 - mt*mt - w*w/12;
+        if (vt<=0)
+            return kFALSE;
+
+        // Truncation of a normal distribution at the edges of the window
+        const Double_t a = (fFirst+(b0-1)*w - mean)/sigma;
+        const Double_t b = (fFirst+ b1   *w - mean)/sigma;
+
+        const Double_t pa = TMath::Gaus(a, 0, 1, kTRUE);
+        const Double_t pb = TMath::Gaus(b, 0, 1, kTRUE);
+        const Double_t p  = TMath::Freq(b) - TMath::Freq(a);
+        if (p<=0)
+            return kFALSE;
+
+        const Double_t d  = (pa-pb)/p;
+        const Double_t f  = 1 + (a*pa-b*pb)/p - d*d;
+        if (f<=0)
+            return kFALSE;
+
+        const Double_t s = TMath::Sqrt(vt/f);
+        const Double_t m = mt - s*d;
+
+        ntot = s0/p;
+
+        const Bool_t conv = TMath::Abs(m-mean)<1e-4*s && TMath::Abs(s-sigma)<1e-4*s;
+
+        mean  = m;
+        sigma = s;
+
+        if (conv)
+            break;
+    }
+
+    // Chi-square w.r.t. the non-empty bins in the window
+    Double_t chi2 = 0;
+    Int_t    nbins = 0;
+    for (Int_t b=b0; b<=b1; b++)
+    {
+        if (cnt[b]==0)
+            continue;
+
+        const Double_t lo = (fFirst+(b-1)*w - mean)/sigma;
+        const Double_t hi = (fFirst+ b   *w - mean)/sigma;
+
+        const Double_t e = ntot*(TMath::Freq(hi)-TMath::Freq(lo));
+
+        chi2 += (cnt[b]-e)*(cnt[b]-e)/cnt[b];
+        nbins++;
+    }
+
+    const Int_t ndf = nbins-3;
+
+    fMean[idx]     = mean;
+    fSigma[idx]    = sigma;
+    fMeanErr[idx]  = sigma/TMath::Sqrt(ntot);
+    fSigmaErr[idx] = sigma/TMath::Sqrt(2*ntot);
+    fProb[idx]     = ndf>0 ? TMath::Prob(chi2, ndf) : 0;
+
+    if (!TMath::Finite(fMean[idx])    || !TMath::Finite(fSigma[idx]) ||
+        !TMath::Finite(fMeanErr[idx]) || !TMath::Finite(fSigmaErr[idx]) ||
+        !TMath::Finite(fProb[idx]))
+        return kFALSE;
+
+    if (ndf<ndflim || fProb[idx]<problim)
+        return kFALSE;
+
+    fFitOK[idx] = kTRUE;
+    return kTRUE;
+}
+
+// --------------------------------------------------------------------------
+//
+// Fit the pixels [first, last)
+//
+void MHCalibrationFlat::FitRange(UInt_t first, UInt_t last, Float_t problim, Int_t ndflim)
+{
+    for (UInt_t idx=first; idx<last; idx++)
+        Fit(idx, problim, ndflim);
+}
+
+// --------------------------------------------------------------------------
+//
+// Fit all pixels. The pixels are distributed in contiguous blocks over
+// nthreads threads. If nthreads<=0 the number of cores is used.
+//
+void MHCalibrationFlat::FitAll(Float_t problim, Int_t ndflim, Int_t nthreads)
+{
+    if (nthreads<=0)
+        nthreads = thread::hardware_concurrency();
+
+    if ((UInt_t)nthreads>fNumPixels)
+        nthreads = fNumPixels;
+
+    if (nthreads<=1)
+    {
+        FitRange(0, fNumPixels, problim, ndflim);
+        return;
+    }
+
+    const UInt_t step = (fNumPixels+nthreads-1)/nthreads;
+
+    vector<thread> threads;
+    for (UInt_t first=0; first<fNumPixels; first+=step)
+        threads.push_back(thread(&MHCalibrationFlat::FitRange, this,
+                                 first, TMath::Min(first+step, fNumPixels),
+                                 problim, ndflim));
+
+    for (auto it=threads.begin(); it!=threads.end(); it++)
+        it->join();
+}
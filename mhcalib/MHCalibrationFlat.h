@@ -0,0 +1,90 @@
+#ifndef MARS_MHCalibrationFlat
+#define MARS_MHCalibrationFlat
+
+#ifndef ROOT_TObject
+#include <TObject.h>
+#endif
+#ifndef ROOT_TMath
+#include <TMath.h>
+#endif
+
+#ifndef MARS_MArrayI
+#include "MArrayI.h"
+#endif
+#ifndef MARS_MArrayD
+#include "MArrayD.h"
+#endif
+#ifndef MARS_MArrayB
+#include "MArrayB.h"
+#endif
+
+class TH1;
+
+class MHCalibrationFlat : public TObject
+{
+private:
+    Int_t    fNbins;       // Number of bins (w/o under- and overflow)
+    Axis_t   fFirst;       // Lower edge of the first bin
+    Axis_t   fLast;        // Upper edge of the last bin
+    Double_t fScale;       // Number of bins per unit (fNbins/(fLast-fFirst))
+
+    UInt_t   fNumPixels;   // Number of pixels
+    UInt_t   fNumEntries;  // Total number of entries (all pixels)
+
+    MArrayI  fCounts;      // Counts [idx*(fNbins+2)+bin] (bin 0: underflow, fNbins+1: overflow)
+    MArrayD  fSumw;        // Number of entries in range per pixel
+    MArrayD  fSumx;        // Sum of values in range per pixel
+    MArrayD  fSumx2;       // Sum of squared values in range per pixel
+
+    MArrayD  fMean;        // Fit result: mean
+    MArrayD  fMeanErr;     // Fit result: error of mean
+    MArrayD  fSigma;       // Fit result: sigma
+    MArrayD  fSigmaErr;    // Fit result: error of sigma
+    MArrayD  fProb;        // Fit result: probability
+    MArrayB  fFitOK;       // Fit result accepted
+
+    void FitRange(UInt_t first, UInt_t last, Float_t problim, Int_t ndflim);
+
+public:
+    MHCalibrationFlat();
+
+    void Init(UInt_t npix, Int_t nbins, Axis_t first, Axis_t last);
+    void Reset();
+
+    UInt_t GetNumPixels() const  { return fNumPixels; }
+    UInt_t GetNumEntries() const { return fNumEntries; }
+    Bool_t IsFilled() const      { return fNumEntries>0; }
+
+    void Fill(UInt_t idx, Double_t x)
+    {
+        // NaN fails all comparisons and ends up in the underflow bin.
+        // Rounding must not move values just below fLast into overflow.
+        const Int_t bin = !(x>=fFirst) ? 0 : (x>=fLast ? fNbins+1 : 1+TMath::Min(fNbins-1, Int_t((x-fFirst)*fScale)));
+
+        fCounts[idx*(fNbins+2)+bin]++;
+        fNumEntries++;
+
+        if (bin==0 || bin==fNbins+1)
+            return;
+
+        fSumw[idx]  += 1;
+        fSumx[idx]  += x;
+        fSumx2[idx] += x*x;
+    }
+
+    void CopyTo(UInt_t idx, TH1 &h) const;
+
+    Bool_t Fit(UInt_t idx, Float_t problim, Int_t ndflim);
+    void   FitAll(Float_t problim, Int_t ndflim, Int_t nthreads=0);
+
+    Double_t GetMean(UInt_t idx) const     { return fMean[idx];     }
+    Double_t GetMeanErr(UInt_t idx) const  { return fMeanErr[idx];  }
+    Double_t GetSigma(UInt_t idx) const    { return fSigma[idx];    }
+    Double_t GetSigmaErr(UInt_t idx) const { return fSigmaErr[idx]; }
+    Double_t GetProb(UInt_t idx) const     { return fProb[idx];     }
+    Bool_t   IsFitOK(UInt_t idx) const     { return fFitOK[idx];    }
+
+    ClassDef(MHCalibrationFlat, 0) // Flat pixel-by-bin histogram array with closed-form Gauss fits
+};
+
+#endif
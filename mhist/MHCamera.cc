@@ -44,6 +44,13 @@
 //
 // Be carefull: Entries in this context means Entries/bin or Events
 //
+// The polygons of the pixels are calculated once and cached (unless the
+// "box" option is used), only the colors are updated when the camera is
+// painted. The pixels are painted grouped by their color, so that the
+// fill attributes change only once per color. When painting into an
+// image file in batch mode (TImageDump, e.g. MStatusDisplay::SaveAsPNG)
+// the pixels are rasterized directly into the image buffer.
+//
 // FIXME? Maybe MHCamera can take the fLog object from MGeomCam?
 //
 ////////////////////////////////////////////////////////////////////////////
@@ -63,6 +70,10 @@
 #include <TPaveStats.h>
 #include <TClonesArray.h>
 #include <THistPainter.h>
+#include <TImageDump.h>
+#include <TImage.h>
+#include <TColor.h>
+#include <TROOT.h>
 #include <THLimitsFinder.h>
 #include <TProfile.h>
 #include <TH1.h>
@@ -127,7 +138,7 @@ void MHCamera::Init()
 //
 //  Default Constructor. To be used by the root system ONLY.
 //
-MHCamera::MHCamera() : TH1D(), fGeomCam(NULL), fAbberation(0)
+MHCamera::MHCamera() : TH1D(), fGeomCam(NULL), fAbberation(0), fMeshConv(0), fMeshScale(0)
 {
     Init();
 }
@@ -139,7 +150,7 @@ MHCamera::MHCamera() : TH1D(), fGeomCam(NULL), fAbberation(0)
 // (for error bars) to Green and the marker style to kFullDotMedium.
 //
 MHCamera::MHCamera(const MGeomCam &geom, const char *name, const char *title)
-: fGeomCam(NULL), fAbberation(0)
+: fGeomCam(NULL), fAbberation(0), fMeshConv(0), fMeshScale(0)
 {
     //fGeomCam = (MGeomCam*)geom.Clone();
     SetGeometry(geom, name, title);
@@ -193,6 +204,9 @@ void MHCamera::SetGeometry(const MGeomCam &geom, const char *name, const char *t
 
     fBinEntries.Set(geom.GetNumPixels()+2);
     fBinEntries.Reset();
+
+    // Force recalculation of the pixel polygons
+    fMeshIdx.Set(0);
 }
 
 // ------------------------------------------------------------------------
@@ -935,6 +949,13 @@ void MHCamera::Update(Bool_t islog, Bool_t isbox, Bool_t iscol, Bool_t issame)
         gPad->GetX1()<-maxr || gPad->GetY1()<-maxr ||
         gPad->GetX2()> maxr || gPad->GetY2()>maxr ? 1 : fGeomCam->GetConvMm2Deg();
 
+    // The size of the pixels is constant: use the cached polygons
+    if (!isbox)
+    {
+        PaintMesh(min, max, islog, iscol, issame, conv);
+        return;
+    }
+
     TAttLine line(kBlack, kSolid, 1);
     TAttFill fill;
     for (Int_t i=0; i<fNcells-2; i++)
@@ -976,6 +997,308 @@ void MHCamera::Update(Bool_t islog, Bool_t isbox, Bool_t iscol, Bool_t issame)
     }
 }
 
+// ------------------------------------------------------------------------
+//
+// Calculate the polygons of all pixels with the positions scaled by conv
+// and the sizes scaled by scale. Each polygon is closed (the first corner
+// is repeated) so that it can be used to paint the outline. If the
+// polygons for conv and scale are already available nothing is done.
+//
+void MHCamera::BuildMesh(Double_t conv, Double_t scale)
+{
+    const Int_t n = fNcells-2;
+
+    if (fMeshIdx.GetSize()==UInt_t(n+1) && fMeshConv==conv && fMeshScale==scale)
+        return;
+
+    fMeshX.Set(n*(MGeom::kMaxCorners+1));
+    fMeshY.Set(n*(MGeom::kMaxCorners+1));
+    fMeshIdx.Set(n+1);
+
+    Double_t *x = fMeshX.GetArray();
+    Double_t *y = fMeshY.GetArray();
+
+    Int_t k = 0;
+    for (Int_t i=0; i<n; i++)
+    {
+        fMeshIdx[i] = k;
+
+        const Int_t nc = (*fGeomCam)[i].GetCorners(x+k, y+k, conv, scale);
+
+        x[k+nc] = x[k];
+        y[k+nc] = y[k];
+
+        k += nc+1;
+    }
+    fMeshIdx[n] = k;
+
+    fMeshConv  = conv;
+    fMeshScale = scale;
+}
+
+// ------------------------------------------------------------------------
+//
+// Fill the convex polygon (px, py) with n corners given in absolute pixel
+// coordinates with the color argb. Only the rectangle [x0,x1]x[y0,y1] of
+// the image buffer (with w columns) is changed.
+//
+static void FillPolygon(UInt_t *buf, Int_t w, Int_t x0, Int_t y0, Int_t x1, Int_t y1,
+                        const Int_t *px, const Int_t *py, Int_t n, UInt_t argb)
+{
+    Int_t ymin = py[0];
+    Int_t ymax = py[0];
+    for (Int_t j=1; j<n; j++)
+    {
+        if (py[j]<ymin)
+            ymin = py[j];
+        if (py[j]>ymax)
+            ymax = py[j];
+    }
+
+    if (ymin<y0)
+        ymin = y0;
+    if (ymax>y1)
+        ymax = y1;
+
+    for (Int_t y=ymin; y<=ymax; y++)
+    {
+        // Sample the row in its center
+        const Double_t yc = y+0.5;
+
+        Double_t xl =  FLT_MAX;
+        Double_t xr = -FLT_MAX;
+        for (Int_t j=0; j<n; j++)
+        {
+            const Int_t i = j+1==n ? 0 : j+1;
+            if ((py[j]<=yc) == (py[i]<=yc))
+                continue;
+
+            const Double_t xi = px[j] + (yc-py[j])*(px[i]-px[j])/(py[i]-py[j]);
+            if (xi<xl)
+                xl = xi;
+            if (xi>xr)
+                xr = xi;
+        }
+
+        Int_t l = TMath::CeilNint(xl-0.5);
+        Int_t r = TMath::FloorNint(xr-0.5);
+        if (l<x0)
+            l = x0;
+        if (r>x1)
+            r = x1;
+
+        UInt_t *row = buf+y*w;
+        for (Int_t x=l; x<=r; x++)
+            row[x] = argb;
+    }
+}
+
+// ------------------------------------------------------------------------
+//
+// Draw a line of one pixel width from (xa,ya) to (xb,yb) given in absolute
+// pixel coordinates with the color argb. Only the rectangle [x0,x1]x[y0,y1]
+// of the image buffer (with w columns) is changed.
+//
+static void DrawLine(UInt_t *buf, Int_t w, Int_t x0, Int_t y0, Int_t x1, Int_t y1,
+                     Int_t xa, Int_t ya, Int_t xb, Int_t yb, UInt_t argb)
+{
+    const Int_t dx =  TMath::Abs(xb-xa);
+    const Int_t dy = -TMath::Abs(yb-ya);
+    const Int_t sx = xa<xb ? 1 : -1;
+    const Int_t sy = ya<yb ? 1 : -1;
+
+    Int_t e = dx+dy;
+    while (1)
+    {
+        if (xa>=x0 && xa<=x1 && ya>=y0 && ya<=y1)
+            buf[ya*w+xa] = argb;
+
+        if (xa==xb && ya==yb)
+            break;
+
+        const Int_t e2 = 2*e;
+        if (e2>=dy)
+        {
+            e  += dy;
+            xa += sx;
+        }
+        if (e2<=dx)
+        {
+            e  += dx;
+            ya += sy;
+        }
+    }
+}
+
+// ------------------------------------------------------------------------
+//
+// Rasterize the pixels (fMeshCol sorted by fMeshOrder) directly into the
+// image buffer of TImageDump, which is used to write image files (e.g.
+// png) in batch mode. The coordinates are converted to pixels in the
+// same way as TImageDump does. The outlines are drawn in black.
+//
+// Returns kFALSE if the current output is not an image in batch mode.
+//
+Bool_t MHCamera::RasterizeMesh()
+{
+    if (!gPad->IsBatch() || !gVirtualPS || !gVirtualPS->InheritsFrom(TImageDump::Class()))
+        return kFALSE;
+
+    TImage *img = static_cast<TImageDump*>(gVirtualPS)->GetImage();
+    if (!img || !img->IsValid())
+        return kFALSE;
+
+    UInt_t *buf = img->GetArgbArray();
+    if (!buf)
+        return kFALSE;
+
+    const Int_t w = img->GetWidth();
+    const Int_t h = img->GetHeight();
+
+    // Clip to the pad and the image
+    const Int_t x0 = TMath::Max(0,   TMath::Min(gPad->XtoAbsPixel(gPad->GetX1()), gPad->XtoAbsPixel(gPad->GetX2())));
+    const Int_t x1 = TMath::Min(w-1, TMath::Max(gPad->XtoAbsPixel(gPad->GetX1()), gPad->XtoAbsPixel(gPad->GetX2())));
+    const Int_t y0 = TMath::Max(0,   TMath::Min(gPad->YtoAbsPixel(gPad->GetY1()), gPad->YtoAbsPixel(gPad->GetY2())));
+    const Int_t y1 = TMath::Min(h-1, TMath::Max(gPad->YtoAbsPixel(gPad->GetY1()), gPad->YtoAbsPixel(gPad->GetY2())));
+
+    const Int_t n = fMeshCol.GetSize();
+
+    Int_t px[MGeom::kMaxCorners+1];
+    Int_t py[MGeom::kMaxCorners+1];
+
+    Int_t  col  = 0;
+    UInt_t argb = 0;
+
+    for (Int_t k=0; k<n; k++)
+    {
+        const Int_t i = fMeshOrder[k];
+        if (fMeshCol[i]<=0)
+            continue;
+
+        if (fMeshCol[i]!=col)
+        {
+            col = fMeshCol[i];
+
+            const TColor *c = gROOT->GetColor(col);
+            argb = c ? 0xff000000 |
+                (UInt_t(c->GetRed()  *255)<<16) |
+                (UInt_t(c->GetGreen()*255)<< 8) |
+                 UInt_t(c->GetBlue() *255) : 0xffffffff;
+        }
+
+        const Int_t first = fMeshIdx[i];
+        const Int_t nc    = fMeshIdx[i+1]-first-1;
+        for (Int_t j=0; j<nc; j++)
+        {
+            px[j] = gPad->XtoAbsPixel(fMeshX[first+j]);
+            py[j] = gPad->YtoAbsPixel(fMeshY[first+j]);
+        }
+
+        FillPolygon(buf, w, x0, y0, x1, y1, px, py, nc, argb);
+    }
+
+    for (Int_t i=0; i<n; i++)
+    {
+        if (fMeshCol[i]<0)
+            continue;
+
+        const Int_t first = fMeshIdx[i];
+        const Int_t nc    = fMeshIdx[i+1]-first-1;
+        for (Int_t j=0; j<=nc; j++)
+        {
+            px[j] = gPad->XtoAbsPixel(fMeshX[first+j]);
+            py[j] = gPad->YtoAbsPixel(fMeshY[first+j]);
+        }
+
+        for (Int_t j=0; j<nc; j++)
+            DrawLine(buf, w, x0, y0, x1, y1, px[j], py[j], px[j+1], py[j+1], 0xff000000);
+    }
+
+    return kTRUE;
+}
+
+// ------------------------------------------------------------------------
+//
+// Paint all pixels from the cached polygons (see BuildMesh). Only the
+// colors are calculated. The fill attributes are changed only once for
+// all pixels with the same color, afterwards the outlines of all pixels
+// are painted. In batch mode into an image file the pixels are
+// rasterized directly (see RasterizeMesh)
+//
+void MHCamera::PaintMesh(Float_t min, Float_t max, Bool_t islog, Bool_t iscol, Bool_t issame, Double_t conv)
+{
+    BuildMesh(conv, 1./(fAbberation+1));
+
+    const Int_t n = fNcells-2;
+
+    fMeshCol.Set(n);
+    fMeshOrder.Set(n);
+
+    for (Int_t i=0; i<n; i++)
+    {
+        if (!IsUsed(i) && TestBit(kNoUnused))
+        {
+            fMeshCol[i] = -1;
+            continue;
+        }
+
+        // Hollow pixels are not filled (only the outline is painted)
+        if (issame || (IsTransparent() && !IsUsed(i)))
+        {
+            fMeshCol[i] = 0;
+            continue;
+        }
+
+        const Bool_t isnan = !TMath::Finite(fArray[i+1]);
+        if (!IsUsed(i) || !iscol || isnan)
+        {
+            fMeshCol[i] = 10;
+
+            if (isnan)
+                gLog << warn << "MHCamera::Update: " << GetName() << " <" << GetTitle() << "> - Pixel Index #" << i << " contents is not finite..." << endl;
+        }
+        else
+            fMeshCol[i] = GetColor(GetBinContent(i+1), min, max, islog);
+    }
+
+    TMath::Sort(n, fMeshCol.GetArray(), fMeshOrder.GetArray(), kFALSE);
+
+    if (RasterizeMesh())
+        return;
+
+    Double_t *x = fMeshX.GetArray();
+    Double_t *y = fMeshY.GetArray();
+
+    TAttFill fill(0, 1001);
+    for (Int_t k=0; k<n; k++)
+    {
+        const Int_t i = fMeshOrder[k];
+        if (fMeshCol[i]<=0)
+            continue;
+
+        if (fMeshCol[i]!=fill.GetFillColor())
+        {
+            fill.SetFillColor(fMeshCol[i]);
+            fill.Modify();
+        }
+
+        const Int_t first = fMeshIdx[i];
+        gPad->PaintFillArea(fMeshIdx[i+1]-first-1, x+first, y+first);
+    }
+
+    TAttLine line(kBlack, kSolid, 1);
+    line.Modify();
+
+    for (Int_t i=0; i<n; i++)
+    {
+        if (fMeshCol[i]<0)
+            continue;
+
+        const Int_t first = fMeshIdx[i];
+        gPad->PaintPolyLine(fMeshIdx[i+1]-first, x+first, y+first);
+    }
+}
+
 // ------------------------------------------------------------------------
 //
 // Print minimum and maximum
@@ -16,6 +16,9 @@
 #ifndef ROOT_MArrayD
 #include <MArrayD.h>
 #endif
+#ifndef ROOT_MArrayI
+#include <MArrayI.h>
+#endif
 #ifndef ROOT_TClonesArray
 #include <TClonesArray.h>
 #endif
@@ -63,6 +66,15 @@ protected:
 
     Float_t fAbberation;
 
+    MArrayD  fMeshX;       //! x-coordinates of the corners of all pixels (closed polygons)
+    MArrayD  fMeshY;       //! y-coordinates of the corners of all pixels (closed polygons)
+    MArrayI  fMeshIdx;     //! Index of the first corner of each pixel in fMeshX/Y
+    Double_t fMeshConv;    //! Scale of the positions for which the mesh was built
+    Double_t fMeshScale;   //! Scale of the pixel sizes for which the mesh was built
+
+    MArrayI  fMeshCol;     //! Fill color of each pixel (0: no fill, -1: not painted)
+    MArrayI  fMeshOrder;   //! Pixel indices sorted by fill color
+
     void Init();
 /*
     Stat_t Profile(Stat_t val) const
@@ -78,6 +90,9 @@ protected:
 
     void  PaintIndices(Int_t type);
     void  Update(Bool_t islog, Bool_t isbox, Bool_t iscol, Bool_t issame);
+    void  BuildMesh(Double_t conv, Double_t scale);
+    void  PaintMesh(Float_t min, Float_t max, Bool_t islog, Bool_t iscol, Bool_t issame, Double_t conv);
+    Bool_t RasterizeMesh();
     void  UpdateLegend(Float_t min, Float_t max, Bool_t islog);
 
     TPaveStats *GetStatisticBox();
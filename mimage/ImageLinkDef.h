@@ -12,6 +12,8 @@
 #pragma link C++ class MHillasSrc+;
 #pragma link C++ class MHillasExt+;
 #pragma link C++ class MHillasCalc+;
+#pragma link C++ class MNewImageParCalc+;
+#pragma link C++ class MImagePixels+;
 
 #pragma link C++ class MImagePar+;
 #pragma link C++ class MNewImagePar+;
@@ -52,6 +52,8 @@
 #include "MSignalPix.h"
 #include "MSignalCam.h"
 
+#include "MImagePixels.h"
+
 #include "MLog.h"
 #include "MLogManip.h"
 
@@ -105,18 +107,32 @@ void MConcentration::Print(Option_t *) const
 // Returns:
 //    Nothing.
 //
+// For the calculation of several image parameters of the same event
+// it is more efficient to fill MImagePixels once and call
+// Calc(const MImagePixels&, const MHillas&) instead.
+//
 Int_t MConcentration::Calc(const MGeomCam &geom, const MSignalCam &evt, const MHillas &hillas)
+{
+    MImagePixels pix(geom);
+    pix.Fill(evt);
+
+    return Calc(pix, hillas);
+}
+
+// --------------------------------------------------------------------------
+//
+// Calculate the Concentrations from the flat arrays of the used pixels
+// (see MImagePixels). All used pixels are taken into account
+// independent of their island index.
+//
+Int_t MConcentration::Calc(const MImagePixels &evt, const MHillas &hillas)
 {
     Float_t maxpix[9] = {0,0,0,0,0,0,0,0,0};             // [#phot]
 
-   const UInt_t npix = evt.GetNumPixels();
-   for (UInt_t j=0; j<npix; j++)
+   const UInt_t nused = evt.GetNumUsed();
+   for (UInt_t j=0; j<nused; j++)
    {
-       const MSignalPix &pix = evt[j];
-       if (!pix.IsPixelUsed())
-           continue;
-
-        const Double_t nphot = pix.GetNumPhotons()* geom.GetPixRatio(j);
+        const Double_t nphot = evt.GetPhot(j)*evt.GetRatio(j);
 
 	// Get number of photons in the 8 most populated pixels	
         if (maxpix[0]<=nphot)
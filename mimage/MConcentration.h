@@ -8,6 +8,7 @@
 class MHillas;
 class MGeomCam;
 class MSignalCam;
+class MImagePixels;
 
 class MConcentration : public MParContainer
 {
@@ -20,6 +21,7 @@ public:
     void Reset();
 
     Int_t Calc(const MGeomCam &geom, const MSignalCam &pix, const MHillas &hil);
+    Int_t Calc(const MImagePixels &pix, const MHillas &hil);
 
     void Print(Option_t *opt=NULL) const;
 
@@ -71,6 +71,8 @@
 #include "MSignalPix.h"
 #include "MSignalCam.h"
 
+#include "MImagePixels.h"
+
 #include "MLog.h"
 #include "MLogManip.h"
 
@@ -256,7 +258,25 @@ void MHillas::Paint(Option_t *opt)
 //   3  number of used pixel < 3
 //   4  CorrXY == 0
 //
+// For the calculation of several image parameters of the same event
+// it is more efficient to fill MImagePixels once and call
+// Calc(const MImagePixels&, Int_t) instead.
+//
 Int_t MHillas::Calc(const MGeomCam &geom, const MSignalCam &evt, Int_t island)
+{
+    MImagePixels pix(geom);
+    pix.Fill(evt);
+
+    return Calc(pix, island);
+}
+
+// --------------------------------------------------------------------------
+//
+// Calculate the image parameters from the flat arrays of the used pixels
+// (see MImagePixels). The return codes are the same as for
+// Calc(const MGeomCam&, const MSignalCam&, Int_t)
+//
+Int_t MHillas::Calc(const MImagePixels &evt, Int_t island)
 {
     const UInt_t numpix  = evt.GetNumPixels();
 
@@ -281,22 +301,17 @@ Int_t MHillas::Calc(const MGeomCam &geom, const MSignalCam &evt, Int_t island)
 
     UInt_t numused = 0;
 
-    for (UInt_t i=0; i<numpix; i++)
+    const UInt_t nused = evt.GetNumUsed();
+    for (UInt_t k=0; k<nused; k++)
     {
-        MSignalPix &pix = evt[i];
-        if (!pix.IsPixelUsed())
-            continue;
-
-        if (island>=0 && pix.GetIdxIsland()!=island)
+        if (!evt.IsSelected(k, island))
             continue;
 
-        const MGeom &gpix = geom[i];
-
-        const Float_t nphot = pix.GetNumPhotons();
+        const Float_t nphot = evt.GetPhot(k);
 
         fSize  += nphot;		             // [counter]
-        fMeanX += nphot * gpix.GetX();               // [mm]
-        fMeanY += nphot * gpix.GetY();               // [mm]
+        fMeanX += nphot * evt.GetX(k);               // [mm]
+        fMeanY += nphot * evt.GetY(k);               // [mm]
 
         numused++;
     }
@@ -329,21 +344,15 @@ Int_t MHillas::Calc(const MGeomCam &geom, const MSignalCam &evt, Int_t island)
     Double_t corrxy=0;                               // [m^2]
     Double_t corryy=0;                               // [m^2]
 
-    for (UInt_t i=0; i<numpix; i++)
+    for (UInt_t k=0; k<nused; k++)
     {
-        const MSignalPix &pix = evt[i];
-        if (!pix.IsPixelUsed())
+        if (!evt.IsSelected(k, island))
             continue;
 
-        if (island>=0 && pix.GetIdxIsland()!=island)
-            continue;
-
-        const MGeom &gpix = geom[i];
-
-        const Float_t dx = gpix.GetX() - fMeanX;     // [mm]
-        const Float_t dy = gpix.GetY() - fMeanY;     // [mm]
+        const Float_t dx = evt.GetX(k) - fMeanX;     // [mm]
+        const Float_t dy = evt.GetY(k) - fMeanY;     // [mm]
 
-        const Float_t nphot = pix.GetNumPhotons();   // [#phot]
+        const Float_t nphot = evt.GetPhot(k);        // [#phot]
 
         corrxx += nphot * dx*dx;                     // [mm^2]
         corrxy += nphot * dx*dy;                     // [mm^2]
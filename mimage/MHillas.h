@@ -10,6 +10,7 @@ class TVector2;
 
 class MGeomCam;
 class MSignalCam;
+class MImagePixels;
 
 class MHillas : public MParContainer
 {
@@ -31,6 +32,7 @@ public:
     void Reset();
 
     Int_t Calc(const MGeomCam &geom, const MSignalCam &pix, Int_t island=-1);
+    Int_t Calc(const MImagePixels &pix, Int_t island=-1);
 
     void Print(const MGeomCam &geom) const;
     void Print(Option_t *opt=NULL) const;
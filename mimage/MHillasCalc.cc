@@ -134,6 +134,17 @@
 //    kCalcConc       |  1  2        5  |   11
 //   -----------------+-----------------+--------
 //
+//
+//   Implementation
+//  ----------------
+//
+//  For the calculation of kCalcHillas, kCalcHillasExt, kCalcNewImgPar
+//  and kCalcConc the event is gathered once per event into flat arrays
+//  (MImagePixels) with a single sweep over MSignalCam. All following
+//  loops run over the contiguous arrays of the used pixels only. The
+//  geometry is copied in ReInit. The results are identical to the
+//  calculation directly from MGeomCam and MSignalCam.
+//
 /////////////////////////////////////////////////////////////////////////////
 #include "MHillasCalc.h"
 
@@ -297,6 +308,18 @@ Int_t MHillasCalc::PreProcess(MParList *pList)
     return kTRUE;
 }
 
+// --------------------------------------------------------------------------
+//
+// Copy the camera geometry into the flat arrays used for the calculation
+//
+Bool_t MHillasCalc::ReInit(MParList *pList)
+{
+    if (TestFlags(kCalcHillas|kCalcHillasExt|kCalcNewImagePar|kCalcConc))
+        fPixels.InitGeom(*fGeomCam);
+
+    return kTRUE;
+}
+
 // --------------------------------------------------------------------------
 //
 // If you want do complex descisions inside the calculations
@@ -304,11 +327,18 @@ Int_t MHillasCalc::PreProcess(MParList *pList)
 //
 // If the calculation wasn't sucessfull skip this event
 //
+// The pixels of the event are gathered once into flat arrays (see
+// MImagePixels) which are then used for the calculation of MHillas,
+// MHillasExt, MNewImagePar and MConcentration.
+//
 Int_t MHillasCalc::Process()
 {
+    if (TestFlags(kCalcHillas|kCalcHillasExt|kCalcNewImagePar|kCalcConc))
+        fPixels.Fill(*fCerPhotEvt);
+
     if (TestFlag(kCalcHillas))
     {
-        const Int_t rc = fHillas->Calc(*fGeomCam, *fCerPhotEvt, fIdxIsland);
+        const Int_t rc = fHillas->Calc(fPixels, fIdxIsland);
         if (rc<0 || rc>4)
         {
             *fLog << err << dbginf << "MHillas::Calc returned unknown error code!" << endl;
@@ -338,19 +368,19 @@ Int_t MHillasCalc::Process()
     fErrors[0]++;
 
     if (TestFlag(kCalcHillasExt))
-        fHillasExt->Calc(*fGeomCam, *fCerPhotEvt, *fHillas, fIdxIsland);
+        fHillasExt->Calc(fPixels, *fHillas, fIdxIsland);
 
     if (TestFlag(kCalcImagePar))
         fImagePar->Calc(*fCerPhotEvt);
 
     if (TestFlag(kCalcNewImagePar))
-        fNewImgPar->Calc(*fGeomCam, *fCerPhotEvt, *fHillas, fIdxIsland);
+        fNewImgPar->Calc(fPixels, *fHillas, fIdxIsland);
 
     if (TestFlag(kCalcNewImagePar2))
         fNewImgPar2->Calc(*fGeomCam, *fCerPhotEvt, fIdxIsland);
 
     if (TestFlag(kCalcConc))
-        fConc->Calc(*fGeomCam, *fCerPhotEvt, *fHillas);
+        fConc->Calc(fPixels, *fHillas);
 
     return kTRUE;
 }
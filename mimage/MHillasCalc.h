@@ -15,6 +15,9 @@
 #ifndef ROOT_TArrayL
 #include <TArrayL.h>
 #endif
+#ifndef MARS_MImagePixels
+#include "MImagePixels.h"
+#endif
 
 class MGeomCam;
 class MSignalCam;
@@ -63,6 +66,8 @@ class MHillasCalc : public MTask
 
     TArrayL              fErrors;           //! Error counter. Do we have to change to Double?
 
+    MImagePixels         fPixels;           //! Flat arrays of the pixels of the current event
+
     Int_t                fFlags;            // Flags defining the behaviour of MHillasCalc
     Short_t              fIdxIsland;        // Number of island to use for calculation
 
@@ -73,6 +78,7 @@ class MHillasCalc : public MTask
 
     // MTask
     Int_t PreProcess(MParList *pList);
+    Bool_t ReInit(MParList *pList);
     Int_t Process();
     Int_t PostProcess();
 
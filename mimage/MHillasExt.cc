@@ -88,6 +88,8 @@
 #include "MSignalPix.h"
 #include "MSignalCam.h"
 
+#include "MImagePixels.h"
+
 #include "MLog.h"
 #include "MLogManip.h"
 
@@ -132,7 +134,24 @@ void MHillasExt::Reset()
 // calculation of additional parameters based on the camera geometry
 // and the cerenkov photon event
 //
+// For the calculation of several image parameters of the same event
+// it is more efficient to fill MImagePixels once and call
+// Calc(const MImagePixels&, const MHillas&, Int_t) instead.
+//
 Int_t MHillasExt::Calc(const MGeomCam &geom, const MSignalCam &evt, const MHillas &hil, Int_t island)
+{
+    MImagePixels pix(geom);
+    pix.Fill(evt);
+
+    return Calc(pix, hil, island);
+}
+
+// -------------------------------------------------------------------------
+//
+// calculation of additional parameters from the flat arrays of the used
+// pixels (see MImagePixels)
+//
+Int_t MHillasExt::Calc(const MImagePixels &evt, const MHillas &hil, Int_t island)
 {
     //
     //   calculate the additional image parameters
@@ -180,23 +199,17 @@ Int_t MHillasExt::Calc(const MGeomCam &geom, const MSignalCam &evt, const MHilla
     Double_t sumdx2dyw = 0;
     Double_t sumdxdy2w = 0;
 
-    const UInt_t npix = evt.GetNumPixels();
-    for (UInt_t i=0; i<npix; i++)
+    const UInt_t nused = evt.GetNumUsed();
+    for (UInt_t k=0; k<nused; k++)
     {
-        const MSignalPix &pix = evt[i];
-        if (!pix.IsPixelUsed())
+        if (!evt.IsSelected(k, island))
             continue;
 
-        if (island>=0 && pix.GetIdxIsland()!=island)
-            continue;
-
-        const MGeom &gpix = geom[i];
-
-        const Double_t x = gpix.GetX();
-        const Double_t y = gpix.GetY();
-        const Double_t t = pix.GetArrivalTime();
+        const Double_t x = evt.GetX(k);
+        const Double_t y = evt.GetY(k);
+        const Double_t t = evt.GetTime(k);
 
-        Double_t nphot = pix.GetNumPhotons();        // [1]
+        Double_t nphot = evt.GetPhot(k);             // [1]
 
         // --- time slope ----
         sumx    += x;
@@ -240,13 +253,13 @@ Int_t MHillasExt::Calc(const MGeomCam &geom, const MSignalCam &evt, const MHilla
         // Now we are working on absolute values of nphot, which
         // must take pixel size into account
         //
-        nphot *= geom.GetPixRatio(i);
+        nphot *= evt.GetRatio(k);
 
         // --- max pixel ---
         if (nphot>maxpix)
         {
             maxpix   = nphot;                        // [1]
-            maxpixid = i;
+            maxpixid = evt.GetIdx(k);
         }
     }
 
@@ -314,8 +327,9 @@ Int_t MHillasExt::Calc(const MGeomCam &geom, const MSignalCam &evt, const MHilla
     //
     // Asymmetry
     //
-    const MGeom &maxp = geom[maxpixid];
-    fAsym = (hil.GetMeanX()-maxp.GetX())*c + (hil.GetMeanY()-maxp.GetY())*s;            // [mm]
+    const Float_t maxx = evt.GetGeomX(maxpixid);
+    const Float_t maxy = evt.GetGeomY(maxpixid);
+    fAsym = (hil.GetMeanX()-maxx)*c + (hil.GetMeanY()-maxy)*s;            // [mm]
 
     SetReadyToSave();
 
@@ -10,6 +10,7 @@ class TArrayF;
 class MHillas;
 class MGeomCam;
 class MSignalCam;
+class MImagePixels;
 
 class MHillasExt : public MParContainer
 {
@@ -46,6 +47,7 @@ public:
 
     Int_t Calc(const MGeomCam &geom, const MSignalCam &pix,
                const MHillas &hil, Int_t island=-1);
+    Int_t Calc(const MImagePixels &pix, const MHillas &hil, Int_t island=-1);
 
     void Print(Option_t *opt=NULL) const;
     void Print(const MGeomCam &geom) const;
@@ -0,0 +1,149 @@
+/* ======================================================================== *\
+!
+! *
+! * This file is part of MARS, the MAGIC Analysis and Reconstruction
+! * Software. It is distributed to you in the hope that it can be a useful
+! * and timesaving tool in analysing Data of imaging Cerenkov telescopes.
+! * It is distributed WITHOUT ANY WARRANTY.
+! *
+! * Permission to use, copy, modify and distribute this software and its
+! * documentation for any purpose is hereby granted without fee,
+! * provided that the above copyright notice appear in all copies and
+! * that both that copyright notice and this permission notice appear
+! * in supporting documentation. It is provided "as is" without express
+! * or implied warranty.
+! *
+!
+!
+!   Copyright: MAGIC Software Development, 2000-2026
+!
+!
+\* ======================================================================== */
+
+//////////////////////////////////////////////////////////////////////////////
+//
+//  MImagePixels
+//
+//  The pixels of an image stored in flat arrays for the calculation of
+//  the image parameters (MHillas, MHillasExt, MNewImagePar and
+//  MConcentration).
+//
+//  The geometry (position, area, area ratio and the outer ring flags) is
+//  copied once from MGeomCam by InitGeom(). Fill() gathers the event with
+//  a single sweep over MSignalCam: the signal of all pixels, the indices
+//  of all mapped pixels and, compact in ascending pixel index, position,
+//  signal, arrival time, area ratio, island index and flags of all used
+//  pixels.
+//
+//  The calculations then loop over contiguous arrays of the used pixels
+//  only instead of over all pixels of the camera, without virtual function
+//  calls and without dereferencing the pixel objects. Because the pixels
+//  are visited in the same order and all values are stored with their
+//  original precision the results are identical.
+//
+//  See also: MHillasCalc
+//
+//////////////////////////////////////////////////////////////////////////////
+#include "MImagePixels.h"
+
+#include <TMath.h>
+
+#include "MGeom.h"
+#include "MGeomCam.h"
+
+#include "MSignalPix.h"
+#include "MSignalCam.h"
+
+ClassImp(MImagePixels);
+
+using namespace std;
+
+// --------------------------------------------------------------------------
+//
+// Copy the geometry of all pixels from the camera geometry
+//
+void MImagePixels::InitGeom(const MGeomCam &geom)
+{
+    const UInt_t n = geom.GetNumPixels();
+
+    fGeomX.Set(n);
+    fGeomY.Set(n);
+    fGeomA.Set(n);
+    fGeomT.Set(n);
+    fGeomRatio.Set(n);
+    fGeomRing.Set(n);
+
+    for (UInt_t i=0; i<n; i++)
+    {
+        const MGeom &gpix = geom[i];
+
+        fGeomX[i]     = gpix.GetX();
+        fGeomY[i]     = gpix.GetY();
+        fGeomA[i]     = gpix.GetA();
+        fGeomT[i]     = gpix.GetT();
+        fGeomRatio[i] = geom.GetPixRatio(i);
+
+        fGeomRing[i]  = 0;
+        if (gpix.IsInOutermostRing())
+            fGeomRing[i] |= kIsInOutermostRing;
+        if (gpix.IsInOuterRing())
+            fGeomRing[i] |= kIsInOuterRing;
+    }
+
+    fMapped.Set(n);
+    fSignal.Set(n);
+
+    fIdx.Set(n);
+    fIsland.Set(n);
+    fX.Set(n);
+    fY.Set(n);
+    fPhot.Set(n);
+    fTime.Set(n);
+    fRatio.Set(n);
+    fFlags.Set(n);
+
+    fNumPixels = 0;
+    fNumMapped = 0;
+    fNumUsed   = 0;
+}
+
+// --------------------------------------------------------------------------
+//
+// Gather the pixels of the event. InitGeom() must have been called before.
+// Pixels of the event without corresponding pixel in the geometry are
+// ignored (they are not counted in GetNumPixels()).
+//
+void MImagePixels::Fill(const MSignalCam &evt)
+{
+    fNumPixels = TMath::Min(evt.GetNumPixels(), GetNumGeomPixels());
+    fNumMapped = 0;
+    fNumUsed   = 0;
+
+    for (UInt_t i=0; i<fNumPixels; i++)
+    {
+        const MSignalPix &pix = evt[i];
+
+        fSignal[i] = pix.GetNumPhotons();
+
+        if (pix.IsPixelUnmapped())
+            continue;
+
+        fMapped[fNumMapped++] = i;
+
+        if (!pix.IsPixelUsed())
+            continue;
+
+        const UInt_t k = fNumUsed++;
+
+        fIdx[k]    = i;
+        fIsland[k] = pix.GetIdxIsland();
+        fX[k]      = fGeomX[i];
+        fY[k]      = fGeomY[i];
+        fPhot[k]   = fSignal[i];
+        fTime[k]   = pix.GetArrivalTime();
+        fRatio[k]  = fGeomRatio[i];
+        fFlags[k]  = fGeomRing[i];
+        if (pix.IsPixelCore())
+            fFlags[k] |= kIsCore;
+    }
+}
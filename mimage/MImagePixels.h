@@ -0,0 +1,99 @@
+#ifndef MARS_MImagePixels
+#define MARS_MImagePixels
+
+#ifndef ROOT_TObject
+#include <TObject.h>
+#endif
+
+#ifndef MARS_MArrayI
+#include "MArrayI.h"
+#endif
+#ifndef MARS_MArrayF
+#include "MArrayF.h"
+#endif
+#ifndef MARS_MArrayB
+#include "MArrayB.h"
+#endif
+
+class MGeomCam;
+class MSignalCam;
+
+class MImagePixels : public TObject
+{
+public:
+    enum {
+        kIsCore            = BIT(0),
+        kIsInOutermostRing = BIT(1),
+        kIsInOuterRing     = BIT(2)
+    };
+
+private:
+    // Geometry (all pixels of the camera)
+    MArrayF fGeomX;      // x-coordinate of the pixel center [mm]
+    MArrayF fGeomY;      // y-coordinate of the pixel center [mm]
+    MArrayF fGeomA;      // Area of the pixel [mm^2]
+    MArrayF fGeomT;      // Maximum elongation of the pixel [mm]
+    MArrayF fGeomRatio;  // Area ratio w.r.t. pixel 0 (MGeomCam::GetPixRatio)
+    MArrayB fGeomRing;   // kIsInOutermostRing, kIsInOuterRing
+
+    // Event (all pixels of the event)
+    UInt_t  fNumPixels;  // Number of pixels in the event
+    UInt_t  fNumMapped;  // Number of mapped pixels
+    MArrayI fMapped;     // Indices of the mapped pixels
+    MArrayF fSignal;     // Number of photons of all pixels
+
+    // Event (used pixels only, compact in ascending pixel index)
+    UInt_t  fNumUsed;    // Number of used pixels
+    MArrayI fIdx;        // Pixel index
+    MArrayI fIsland;     // Island index
+    MArrayF fX;          // x-coordinate [mm]
+    MArrayF fY;          // y-coordinate [mm]
+    MArrayF fPhot;       // Number of photons
+    MArrayF fTime;       // Arrival time
+    MArrayF fRatio;      // Area ratio w.r.t. pixel 0
+    MArrayB fFlags;      // kIsCore, kIsInOutermostRing, kIsInOuterRing
+
+public:
+    MImagePixels() : fNumPixels(0), fNumMapped(0), fNumUsed(0) { }
+    explicit MImagePixels(const MGeomCam &geom) : fNumPixels(0), fNumMapped(0), fNumUsed(0) { InitGeom(geom); }
+
+    void InitGeom(const MGeomCam &geom);
+    void Fill(const MSignalCam &evt);
+
+    // Geometry
+    UInt_t  GetNumGeomPixels() const { return fGeomX.GetSize(); }
+
+    Float_t GetGeomX(UInt_t i) const     { return fGeomX[i]; }
+    Float_t GetGeomY(UInt_t i) const     { return fGeomY[i]; }
+    Float_t GetGeomRatio(UInt_t i) const { return fGeomRatio[i]; }
+
+    // All pixels
+    UInt_t  GetNumPixels() const     { return fNumPixels; }
+    UInt_t  GetNumMapped() const     { return fNumMapped; }
+    Int_t   GetMapped(UInt_t k) const { return fMapped[k]; }
+    Float_t GetSignal(UInt_t i) const { return fSignal[i]; }
+
+    // Used pixels
+    UInt_t  GetNumUsed() const       { return fNumUsed; }
+
+    Int_t   GetIdx(UInt_t k) const    { return fIdx[k]; }
+    Int_t   GetIsland(UInt_t k) const { return fIsland[k]; }
+    Float_t GetX(UInt_t k) const      { return fX[k]; }
+    Float_t GetY(UInt_t k) const      { return fY[k]; }
+    Float_t GetA(UInt_t k) const      { return fGeomA[fIdx[k]]; }
+    Float_t GetT(UInt_t k) const      { return fGeomT[fIdx[k]]; }
+    Float_t GetPhot(UInt_t k) const   { return fPhot[k]; }
+    Float_t GetTime(UInt_t k) const   { return fTime[k]; }
+    Float_t GetRatio(UInt_t k) const  { return fRatio[k]; }
+
+    Bool_t  IsCore(UInt_t k) const            { return fFlags[k]&kIsCore; }
+    Bool_t  IsInOutermostRing(UInt_t k) const { return fFlags[k]&kIsInOutermostRing; }
+    Bool_t  IsInOuterRing(UInt_t k) const     { return fFlags[k]&kIsInOuterRing; }
+
+    // Check for requested islands (island<0: all islands)
+    Bool_t  IsSelected(UInt_t k, Int_t island) const { return island<0 || fIsland[k]==island; }
+
+    ClassDef(MImagePixels, 0) // Flat arrays of the pixels of an image for the calculation of image parameters
+};
+
+#endif
@@ -286,6 +286,17 @@
 //   + Int_t    fRecoverIsolatedPixels;
 //
 //
+// IMPLEMENTATION
+// ==============
+// The cleaning doesn't walk through the MSignalPix and the neighbor
+// lists of MGeom. In ReInit a flat neighbor table (compressed sparse
+// rows) is built from the geometry. The pixels above the cleaning levels,
+// the core and the used pixels are stored in bit-fields and the rings
+// are added by dilation of these bit-fields. The result (used, core and
+// ring number) is written to MSignalCam at the end. The resulting pixels
+// and ring numbers are identical to the former recursive implementation.
+//
+//
 //  Input Containers:
 //   MGeomCam
 //   MPedPhotCam
@@ -310,6 +321,7 @@
 #include "MLogManip.h"
 
 #include "MArrayI.h"
+#include "MArrayF.h"
 #include "MParList.h"
 #include "MCameraData.h"
 
@@ -325,6 +337,9 @@ ClassImp(MImgCleanStd);
 
 using namespace std;
 
+static inline Bool_t BitTest(const vector<ULong64_t> &b, UInt_t i) { return (b[i>>6]>>(i&63))&1; }
+static inline void   BitSet(vector<ULong64_t> &b, UInt_t i)        { b[i>>6] |= 1ULL<<(i&63); }
+
 enum {
     kImgCleanLvl1,
     kImgCleanLvl2
@@ -357,148 +372,150 @@ MImgCleanStd::MImgCleanStd(const Float_t lvl1, const Float_t lvl2,
     fTitle = title ? title : gsDefTitle.Data();
 }
 
-void MImgCleanStd::ResetCleaning() const
-{
-    //
-    // check the number of all pixels against the noise level and
-    // set them to 'unused' state if necessary
-    //
-    const UInt_t npixevt = fEvt->GetNumPixels();
-    for (UInt_t idx=0; idx<npixevt; idx++)
-    {
-        MSignalPix &pix = (*fEvt)[idx];
-        if (pix.IsPixelUnmapped())
-            continue;
-
-        pix.SetPixelUnused();
-        pix.SetPixelCore(kFALSE);
-    }
-}
-
 // --------------------------------------------------------------------------
 //
-// The first step of cleaning defines the CORE pixels. All the other pixels
-// are set as UNUSED and belong to RING 0.
-// After this point, only the CORE pixels are set as USED, with RING
-// number 1.
+// Build the flat neighbor table from the camera geometry. The neighbors
+// of pixel i are fNeighbors[fNeighborStart[i]] to
+// fNeighbors[fNeighborStart[i+1]-1] (compressed sparse rows). Their
+// distances to pixel i (needed for the time cleaning) are stored in
+// fNeighborDist. Initializes the bit-fields and the ring numbers.
 //
-//  NT 28/04/2003: now the option to use the standard method or the
-//  democratic method is implemented:
-//
-//  kStandard:   This method looks for all pixels with an entry (photons)
-//               that is three times bigger than the noise of the pixel
-//               (default: 3 sigma, clean level 1)
-//
-//  kDemocratic: this method looks for all pixels with an entry (photons)
-//               that is n times bigger than the noise of the mean of the
-//               inner pixels (default: 3 sigmabar, clean level 1)
-//
-//
-Bool_t MImgCleanStd::HasCoreNeighbors(const MGeom &gpix) const
+void MImgCleanStd::InitNeighbors()
 {
-//    if (fKeepIsolatedPixels)
-//        return kTRUE;
+    const UInt_t npix = fCam->GetNumPixels();
 
-#ifdef DEBUG
-    const TArrayD &data = fData->GetData();
-#else
-    const Double_t *data = fData->GetData().GetArray();
-#endif
+    fNeighborStart.Set(npix+1);
 
-    //loop on the neighbors to check if they are used
-    const Int_t n = gpix.GetNumNeighbors();
-    for (Int_t i=0; i<n; i++)
+    UInt_t n = 0;
+    for (UInt_t i=0; i<npix; i++)
     {
-        const Int_t idx = gpix.GetNeighbor(i);
+        fNeighborStart[i] = n;
+        n += (*fCam)[i].GetNumNeighbors();
+    }
+    fNeighborStart[npix] = n;
 
-        // Check if a neighborpixel of our core pixel is
-        // also a core pixel
-        if (data[idx]<=fCleanLvl1)
-            continue;
+    fNeighbors.Set(n);
+    fNeighborDist.Set(n);
 
-        // Ignore unmapped pixels
-        MSignalPix &pix = (*fEvt)[idx];
-        if (pix.IsPixelUnmapped())
-            continue;
+    for (UInt_t i=0; i<npix; i++)
+    {
+        const MGeom &gpix = (*fCam)[i];
 
-        return kTRUE;
+        const Int_t first = fNeighborStart[i];
+        for (Int_t j=0; j<gpix.GetNumNeighbors(); j++)
+        {
+            const Int_t idx = gpix.GetNeighbor(j);
+
+            fNeighbors[first+j]    = idx;
+            fNeighborDist[first+j] = gpix.GetDist((*fCam)[idx]);
+        }
     }
 
-    return kFALSE;
+    const UInt_t nwords = (npix+63)/64;
+
+    fMask1.assign(nwords, 0);
+    fMask2.assign(nwords, 0);
+    fCore .assign(nwords, 0);
+    fUsed .assign(nwords, 0);
+    fFront.assign(nwords, 0);
+    fNext .assign(nwords, 0);
+
+    fRing.Set(npix);
+    fTime.Set(npix);
 }
 
-Bool_t MImgCleanStd::HasUsedNeighbors(const MGeom &gpix) const
+// --------------------------------------------------------------------------
+//
+// Set in next the bits of all neighbors of the pixels set in front
+// (dilation of front by one ring).
+//
+void MImgCleanStd::Dilate(const std::vector<ULong64_t> &front, std::vector<ULong64_t> &next) const
 {
-    //loop on the neighbors to check if they are used
-    const Int_t n = gpix.GetNumNeighbors();
-    for (Int_t i=0; i<n; i++)
+    const UInt_t nwords = front.size();
+    for (UInt_t w=0; w<nwords; w++)
     {
-        const Int_t idx = gpix.GetNeighbor(i);
-
-        MSignalPix &pix = (*fEvt)[idx];
+        ULong64_t bits = front[w];
+        while (bits)
+        {
+            const UInt_t idx = w*64 + __builtin_ctzll(bits);
+            bits &= bits-1;
 
-        // Check if a neighborpixel of our core pixel is
-        // also a core pixel
-        if (pix.IsPixelUsed() && !pix.IsPixelUnmapped())
-            return kTRUE;
+            for (Int_t k=fNeighborStart[idx]; k<fNeighborStart[idx+1]; k++)
+                BitSet(next, fNeighbors[k]);
+        }
     }
-
-    return kFALSE;
 }
 
-
-void MImgCleanStd::SetUsedNeighbors(const MGeom &gpix, Int_t r) const
+// --------------------------------------------------------------------------
+//
+// Starting from the pixels in fFront (ring 1) all pixels above the
+// second cleaning level (fMask2) which can be reached within fCleanRings
+// steps are marked as used, ring by ring by dilation of the bit-fields.
+// A pixel which is already used with the same or a lower ring number is
+// not changed (and not expanded), i.e. the ring numbers are only ever
+// decreased. This results in the same pixels and ring numbers as the
+// recursive search through the neighbors.
+//
+void MImgCleanStd::ExpandRings()
 {
-    if (r>fCleanRings)
-        return;
+    const UInt_t nwords = fUsed.size();
 
-#ifdef DEBUG
-    const TArrayD &data = fData->GetData();
-#else
-    const Double_t *data = fData->GetData().GetArray();
-#endif
-
-    // At least one neighbor has been identified as core,
-    // that means we will keep the pixel
-    const Int_t n = gpix.GetNumNeighbors();
-    for (Int_t i=0; i<n; i++)
+    for (Int_t r=1; r<=fCleanRings; r++)
     {
-        const Int_t idx = gpix.GetNeighbor(i);
+        fNext.assign(nwords, 0);
+        Dilate(fFront, fNext);
 
-        MSignalPix &pix = (*fEvt)[idx];
+        ULong64_t any = 0;
+        for (UInt_t w=0; w<nwords; w++)
+        {
+            ULong64_t bits = fNext[w] & fMask2[w];
 
-        // If the pixel has been assigned to the same or a previous
-        // ring we don't have to proceed. We have to try to set the
-        // ring number of each pixel as low as possible. This means
-        // we are only allowed to increase the ring number.
-        if (pix.IsPixelUsed() && pix.GetRing()<=r)
-            continue;
+            // Remove pixels which already have a ring number <= r
+            ULong64_t used = bits & fUsed[w];
+            while (used)
+            {
+                const UInt_t b = __builtin_ctzll(used);
+                used &= used-1;
 
-        // All pixels below the second cleaning level should be ignored
-        if (data[idx] <= fCleanLvl2)
-            continue;
+                if (fRing[w*64+b]<=r)
+                    bits &= ~(1ULL<<b);
+            }
 
-        // Ignore unmapped pixels (remark: used (aka. ring>0)
-        // and unmapped status is exclusive
-        if (pix.IsPixelUnmapped())
-            continue;
+            // Set or reset the ring number
+            ULong64_t set = bits;
+            while (set)
+            {
+                const UInt_t b = __builtin_ctzll(set);
+                set &= set-1;
+
+                fRing[w*64+b] = r;
+            }
+
+            fUsed[w] |= bits;
+            fNext[w]  = bits;
 
-        // Set or reset the ring number
-        pix.SetRing(r);
+            any |= bits;
+        }
+
+        if (!any)
+            break;
 
-        // Step forward to the surrounding pixels
-        SetUsedNeighbors((*fCam)[idx], r+1);
+        fFront.swap(fNext);
     }
 }
 
 // --------------------------------------------------------------------------
 //
 // Here we do the cleaning. We search for all the possible core candidates
-// and from them on we recursively search for used pixels with
-// SetUsedNeighbors. To check the validity of a core pixel
-// either fTimeLvl2 and/or HasCoreNeighbors is used.
-// The size of all removed
-Int_t MImgCleanStd::DoCleaning(Float_t &size) const
+// and from them on we search for used pixels with ExpandRings. To check
+// the validity of a core pixel either fCleanLvl0 and/or its neighbors
+// above fCleanLvl1 (fMask1) are used.
+//
+// The result is stored in the bit-fields fCore and fUsed and the ring
+// numbers fRing. The size and number of all isolated core pixels is
+// returned.
+//
+Int_t MImgCleanStd::DoCleaning(Float_t &size)
 {
     Int_t n = 0;
     size = 0;
@@ -509,51 +526,103 @@ Int_t MImgCleanStd::DoCleaning(Float_t &size) const
     const Double_t *data = fData->GetData().GetArray();
 #endif
 
+    const UInt_t npix = TMath::Min(fEvt->GetNumPixels(), fCam->GetNumPixels());
+    const UInt_t nwords = fUsed.size();
+
+    fMask1.assign(nwords, 0);
+    fMask2.assign(nwords, 0);
+    fCore .assign(nwords, 0);
+    fUsed .assign(nwords, 0);
+
     //
-    // check the number of all pixels against the noise level and
-    // set them to 'unused' state if necessary
+    // Mark all mapped pixels above the first and second cleaning level
     //
-    const UInt_t npixevt = fEvt->GetNumPixels();
-    for (UInt_t idx=0; idx<npixevt; idx++)
+    for (UInt_t idx=0; idx<npix; idx++)
     {
-        MSignalPix &pix = (*fEvt)[idx];
-
-        // Check if this pixel is a possible candidate for a core pixel
-        if (data[idx] <= fCleanLvl1)
+        if (data[idx] <= fCleanLvl2)
             continue;
 
         // Ignore unmapped pixels
-        if (pix.IsPixelUnmapped())
+        if ((*fEvt)[idx].IsPixelUnmapped())
             continue;
 
-        const MGeom &gpix = (*fCam)[idx];
+        BitSet(fMask2, idx);
+
+        if (data[idx] > fCleanLvl1)
+            BitSet(fMask1, idx);
+    }
 
-        // Check if the pixel is an isolated core pixel
-        if (!HasCoreNeighbors(gpix))
+    //
+    // Every possible candidate for a core pixel
+    //
+    for (UInt_t w=0; w<nwords; w++)
+    {
+        ULong64_t bits = fMask1[w];
+        while (bits)
         {
-            // Count size and number of isolated core pixels
-            size += pix.GetNumPhotons();
-            n++;
-
-            // If isolated pixels should not be kept or the pixel
-            // is lower than the cleaning level for isolated core
-            // pixels. It is not treated as core pixel.
-            if (!fKeepIsolatedPixels || data[idx]<=fCleanLvl0)
-                continue;
+            const UInt_t idx = w*64 + __builtin_ctzll(bits);
+            bits &= bits-1;
+
+            // Check if the pixel is an isolated core pixel
+            Bool_t isolated = kTRUE;
+            for (Int_t k=fNeighborStart[idx]; k<fNeighborStart[idx+1]; k++)
+                if (BitTest(fMask1, fNeighbors[k]))
+                {
+                    isolated = kFALSE;
+                    break;
+                }
+
+            if (isolated)
+            {
+                // Count size and number of isolated core pixels
+                size += (*fEvt)[idx].GetNumPhotons();
+                n++;
+
+                // If isolated pixels should not be kept or the pixel
+                // is lower than the cleaning level for isolated core
+                // pixels. It is not treated as core pixel.
+                if (!fKeepIsolatedPixels || data[idx]<=fCleanLvl0)
+                    continue;
+            }
+
+            // Mark pixel as used and core
+            BitSet(fCore, idx);
+            fRing[idx] = 1;
         }
+    }
 
-        // Mark pixel as used and core
-        pix.SetPixelUsed();
-        pix.SetPixelCore();
+    fUsed  = fCore;
+    fFront = fCore;
 
-        // Check if neighbor pixels should be marked as used
-        // This is done recursively depening on fCleanRings
-        SetUsedNeighbors(gpix);
-    }
+    // Check which neighbor pixels should be marked as used
+    ExpandRings();
 
     return n;
 }
 
+// --------------------------------------------------------------------------
+//
+// Copy the result of the cleaning (fCore, fUsed, fRing) to the MSignalPix
+// of all mapped pixels.
+//
+void MImgCleanStd::StoreCleaning() const
+{
+    const UInt_t npix = TMath::Min(fEvt->GetNumPixels(), fCam->GetNumPixels());
+    for (UInt_t idx=0; idx<npix; idx++)
+    {
+        MSignalPix &pix = (*fEvt)[idx];
+        if (pix.IsPixelUnmapped())
+            continue;
+
+        if (BitTest(fUsed, idx))
+            pix.SetRing(fRing[idx]);
+        else
+            pix.SetPixelUnused();
+
+        pix.SetPixelCore(BitTest(fCore, idx));
+    }
+}
+
 /*
 Float_t MImgCleanStd::GetArrivalTimeNeighbor(const MGeom &gpix) const
 {
@@ -610,7 +679,15 @@ void MImgCleanStd::CheckUsedPixelsForArrivalTime(Float_t timediff) const
 }
 */
 
-Int_t MImgCleanStd::RecoverIsolatedPixels(Float_t &size) const
+// --------------------------------------------------------------------------
+//
+// Pixels which are not used but above the first cleaning level and have
+// a used neighbor are marked as used and core pixels. Their neighbors are
+// searched for used pixels by ExpandRings. The pixels are checked in
+// the order of their index, i.e. a recovered pixel can already recover
+// the next one.
+//
+Int_t MImgCleanStd::RecoverIsolatedPixels(Float_t &size)
 {
 #ifdef DEBUG
     const TArrayD &data = fData->GetData();
@@ -620,112 +697,123 @@ Int_t MImgCleanStd::RecoverIsolatedPixels(Float_t &size) const
 
     Int_t n = 0;
 
-    //
-    // check the number of all pixels against the noise level and
-    // set them to 'unused' state if necessary
-    //
-    const UInt_t npixevt = fEvt->GetNumPixels();
-    for (UInt_t idx=0; idx<npixevt; idx++)
+    const UInt_t npix = TMath::Min(fEvt->GetNumPixels(), fCam->GetNumPixels());
+    for (UInt_t idx=0; idx<npix; idx++)
     {
-        MSignalPix &pix = (*fEvt)[idx];
-
         // If pixel has previously been marked used, ignore
-        if (pix.IsPixelUsed())
+        if (BitTest(fUsed, idx))
             continue;
 
         // If pixel is not a candidate for a core pixel, ignore
         if (data[idx] <= fCleanLvl1)
             continue;
 
-        const MGeom &gpix = (*fCam)[idx];
-
         // If isolated possible-corepixel doesn't have used
         // neighbors, ignore it
-        if (!HasUsedNeighbors(gpix))
+        Bool_t used = kFALSE;
+        for (Int_t k=fNeighborStart[idx]; k<fNeighborStart[idx+1]; k++)
+            if (BitTest(fUsed, fNeighbors[k]))
+            {
+                used = kTRUE;
+                break;
+            }
+
+        if (!used)
             continue;
 
         // Mark pixel as used and core
-        pix.SetPixelUsed();
-        pix.SetPixelCore();
+        BitSet(fUsed, idx);
+        BitSet(fCore, idx);
+        fRing[idx] = 1;
 
         // Check if neighbor pixels should be marked as used
-        // This is done recursively depening on fCleanRings
-        SetUsedNeighbors(gpix);
+        fFront.assign(fFront.size(), 0);
+        BitSet(fFront, idx);
 
-        size -= pix.GetNumPhotons();
+        ExpandRings();
+
+        size -= (*fEvt)[idx].GetNumPhotons();
         n++;
     }
 
     return n;
 }
 
-void MImgCleanStd::CleanTime(Int_t n, Double_t lvl) const
+// --------------------------------------------------------------------------
+//
+// Remove all used pixels which have less than n used neighbors with
+// an arrival time difference smaller than lvl (per degree distance).
+// The arrival times are taken from fTime.
+//
+void MImgCleanStd::CleanTime(Int_t n, Double_t lvl)
 {
-    MArrayI indices;
-
     // Add conversion factor for dx here
     const Double_t dtmax = lvl*fCam->GetConvMm2Deg();
 
-    const UInt_t npixevt = fEvt->GetNumPixels();
-    for (UInt_t idx=0; idx<npixevt; idx++)
-    {
-        // check if pixel is used or not
-        const MSignalPix &pix = (*fEvt)[idx];
-        if (!pix.IsPixelUsed())
-            continue;
-
-        // get arrival time
-        const Double_t tm0 = pix.GetArrivalTime();
+    const UInt_t nwords = fUsed.size();
 
-        // loop over its neighbpors
-        const MGeom &gpix = (*fCam)[idx];
+    // Pixels which didn't fullfill the requirement
+    fNext.assign(nwords, 0);
 
-        Int_t cnt = 0;
-        for (Int_t i=0; i<gpix.GetNumNeighbors(); i++)
+    for (UInt_t w=0; w<nwords; w++)
+    {
+        ULong64_t bits = fUsed[w];
+        while (bits)
         {
-            // Get index of neighbor
-            const Int_t idx2 = gpix.GetNeighbor(i);
-
-            // check if neighbor is used or not
-            const MSignalPix &npix = (*fEvt)[idx2];
-            if (!npix.IsPixelUsed())
-                continue;
-
-            const Double_t dt = TMath::Abs(npix.GetArrivalTime()-tm0);
-            const Double_t dx = gpix.GetDist((*fCam)[idx2]);
-
-            // If this pixel is to far away (in arrival time) don't count
-            if (dt>dtmax*dx)
-                continue;
-
-            // Now count the pixel. If we did not found n pixels yet
-            // which fullfill the condition, go on searching
-            if (++cnt>=n)
-                break;
+            const UInt_t idx = w*64 + __builtin_ctzll(bits);
+            bits &= bits-1;
+
+            // get arrival time
+            const Double_t tm0 = fTime[idx];
+
+            // loop over its neighbors
+            Int_t cnt = 0;
+            for (Int_t k=fNeighborStart[idx]; k<fNeighborStart[idx+1]; k++)
+            {
+                // Get index of neighbor
+                const Int_t idx2 = fNeighbors[k];
+
+                // check if neighbor is used or not
+                if (!BitTest(fUsed, idx2))
+                    continue;
+
+                const Double_t dt = TMath::Abs(fTime[idx2]-tm0);
+                const Double_t dx = fNeighborDist[k];
+
+                // If this pixel is to far away (in arrival time) don't count
+                if (dt>dtmax*dx)
+                    continue;
+
+                // Now count the pixel. If we did not found n pixels yet
+                // which fullfill the condition, go on searching
+                if (++cnt>=n)
+                    break;
+            }
+
+            // If we found at least n neighbors which are
+            // with a time difference of lvl keep the pixel
+            if (cnt<n)
+                BitSet(fNext, idx);
         }
-
-        // If we found at least n neighbors which are
-        // with a time difference of lvl keep the pixel
-        if (cnt>=n)
-            continue;
-
-        indices.Set(indices.GetSize()+1);
-        indices[indices.GetSize()-1] = idx;
     }
 
     // Now remove the pixels which didn't fullfill the requirement
-    for (UInt_t i=0; i<indices.GetSize(); i++)
+    for (UInt_t w=0; w<nwords; w++)
     {
-        (*fEvt)[indices[i]].SetPixelUnused();
-        (*fEvt)[indices[i]].SetPixelCore(kFALSE);
+        fUsed[w] &= ~fNext[w];
+        fCore[w] &= ~fNext[w];
     }
 }
 
-void MImgCleanStd::CleanStepTime() const
+void MImgCleanStd::CleanStepTime()
 {
     if (fPostCleanType<=0)
         return;
 
+    const UInt_t npix = TMath::Min(fEvt->GetNumPixels(), fCam->GetNumPixels());
+    for (UInt_t idx=0; idx<npix; idx++)
+        fTime[idx] = (*fEvt)[idx].GetArrivalTime();
+
     if (fPostCleanType&2)
         CleanTime(2, fTimeLvl2);
 
@@ -802,6 +890,16 @@ Int_t MImgCleanStd::PreProcess (MParList *pList)
     return kTRUE;
 }
 
+// --------------------------------------------------------------------------
+//
+// Build the neighbor table from the (possibly changed) geometry
+//
+Bool_t MImgCleanStd::ReInit(MParList *pList)
+{
+    InitNeighbors();
+    return kTRUE;
+}
+
 // --------------------------------------------------------------------------
 //
 // Cleans the image.
@@ -832,10 +930,8 @@ Int_t MImgCleanStd::Process()
         break;
     }
 
-#ifdef DEBUG
-    *fLog << all << "ResetCleaning" << endl;
-#endif
-    ResetCleaning();
+    if (fNeighborStart.GetSize()!=fCam->GetNumPixels()+1)
+        InitNeighbors();
 
 #ifdef DEBUG
     *fLog << all << "DoCleaning" << endl;
@@ -861,13 +957,15 @@ Int_t MImgCleanStd::Process()
     // FIXME: Remove removed core piselx?
     CleanStepTime();
 
+    StoreCleaning();
+
     fEvt->SetSinglePixels(n, size);
 
 #ifdef DEBUG
     *fLog << all << "CalcIslands" << endl;
 #endif
     // Takes roughly 10% of the time
-    fEvt->CalcIslands(*fCam);
+    fEvt->CalcIslands(*fCam, fNeighborStart, fNeighbors);
 
 #ifdef DEBUG
     *fLog << all << "Done." << endl;
@@ -5,6 +5,18 @@
 #include "MGTask.h"
 #endif
 
+#ifndef MARS_MArrayI
+#include "MArrayI.h"
+#endif
+#ifndef MARS_MArrayF
+#include "MArrayF.h"
+#endif
+#ifndef MARS_MArrayS
+#include "MArrayS.h"
+#endif
+
+#include <vector>
+
 class MGeomCam;
 class MGeom;
 class MSignalCam;
@@ -56,16 +68,30 @@ private:
     TString  fNameGeomCam;    // name of the 'MGeomCam' container
     TString  fNameSignalCam;  // name of the 'MSignalCam' container
 
+    MArrayI  fNeighborStart;  //! Index of the first neighbor of each pixel in fNeighbors (npix+1)
+    MArrayI  fNeighbors;      //! Indices of the neighbors of all pixels
+    MArrayF  fNeighborDist;   //! Distances of the neighbors of all pixels
+
+    std::vector<ULong64_t> fMask1; //! Mapped pixels above fCleanLvl1
+    std::vector<ULong64_t> fMask2; //! Mapped pixels above fCleanLvl2
+    std::vector<ULong64_t> fCore;  //! Core pixels
+    std::vector<ULong64_t> fUsed;  //! Used pixels
+    std::vector<ULong64_t> fFront; //! Pixels of the present ring
+    std::vector<ULong64_t> fNext;  //! Pixels of the next ring
+
+    MArrayS  fRing;           //! Ring number of the used pixels
+    MArrayF  fTime;           //! Arrival times (time cleaning)
+
     // MImgCleanStd
-    Bool_t HasCoreNeighbors(const MGeom &gpix) const;
-    Bool_t HasUsedNeighbors(const MGeom &gpix) const;
-    void   SetUsedNeighbors(const MGeom &gpix, Int_t r=1) const;
-    Int_t  DoCleaning(Float_t &size) const;
-    void   ResetCleaning() const;
-    Int_t  RecoverIsolatedPixels(Float_t &size) const;
-    void   CleanTime(Int_t n, Double_t lvl) const;
+    void   InitNeighbors();
+    void   Dilate(const std::vector<ULong64_t> &front, std::vector<ULong64_t> &next) const;
+    void   ExpandRings();
+    Int_t  DoCleaning(Float_t &size);
+    void   StoreCleaning() const;
+    Int_t  RecoverIsolatedPixels(Float_t &size);
+    void   CleanTime(Int_t n, Double_t lvl);
 
-    void CleanStepTime() const;
+    void CleanStepTime();
 
     // MGTask, MTask, MParContainer
     void    CreateGuiElements(MGGroupFrame *f);
@@ -73,8 +99,9 @@ private:
 
     void    StreamPrimitive(std::ostream &out) const;
 
-    Int_t PreProcess(MParList *pList);
-    Int_t Process();
+    Int_t  PreProcess(MParList *pList);
+    Bool_t ReInit(MParList *pList);
+    Int_t  Process();
 
 public:
     MImgCleanStd(const Float_t lvl1=3.0, const Float_t lvl2=2.5,
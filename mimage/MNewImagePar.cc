@@ -88,6 +88,8 @@
 #include "MSignalCam.h"
 #include "MSignalPix.h"
 
+#include "MImagePixels.h"
+
 ClassImp(MNewImagePar);
 
 using namespace std;
@@ -127,8 +129,25 @@ void MNewImagePar::Reset()
 //
 //  Calculation of new image parameters
 //
+//  For the calculation of several image parameters of the same event
+//  it is more efficient to fill MImagePixels once and call
+//  Calc(const MImagePixels&, const MHillas&, Int_t) instead.
+//
 void MNewImagePar::Calc(const MGeomCam &geom, const MSignalCam &evt,
                         const MHillas &hillas, Int_t island)
+{
+    MImagePixels pix(geom);
+    pix.Fill(evt);
+
+    Calc(pix, hillas, island);
+}
+
+// --------------------------------------------------------------------------
+//
+//  Calculation of new image parameters from the flat arrays of the
+//  pixels (see MImagePixels)
+//
+void MNewImagePar::Calc(const MImagePixels &evt, const MHillas &hillas, Int_t island)
 {
     fNumUsedPixels = 0;
     fNumCorePixels = 0;
@@ -151,19 +170,14 @@ void MNewImagePar::Calc(const MGeomCam &geom, const MSignalCam &evt,
     const Double_t rl = 1./(hillas.GetLength()*hillas.GetLength());
     const Double_t rw = 1./(hillas.GetWidth() *hillas.GetWidth());
 
-    UInt_t npix = evt.GetNumPixels();
-    for (UInt_t i=0; i<npix; i++)
+    // Find the three pixels which are next to the COG
+    const UInt_t nmapped = evt.GetNumMapped();
+    for (UInt_t k=0; k<nmapped; k++)
     {
-        const MSignalPix &pix = evt[i];
-        if (pix.IsPixelUnmapped())
-            continue;
+        const Int_t i = evt.GetMapped(k);
 
-        // Get geometry of pixel
-        const MGeom &gpix = geom[i];
-
-        // Find the three pixels which are next to the COG
-        const Double_t dx = gpix.GetX() - hillas.GetMeanX();      // [mm]
-        const Double_t dy = gpix.GetY() - hillas.GetMeanY();      // [mm]
+        const Double_t dx = evt.GetGeomX(i) - hillas.GetMeanX();  // [mm]
+        const Double_t dy = evt.GetGeomY(i) - hillas.GetMeanY();  // [mm]
 
         const Double_t dist0 = dx*dx+dy*dy;
 
@@ -192,34 +206,39 @@ void MNewImagePar::Calc(const MGeomCam &geom, const MSignalCam &evt,
                     dist[2] = dist0;
                     idx[2]  = i;
                 }
+    }
 
-        if (!pix.IsPixelUsed())
-            continue;
-
+    const UInt_t nused = evt.GetNumUsed();
+    for (UInt_t k=0; k<nused; k++)
+    {
         // Check for requested islands
-        if (island>=0 && pix.GetIdxIsland()!=island)
+        if (!evt.IsSelected(k, island))
             continue;
 
         // count used and core pixels
-        if (pix.IsPixelCore())
+        if (evt.IsCore(k))
         {
             fNumCorePixels++;
-            fCoreArea += gpix.GetA();
+            fCoreArea += evt.GetA(k);
         }
 
         // count used pixels
         fNumUsedPixels++;
-        fUsedArea += gpix.GetA();
+        fUsedArea += evt.GetA(k);
 
         // signal in pixel
-        Double_t nphot = pix.GetNumPhotons();
+        Double_t nphot = evt.GetPhot(k);
 
         //
         // Calculate signal contained inside ellipse
         //
+        const Double_t dx    =  evt.GetX(k) - hillas.GetMeanX();    // [mm]
+        const Double_t dy    =  evt.GetY(k) - hillas.GetMeanY();    // [mm]
+        const Double_t dist0 =  dx*dx+dy*dy;
+
         const Double_t dzx   =  hillas.GetCosDelta()*dx + hillas.GetSinDelta()*dy; // [mm]
         const Double_t dzy   = -hillas.GetSinDelta()*dx + hillas.GetCosDelta()*dy; // [mm]
-        const Double_t dz    =  gpix.GetT()/2;
+        const Double_t dz    =  evt.GetT(k)/2;
         const Double_t distr =  (dzy*dzy+dzx*dzx)/(dzx*dzx*rl + dzy*dzy*rw);
         if ((dzx==0 && dzy==0) || sqrt(distr)>sqrt(dist0)-dz)
             fConcCore += nphot;
@@ -227,9 +246,9 @@ void MNewImagePar::Calc(const MGeomCam &geom, const MSignalCam &evt,
         //
         // count photons in outer rings of camera
         //
-        if (gpix.IsInOutermostRing())
+        if (evt.IsInOutermostRing(k))
            edgepix1 += nphot;
-        if (gpix.IsInOuterRing())
+        if (evt.IsInOuterRing(k))
            edgepix2 += nphot;
 
         //
@@ -237,7 +256,7 @@ void MNewImagePar::Calc(const MGeomCam &geom, const MSignalCam &evt,
         // density (divide by pixel area), to find the pixel with highest signal
         // density:
         //
-        nphot *= geom.GetPixRatio(i);
+        nphot *= evt.GetRatio(k);
 
  	// Look for signal density in two highest pixels:
         if (nphot>maxpix1)
@@ -265,8 +284,8 @@ void MNewImagePar::Calc(const MGeomCam &geom, const MSignalCam &evt,
     // distance of the pixel to COG is calculated anyhow)
     //
     fConcCOG = 0;
-    for (UInt_t i=0; i<TMath::Min(3U, npix); i++)
-        fConcCOG += idx[i]<0 ? 0 : evt[idx[i]].GetNumPhotons()*geom.GetPixRatio(idx[i]);
+    for (UInt_t i=0; i<TMath::Min(3U, evt.GetNumPixels()); i++)
+        fConcCOG += idx[i]<0 ? 0 : evt.GetSignal(idx[i])*evt.GetGeomRatio(idx[i]);
     fConcCOG /= hillas.GetSize();                        // [ratio]
 
     // This can for example happen in case of Muon Rings
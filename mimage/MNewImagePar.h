@@ -8,6 +8,7 @@
 class MHillas;
 class MGeomCam;
 class MSignalCam;
+class MImagePixels;
 
 class MNewImagePar : public MParContainer
 {
@@ -51,6 +52,7 @@ public:
 
     void Calc(const MGeomCam &geom, const MSignalCam &evt,
               const MHillas &hillas, Int_t island=-1);
+    void Calc(const MImagePixels &evt, const MHillas &hillas, Int_t island=-1);
 
     ClassDef(MNewImagePar, 6) // Container to hold new image parameters
 };
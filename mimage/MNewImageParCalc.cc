@@ -26,25 +26,30 @@
 //
 // MNewImageParCalc
 //
-// Task to calculate the source dependant part of the hillas parameters
+// Task to calculate the new image parameters (MNewImagePar). The pixels
+// of the event are gathered in flat arrays (MImagePixels); the geometry
+// is copied once in ReInit.
+//
+// MHillasCalc can calculate MNewImagePar together with the other image
+// parameters from the same MImagePixels.
 //
 //////////////////////////////////////////////////////////////////////////////
 #include "MNewImageParCalc.h"
 
-#include <fstream.h>
-
 #include "MParList.h"
 
 #include "MGeomCam.h"
 #include "MSrcPosCam.h"
-#include "MCerPhotEvt.h"
-#include "MNewImagePar.h"
+#include "MSignalCam.h"
+#include "MHillas.h"
 #include "MNewImagePar.h"
 #include "MLog.h"
 #include "MLogManip.h"
 
 ClassImp(MNewImageParCalc);
 
+using namespace std;
+
 static const TString gsDefName  = "MNewImageParCalc";
 static const TString gsDefTitle = "Calculate new image parameters";
 
@@ -87,10 +92,10 @@ Int_t MNewImageParCalc::PreProcess(MParList *pList)
         return kFALSE;
     }
 
-    fCerPhotEvt = (MCerPhotEvt*)pList->FindObject("MCerPhotEvt");
+    fCerPhotEvt = (MSignalCam*)pList->FindObject("MSignalCam");
     if (!fCerPhotEvt)
     {
-        *fLog << dbginf << "MCerPhotEvt not found... aborting." << endl;
+        *fLog << dbginf << "MSignalCam not found... aborting." << endl;
         return kFALSE;
     }
 
@@ -110,12 +115,23 @@ Int_t MNewImageParCalc::PreProcess(MParList *pList)
     return kTRUE;
 }
 
+// -------------------------------------------------------------------------
+//
+// Copy the camera geometry into the flat arrays used for the calculation
+//
+Bool_t MNewImageParCalc::ReInit(MParList *pList)
+{
+    fPixels.InitGeom(*fGeomCam);
+    return kTRUE;
+}
+
 // -------------------------------------------------------------------------
 //
 Int_t MNewImageParCalc::Process()
 {
+    fPixels.Fill(*fCerPhotEvt);
 
-    /*if (!*/fNewImagePar->Calc(*fGeomCam, *fCerPhotEvt, *fHillas);/*)
+    /*if (!*/fNewImagePar->Calc(fPixels, *fHillas);/*)
     {
         fErrors++;
         return kCONTINUE;
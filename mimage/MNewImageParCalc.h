@@ -4,18 +4,23 @@
 #ifndef MARS_MTask
 #include "MTask.h"
 #endif
+#ifndef MARS_MImagePixels
+#include "MImagePixels.h"
+#endif
 
 class MHillas;
 class MNewImagePar;
 class MSrcPosCam;
 class MGeomCam;
-class MCerPhotEvt;
+class MSignalCam;
 
 class MNewImageParCalc : public MTask
 {
 private:
     MGeomCam    *fGeomCam;
-    MCerPhotEvt *fCerPhotEvt;
+    MSignalCam  *fCerPhotEvt;
+
+    MImagePixels fPixels;        //! Flat arrays of the pixels of the current event
 
     MHillas      *fHillas;       //! Pointer to the source independent hillas parameters
     MSrcPosCam   *fSrcPos;       //! Pointer to the source position
@@ -27,8 +32,9 @@ private:
 
     //Int_t       fErrors;
 
-    Int_t PreProcess(MParList *plist);
-    Int_t Process();
+    Int_t  PreProcess(MParList *plist);
+    Bool_t ReInit(MParList *plist);
+    Int_t  Process();
     //Bool_t PostProcess();
 
 public:
@@ -50,6 +50,14 @@
 //    ForceTrigger: Yes
 //
 //
+// The histograms of the photon distributions at the mirror planes
+// (Reflector, Candidates, Reflected and Focal) are only filled
+// if requested. Only then MSimReflector keeps the corresponding copies
+// of the photons. To switch them off (e.g. for production) use:
+//
+//    MirrorPlanes: Off
+//
+//
 /////////////////////////////////////////////////////////////////////////////
 #include "MJSimulation.h"
 
@@ -95,8 +103,10 @@
 #include "MSimCamera.h"
 #include "MSimTrigger.h"
 #include "MSimReadout.h"
+#include "MSimRandom.h"
 #include "MSimRandomPhotons.h"
 #include "MSimBundlePhotons.h"
+#include "MSimPhotonIndex.h"
 #include "MSimCalibrationSignal.h"
 
 // Histograms
@@ -130,6 +140,7 @@ using namespace std;
 //
 MJSimulation::MJSimulation(const char *name, const char *title)
     : fForceMode(kFALSE), fCamera(kTRUE), fForceTrigger(kFALSE),
+    fMirrorPlanes(kTRUE),
     fWriteFitsFile(kFALSE), fWritePulseTruth(kFALSE), fOperationMode(kModeData),
     fRunNumber(-1)
 {
@@ -142,6 +153,7 @@ Bool_t MJSimulation::CheckEnvLocal()
     fForceMode    = GetEnv("ForceMode",    fForceMode);
     fForceTrigger = GetEnv("ForceTrigger", fForceTrigger);
     fCamera       = GetEnv("Camera",       fCamera);
+    fMirrorPlanes = GetEnv("MirrorPlanes", fMirrorPlanes);
 
     return kTRUE;
 }
@@ -486,6 +498,11 @@ Bool_t MJSimulation::Process(const MArgs &args, const MSequence &seq)
     header.SetObservation("On", "MonteCarlo");
     plist.AddToList(&header);
 
+    // Independent random number streams for all simulation tasks
+    // (keyed by seed, task, run, event and reuse number)
+    MSimRandom random;
+    plist.AddToList(&random);
+
     // --------------------------------------------------------------------------------
     // Setup container for the intended pulse position and for the trigger position
     // --------------------------------------------------------------------------------
@@ -508,6 +525,10 @@ Bool_t MJSimulation::Process(const MArgs &args, const MSequence &seq)
     );
     plist.AddToList(&fix_time_offsets_between_pixels_in_ns);
 
+    // Library of recorded pedestal traces (optional, see MSimCamera)
+    MMatrix pedestalLibrary("PedestalLibrary", "Recorded pedestal traces");
+    plist.AddToList(&pedestalLibrary);
+
     // Jens Buss on: residual time spread
     MParameterD resTimeSpread("ResidualTimeSpread");
     resTimeSpread.SetVal(0.0);
@@ -661,6 +682,8 @@ Bool_t MJSimulation::Process(const MArgs &args, const MSequence &seq)
     // --------------------------------------------------------------------------------
     // Simulation from the SiPM to the DAQ
     // --------------------------------------------------------------------------------
+    // - MSimPhotonIndex sorts the photons by pixel (MPhotonIndex) for the
+    //   tasks simulating the pixels one after the other (MSimAPD, MSimCamera)
     // - MSimAPD simulates the whole behaviour of the SiPMs:
     //   (dead time of cells, crosstalk, afterpulses)
     // - MSimExcessNoise adds a spread on the weight of each signal in the SiPMs
@@ -678,6 +701,11 @@ Bool_t MJSimulation::Process(const MArgs &args, const MSequence &seq)
     //   position is negativ (and therefore not valid)
     // - MSimReadout simulates the behaviour of the readout:
     //   (Digitization and saturation of the ADC)
+    MSimPhotonIndex simindex1("SimPhotonIndexAPD");
+    simindex1.SetSort();
+
+    MSimPhotonIndex simindex2("SimPhotonIndexCamera");
+
     MSimAPD simapd;
     simapd.SetNameGeomCam("GeomCones");
 
@@ -938,11 +966,14 @@ Bool_t MJSimulation::Process(const MArgs &args, const MSequence &seq)
         tasks.AddToList(&reflect);  // Simulation of the reflector
         if (!header.IsPointRun())
         {
-            tasks.AddToList(&fill0);  // fill histogram task
-            //tasks.AddToList(&fill1);
-            tasks.AddToList(&fill2);  // fill histogram task
-            tasks.AddToList(&fill3);  // fill histogram task
-            tasks.AddToList(&fill4);  // fill histogram task
+            if (fMirrorPlanes)
+            {
+                tasks.AddToList(&fill0);  // fill histogram task
+                //tasks.AddToList(&fill1);
+                tasks.AddToList(&fill2);  // fill histogram task
+                tasks.AddToList(&fill3);  // fill histogram task
+                tasks.AddToList(&fill4);  // fill histogram task
+            }
             tasks.AddToList(&fillF1);  // fill histogram task
         }
         tasks.AddToList(&cones);  // angular acceptance of winston cones
@@ -970,12 +1001,14 @@ Bool_t MJSimulation::Process(const MArgs &args, const MSequence &seq)
         if (header.IsPedestalRun() || header.IsCalibrationRun())
             tasks.AddToList(&simcal);  // add calibration signal for calibration runs
         tasks.AddToList(&simnsb);  // simulate nsb and dark counts
+        tasks.AddToList(&simindex1);  // sort photons by pixel
         tasks.AddToList(&simapd);  // simulate SiPM behaviour (dead time, crosstalk ...)
         tasks.AddToList(&simexcnoise);  // add excess noise
     }
     tasks.AddToList(&simsum);  // bundle photons (NOT used in default mode)
     if (fCamera)
     {
+        tasks.AddToList(&simindex2);  // sort photons by pixel
         tasks.AddToList(&simcam);  // simulate camera behaviour (creates analog signal)
         if (header.IsDataRun() || fForceTrigger)
             tasks.AddToList(&simtrig);  // simulate trigger
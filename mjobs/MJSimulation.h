@@ -23,6 +23,7 @@ private:
 
     Bool_t fCamera;         // Switch on/off camera (for fast reflector processing)
     Bool_t fForceTrigger;   // Force the use of the trigger "electronics"
+    Bool_t fMirrorPlanes;   // Switch on/off the histograms of the mirror planes
     Bool_t fWriteFitsFile;
     Bool_t fWritePulseTruth;
 
@@ -28,6 +28,11 @@
 //
 // Program to calculate spectrum
 //
+// The run headers of the Monte Carlo files are read only once. They are
+// needed to determine the maximum impact and the energy limits of the
+// whole dataset and for the weights of each file when compiling the
+// original Monte Carlo distribution (see ReadMcRunHeaders).
+//
 /////////////////////////////////////////////////////////////////////////////
 #include "MJSpectrum.h"
 
@@ -38,8 +43,9 @@
 #include <TLine.h>
 #include <TFile.h>
 #include <TGraph.h>
-#include <TChain.h>
+#include <TTree.h>
 #include <TLatex.h>
+#include <TObjString.h>
 #include <TCanvas.h>
 #include <TObjArray.h>
 
@@ -61,6 +67,7 @@
 #include "MBinning.h"
 #include "MParameters.h"
 #include "MDataSet.h"
+#include "MMcRunHeader.hxx"
 #include "MMcCorsikaRunHeader.h"
 
 // Spectrum
@@ -98,6 +105,9 @@ MJSpectrum::MJSpectrum(const char *name, const char *title)
     fName  = name  ? name  : "MJSpectrum";
     fTitle = title ? title : "Standard program to calculate spectrum";
 
+    fMcFiles.SetOwner();
+    fMcRunHeaders.SetOwner();
+
     // Make sure that fDisplay is maintained properly
     // (i.e. removed via RecursiveRemove if closed)
     gROOT->GetListOfCleanups()->Add(this);
@@ -343,30 +353,150 @@ Float_t MJSpectrum::ReadInput(MParList &plist, TH1D &h1, TH1D &h2)
 // return maximum value of MMcRunHeader.fImpactMax stored in the RunHeaders
 // of the files from the MC dataset
 //
-Bool_t MJSpectrum::AnalyzeMC(const MDataSet &set, Float_t &impactmax, Float_t &emin/*, Float_t emax*/) const
+// --------------------------------------------------------------------------
+//
+// Read the run headers (MMcRunHeader and MMcCorsikaRunHeader) of all
+// Monte Carlo files of the dataset with a single pass over the trees
+// RunHeaders. The maximum impact, the range of the lower energy limit,
+// the number of entries and a copy of the first MMcCorsikaRunHeader of
+// each file are kept for AnalyzeMC and ReadOrigMCDistribution.
+//
+Bool_t MJSpectrum::ReadMcRunHeaders(const MDataSet &set)
 {
-    if (fDisplay)
-        fDisplay->SetStatusLine1("Analyzing Monte Carlo headers...");
+    fMcFiles.Delete();
+    fMcRunHeaders.Delete();
 
-    // ----- Create chain -----
     *fLog << inf << "Getting files... " << flush;
-    TChain chain("RunHeaders");
-    if (!set.AddFilesOn(chain))
+    MDirIter iter;
+    if (!set.AddFilesOn(iter))
         return kFALSE;
     *fLog << "done. " << endl;
 
-    *fLog << all;
-    *fLog << "Searching for maximum impact... " << flush;
-    impactmax = chain.GetMaximum("MMcRunHeader.fImpactMax");
-    *fLog << "found " << impactmax/100 << "m" << endl;
+    const Int_t tot = iter.GetNumEntries();
+
+    fMcImpactMax.Set(tot);
+    fMcELowLimMin.Set(tot);
+    fMcELowLimMax.Set(tot);
+    fMcNumRunHeaders.Set(tot);
+
+    *fLog << "Reading Monte Carlo run headers... " << flush;
+
+    Int_t n = 0;
+
+    TString fname;
+    while (n<tot)
+    {
+        // Get next filename
+        fname = iter.Next();
+        if (fname.IsNull())
+            break;
+
+        // open file
+        TFile file(fname);
+        if (file.IsZombie())
+        {
+            *fLog << err << "ERROR - Couldn't open file " << fname << endl;
+            return kFALSE;
+        }
+
+        // Get tree RunHeaders
+        TTree *rh = dynamic_cast<TTree*>(file.Get("RunHeaders"));
+        if (!rh)
+        {
+            *fLog << err << "ERROR - File " << fname << " doesn't contain tree RunHeaders." << endl;
+            return kFALSE;
+        }
+
+        MMcRunHeader        *mc   = 0;
+        MMcCorsikaRunHeader *head = 0;
+        rh->SetBranchAddress("MMcRunHeader.",        &mc);
+        rh->SetBranchAddress("MMcCorsikaRunHeader.", &head);
+
+        const Int_t num = rh->GetEntries();
+
+        Float_t impact = -FLT_MAX;
+        Float_t elow   =  FLT_MAX;
+        Float_t ehigh  = -FLT_MAX;
+
+        for (Int_t i=0; i<num; i++)
+        {
+            rh->GetEntry(i);
+            if (!mc || !head)
+            {
+                *fLog << err << "ERROR - Couldn't read MMcRunHeader/MMcCorsikaRunHeader from " << fname << "." << endl;
+                return kFALSE;
+            }
+
+            impact = TMath::Max(impact, mc->GetImpactMax());
+            elow   = TMath::Min(elow,   head->GetELowLim());
+            ehigh  = TMath::Max(ehigh,  head->GetELowLim());
+
+            // Keep a copy of the corsika run header of the first entry
+            if (i==0)
+                fMcRunHeaders.AddAtAndExpand(head->Clone(), n);
+        }
+
+        rh->ResetBranchAddresses();
+        delete mc;
+        delete head;
 
-    *fLog << "Searching for minimum lower energy limit... " << flush;
-    emin = chain.GetMinimum("MMcCorsikaRunHeader.fELowLim");
-    *fLog << "found " << emin << "GeV" << endl;
+        fMcFiles.AddAtAndExpand(new TObjString(fname), n);
+
+        fMcImpactMax[n]     = impact;
+        fMcELowLimMin[n]    = elow;
+        fMcELowLimMax[n]    = ehigh;
+        fMcNumRunHeaders[n] = num;
+
+        n++;
+    }
 
-    *fLog << "Searching for maximum lower energy limit... " << flush;
-    const Float_t emin2 = chain.GetMaximum("MMcCorsikaRunHeader.fELowLim");
-    *fLog << "found " << emin2 << "GeV" << endl;
+    *fLog << n << " files." << endl;
+
+    fMcImpactMax.Set(n);
+    fMcELowLimMin.Set(n);
+    fMcELowLimMax.Set(n);
+    fMcNumRunHeaders.Set(n);
+
+    return kTRUE;
+}
+
+// --------------------------------------------------------------------------
+//
+// Determine the maximum impact and the minimum lower energy limit of the
+// Monte Carlo dataset from the run headers (see ReadMcRunHeaders)
+//
+Bool_t MJSpectrum::AnalyzeMC(const MDataSet &set, Float_t &impactmax, Float_t &emin/*, Float_t emax*/)
+{
+    if (fDisplay)
+        fDisplay->SetStatusLine1("Analyzing Monte Carlo headers...");
+
+    if (!ReadMcRunHeaders(set))
+        return kFALSE;
+
+    impactmax = 0;
+    emin      = 0;
+
+    Float_t emin2 = 0;
+
+    Bool_t first = kTRUE;
+
+    const Int_t n = fMcImpactMax.GetSize();
+    for (Int_t i=0; i<n; i++)
+    {
+        if (fMcNumRunHeaders[i]==0)
+            continue;
+
+        impactmax = first ? fMcImpactMax[i]  : TMath::Max(impactmax, fMcImpactMax[i]);
+        emin      = first ? fMcELowLimMin[i] : TMath::Min(emin,      fMcELowLimMin[i]);
+        emin2     = first ? fMcELowLimMax[i] : TMath::Max(emin2,     fMcELowLimMax[i]);
+
+        first = kFALSE;
+    }
+
+    *fLog << all;
+    *fLog << "Maximum impact: " << impactmax/100 << "m" << endl;
+    *fLog << "Minimum lower energy limit: " << emin << "GeV" << endl;
+    *fLog << "Maximum lower energy limit: " << emin2 << "GeV" << endl;
 
     // Need a check for the upper energy LIMIT?!?
 
@@ -387,7 +517,7 @@ Bool_t MJSpectrum::AnalyzeMC(const MDataSet &set, Float_t &impactmax, Float_t &e
     return kTRUE;
 }
 
-Bool_t MJSpectrum::ReadOrigMCDistribution(const MDataSet &set, TH1 &h, MMcSpectrumWeight &weight) const
+Bool_t MJSpectrum::ReadOrigMCDistribution(const MDataSet &set, TH1 &h, MMcSpectrumWeight &weight)
 {
     // Some debug output
     *fLog << all << endl;
@@ -397,13 +527,8 @@ Bool_t MJSpectrum::ReadOrigMCDistribution(const MDataSet &set, TH1 &h, MMcSpectr
     if (!AnalyzeMC(set, impactmax, Emin))
         return kFALSE;
 
-    *fLog << inf << "Getting files... " << flush;
-    MDirIter iter;
-    if (!set.AddFilesOn(iter))
-        return kFALSE;
-    *fLog << "done. " << endl;
-
-    const Int_t tot = iter.GetNumEntries();
+    // The files have been collected by AnalyzeMC (ReadMcRunHeaders)
+    const Int_t tot = fMcFiles.GetEntriesFast();
 
     // Prepare histogram
     h.Reset();
@@ -439,17 +564,19 @@ Bool_t MJSpectrum::ReadOrigMCDistribution(const MDataSet &set, TH1 &h, MMcSpectr
     Int_t    num  = 0;
 
     // Reading this with a eventloop is five times slower :(
-    TString fname;
     while (fDisplay)
     {
         if (fDisplay)
-            fDisplay->SetProgressBarPosition(Float_t(num++)/tot);
+            fDisplay->SetProgressBarPosition(Float_t(num)/tot);
 
         // Get next filename
-        fname = iter.Next();
-        if (fname.IsNull())
+        if (num==tot)
             break;
 
+        const Int_t idx = num++;
+
+        const TString fname = fMcFiles[idx]->GetName();
+
         if (fDisplay)
             fDisplay->SetStatusLine2(fname);
 
@@ -474,28 +601,15 @@ Bool_t MJSpectrum::ReadOrigMCDistribution(const MDataSet &set, TH1 &h, MMcSpectr
             continue;
         }
 
-        // Get tree RunHeaders
-        TTree *rh = dynamic_cast<TTree*>(file.Get("RunHeaders"));
-        if (!rh)
-        {
-            *fLog << err << "ERROR - File " << fname << " doesn't contain tree RunHeaders." << endl;
-            return kFALSE;
-        }
-        if (rh->GetEntries()!=1)
+        // Get the run headers of this file (see ReadMcRunHeaders)
+        if (fMcNumRunHeaders[idx]!=1)
         {
             *fLog << err << "ERROR - RunHeaders of " << fname << " doesn't contain exactly one entry." << endl;
             return kFALSE;
         }
 
         // Get corsika run header
-        MMcCorsikaRunHeader *head=0;
-        rh->SetBranchAddress("MMcCorsikaRunHeader.", &head);
-        rh->GetEntry(0);
-        if (!head)
-        {
-            *fLog << err << "ERROR - Couldn't read MMcCorsikaRunHeader from " << fname << "." << endl;
-            return kFALSE;
-        }
+        const MMcCorsikaRunHeader *head = static_cast<MMcCorsikaRunHeader*>(fMcRunHeaders[idx]);
 
         // Get the maximum impact parameter of this file. Due to different
         // production areas an additional scale-factor is applied.
@@ -507,7 +621,7 @@ Bool_t MJSpectrum::ReadOrigMCDistribution(const MDataSet &set, TH1 &h, MMcSpectr
         // events would be better?!? (Not that the weighting might be
         // less correct with low statistics, because it could pronounce
         // a fluctuation)
-        const Double_t impact = rh->GetMaximum("MMcRunHeader.fImpactMax");
+        const Double_t impact = fMcImpactMax[idx];
         const Double_t scale  = impactmax/impact;
 
         // Propagate the run header to MMcSpectrumWeight
@@ -4,6 +4,15 @@
 #ifndef MARS_MJob
 #include <MJob.h>
 #endif
+#ifndef ROOT_TObjArray
+#include <TObjArray.h>
+#endif
+#ifndef MARS_MArrayF
+#include "MArrayF.h"
+#endif
+#ifndef MARS_MArrayI
+#include "MArrayI.h"
+#endif
 
 class TF1;
 class TH1;
@@ -39,6 +48,14 @@ private:
     Bool_t fForceRunTime;
     Bool_t fForceOnTimeFit;
 
+    // Cache of the run headers of the Monte Carlo files (see ReadMcRunHeaders)
+    TObjArray fMcFiles;          //! Names of the Monte Carlo files (TObjString)
+    TObjArray fMcRunHeaders;     //! MMcCorsikaRunHeader of the first entry of each file
+    MArrayF   fMcImpactMax;      //! Maximum impact of each file [cm]
+    MArrayF   fMcELowLimMin;     //! Minimum lower energy limit of each file [GeV]
+    MArrayF   fMcELowLimMax;     //! Maximum lower energy limit of each file [GeV]
+    MArrayI   fMcNumRunHeaders;  //! Number of entries in the RunHeaders of each file
+
     // Setup Histograms
     void SetupHistEvtDist(MHn &hist) const;
     void SetupHistEnergyEst(MHn &hist) const;
@@ -48,8 +65,9 @@ private:
     // Read Input
     Bool_t   ReadTask(MTask* &task, const char *name, Bool_t mustexist=kTRUE) const;
     Float_t  ReadInput(MParList &plist, TH1D &h1, TH1D &size);
-    Bool_t   AnalyzeMC(const MDataSet &set, Float_t &impactmax, Float_t &emin/*, Float_t emax*/) const;
-    Bool_t   ReadOrigMCDistribution(const MDataSet &set, TH1 &h, MMcSpectrumWeight &w) const;
+    Bool_t   ReadMcRunHeaders(const MDataSet &set);
+    Bool_t   AnalyzeMC(const MDataSet &set, Float_t &impactmax, Float_t &emin/*, Float_t emax*/);
+    Bool_t   ReadOrigMCDistribution(const MDataSet &set, TH1 &h, MMcSpectrumWeight &w);
     void     GetThetaDistribution(TH1D &temp1, TH2D &temp2) const;
     TString  GetHAlpha() const;
     Bool_t   Refill(MParList &plist, TH1D &h) /*const*/;
@@ -29,11 +29,16 @@
 // The intention of this class is to encode movies prepard by the
 // MMoviePrepare task.
 //
-// For writing the movies the images are converted to ppm and piped through
-// ppm2y4m to mpeg2enc. The output format is a mpeg2 movie and should
-// be within the specifications of mpeg2 for DVD. Its size is 720x480,
-// which is a good compromise between resolution and file size. The frame
-// rate is fixed to 24fps.
+// For writing the movies the images are converted to Y'CbCr 4:2:0 and
+// piped as YUV4MPEG2 stream to mpeg2enc. The output format is a mpeg2
+// movie and should be within the specifications of mpeg2 for DVD. Its
+// size is 720x480, which is a good compromise between resolution and file
+// size. The frame rate is fixed to 24fps.
+//
+// The interpolation of the frames of an event and the color conversion
+// are distributed over several threads. The rendering of the frames
+// (ROOT graphics) is done in the main thread while the previous frames
+// are converted and written (at most 16 frames are buffered).
 //
 // By changing the setup you can control the output:
 //
@@ -55,8 +60,13 @@
 //     the image. To switch off this behaviour you can set a threshold
 //     below one.
 //
-//    Filename: The output filename of the movie. If it doesn't end with ".mpg"
-//     the suffix is added.
+//    Filename: The output filename of the movie. If it ends with ".y4m"
+//     the uncompressed YUV4MPEG2 stream is written to the file (e.g. for
+//     encoding it later with another encoder). Otherwise, if it doesn't end
+//     with ".mpg" the suffix is added.
+//
+//    NumThreads: The number of threads used for interpolation and color
+//     conversion. The default (0) is the number of cores.
 //
 //  The interpolation of the frames is done using a TSpline3. If the spline
 //  would extrapolate due to the shift by the relative time calibration the
@@ -84,6 +94,11 @@
 
 #include <errno.h>
 
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <condition_variable>
+
 #include <TF1.h>
 #include <TStyle.h>
 #include <TColor.h>
@@ -93,6 +108,7 @@
 #include <TStopwatch.h>
 
 #include "MString.h"
+#include "MArrayD.h"
 
 #include "MParList.h"
 #include "MTaskList.h"
@@ -119,12 +135,284 @@ ClassImp(MMovieWrite);
 
 using namespace std;
 
+// --------------------------------------------------------------------------
+//
+// Pipeline converting the frames (argb) to Y'CbCr 4:2:0 (ITU-R BT.601,
+// 420jpeg chroma siting) and writing them as YUV4MPEG2 stream. The
+// conversion is done by several worker threads, the frames are written
+// in the order in which they were pushed by a separate thread. At most
+// kNumSlots frames are in the pipeline, Push() blocks if all slots are
+// in use.
+//
+class MMovieEncoder
+{
+private:
+    enum { kNumSlots = 16 };
+
+    enum { kFree, kPending, kConverting, kConverted };
+
+    struct Slot
+    {
+        Int_t          fState;
+        vector<UInt_t> fArgb;
+        vector<UChar_t> fYuv;
+
+        Slot() : fState(kFree) { }
+    };
+
+    FILE  *fOut;        // Output stream
+
+    UInt_t fWidth;      // Width of the frames
+    UInt_t fHeight;     // Height of the frames
+
+    Slot   fSlots[kNumSlots];
+
+    UInt_t fNumPushed;  // Number of frames pushed
+    UInt_t fNumWritten; // Number of frames written
+    UInt_t fNumStarted; // Number of frames which conversion has started
+
+    Bool_t fStop;       // Stop threads after all frames are written
+    Int_t  fErrno;      // errno of a failed write (0 if none)
+
+    mutex              fMutex;
+    condition_variable fCond;
+
+    vector<thread> fThreads;
+
+    void Convert(Slot &s) const;
+
+    void ConvertLoop();
+    void WriteLoop();
+
+public:
+    MMovieEncoder(FILE *out, Int_t nthreads);
+    ~MMovieEncoder();
+
+    Bool_t Push(const UInt_t *argb, UInt_t w, UInt_t h);
+    Int_t  Finish();
+
+    Int_t  GetErrno() const { return fErrno; }
+};
+
+// --------------------------------------------------------------------------
+//
+// Start nthreads conversion threads (the number of cores if nthreads<=0)
+// and the thread writing to out.
+//
+MMovieEncoder::MMovieEncoder(FILE *out, Int_t nthreads)
+    : fOut(out), fWidth(0), fHeight(0), fNumPushed(0), fNumWritten(0),
+    fNumStarted(0), fStop(kFALSE), fErrno(0)
+{
+    if (nthreads<=0)
+        nthreads = thread::hardware_concurrency();
+    if (nthreads<1)
+        nthreads = 1;
+
+    for (Int_t i=0; i<nthreads; i++)
+        fThreads.push_back(thread(&MMovieEncoder::ConvertLoop, this));
+
+    fThreads.push_back(thread(&MMovieEncoder::WriteLoop, this));
+}
+
+// --------------------------------------------------------------------------
+//
+// Write all pending frames and stop the threads
+//
+MMovieEncoder::~MMovieEncoder()
+{
+    Finish();
+}
+
+// --------------------------------------------------------------------------
+//
+// Wait until all pushed frames are written and stop the threads.
+// Returns the errno of a failed write (0 in case of success).
+//
+Int_t MMovieEncoder::Finish()
+{
+    {
+        lock_guard<mutex> lock(fMutex);
+        fStop = kTRUE;
+    }
+    fCond.notify_all();
+
+    for (auto it=fThreads.begin(); it!=fThreads.end(); it++)
+        it->join();
+    fThreads.clear();
+
+    return fErrno;
+}
+
+// --------------------------------------------------------------------------
+//
+// Convert the argb data of the slot to Y'CbCr 4:2:0 (studio range). The
+// chroma of each 2x2 block is calculated from the average of its pixels.
+//
+void MMovieEncoder::Convert(Slot &s) const
+{
+    const UInt_t w  = fWidth;
+    const UInt_t h  = fHeight;
+    const UInt_t cw = (w+1)/2;
+    const UInt_t ch = (h+1)/2;
+
+    s.fYuv.resize(w*h + 2*cw*ch);
+
+    UChar_t *Y  = s.fYuv.data();
+    UChar_t *Cb = Y  + w*h;
+    UChar_t *Cr = Cb + cw*ch;
+
+    const UInt_t *argb = s.fArgb.data();
+
+    for (UInt_t i=0; i<w*h; i++)
+    {
+        const Int_t r = (argb[i]>>16)&0xff;
+        const Int_t g = (argb[i]>> 8)&0xff;
+        const Int_t b =  argb[i]     &0xff;
+
+        Y[i] = (66*r + 129*g + 25*b + 128 + (16<<8))>>8;
+    }
+
+    for (UInt_t y=0; y<ch; y++)
+        for (UInt_t x=0; x<cw; x++)
+        {
+            const UInt_t x0 = 2*x;
+            const UInt_t y0 = 2*y;
+            const UInt_t x1 = TMath::Min(x0+1, w-1);
+            const UInt_t y1 = TMath::Min(y0+1, h-1);
+
+            const UInt_t p[4] = { argb[y0*w+x0], argb[y0*w+x1], argb[y1*w+x0], argb[y1*w+x1] };
+
+            Int_t r = 0;
+            Int_t g = 0;
+            Int_t b = 0;
+            for (Int_t j=0; j<4; j++)
+            {
+                r += (p[j]>>16)&0xff;
+                g += (p[j]>> 8)&0xff;
+                b +=  p[j]     &0xff;
+            }
+
+            // Sum of four pixels: divide by 4*256
+            Cb[y*cw+x] = (-38*r -  74*g + 112*b + 512 + (128<<10))>>10;
+            Cr[y*cw+x] = (112*r -  94*g -  18*b + 512 + (128<<10))>>10;
+        }
+}
+
+// --------------------------------------------------------------------------
+//
+// Worker thread: convert the pending frames in the order they were pushed
+//
+void MMovieEncoder::ConvertLoop()
+{
+    unique_lock<mutex> lock(fMutex);
+
+    while (1)
+    {
+        fCond.wait(lock, [this]{ return fNumStarted<fNumPushed || fStop; });
+
+        if (fNumStarted==fNumPushed)
+            break;
+
+        Slot &s = fSlots[fNumStarted++%kNumSlots];
+        s.fState = kConverting;
+
+        lock.unlock();
+        Convert(s);
+        lock.lock();
+
+        s.fState = kConverted;
+        fCond.notify_all();
+    }
+}
+
+// --------------------------------------------------------------------------
+//
+// Writer thread: write the converted frames in the order they were pushed.
+// The stream header is written before the first frame.
+//
+void MMovieEncoder::WriteLoop()
+{
+    unique_lock<mutex> lock(fMutex);
+
+    while (1)
+    {
+        fCond.wait(lock, [this]{ return fSlots[fNumWritten%kNumSlots].fState==kConverted || (fStop && fNumWritten==fNumPushed); });
+
+        if (fNumWritten==fNumPushed)
+            break;
+
+        Slot &s = fSlots[fNumWritten%kNumSlots];
+
+        lock.unlock();
+
+        if (fNumWritten==0)
+            fprintf(fOut, "YUV4MPEG2 W%d H%d F24:1 Ip A1:1 C420jpeg\n", fWidth, fHeight);
+
+        fputs("FRAME\n", fOut);
+        fwrite(s.fYuv.data(), s.fYuv.size(), 1, fOut);
+
+        const Int_t rc = ferror(fOut) ? errno : 0;
+
+        lock.lock();
+
+        if (rc && !fErrno)
+            fErrno = rc;
+
+        s.fState = kFree;
+        fNumWritten++;
+
+        fCond.notify_all();
+    }
+}
+
+// --------------------------------------------------------------------------
+//
+// Copy the frame into the next free slot and queue it for conversion.
+// Blocks if all slots are in use. All frames must have the same size.
+// Returns kFALSE if writing failed (see GetErrno()).
+//
+Bool_t MMovieEncoder::Push(const UInt_t *argb, UInt_t w, UInt_t h)
+{
+    unique_lock<mutex> lock(fMutex);
+
+    if (fNumPushed==0)
+    {
+        fWidth  = w;
+        fHeight = h;
+    }
+
+    if (w!=fWidth || h!=fHeight)
+    {
+        fErrno = EINVAL;
+        return kFALSE;
+    }
+
+    Slot &s = fSlots[fNumPushed%kNumSlots];
+
+    fCond.wait(lock, [&s]{ return s.fState==kFree; });
+
+    if (fErrno)
+        return kFALSE;
+
+    lock.unlock();
+    s.fArgb.assign(argb, argb+w*h);
+    lock.lock();
+
+    s.fState = kPending;
+    fNumPushed++;
+
+    fCond.notify_all();
+
+    return kTRUE;
+}
+
 // --------------------------------------------------------------------------
 //
 // Default constructor.
 //
 MMovieWrite::MMovieWrite(const char *name, const char *title)
-    : fPipe(0), fTargetLength(5), fThreshold(2), fNumEvents(25000), fFilename("movie.mpg")
+    : fPipe(0), fIsPipe(kFALSE), fEncoder(0), fTargetLength(5), fThreshold(2),
+    fNumEvents(25000), fNumThreads(0), fFilename("movie.mpg")
 {
     fName  = name  ? name  : "MMovieWrite";
     fTitle = title ? title : "Task to encode a movie";
@@ -136,22 +424,34 @@ MMovieWrite::MMovieWrite(const char *name, const char *title)
 //
 MMovieWrite::~MMovieWrite()
 {
-    if (fPipe)
-        gSystem->ClosePipe(fPipe);
+    ClosePipe();
 }
 
 // --------------------------------------------------------------------------
 //
-// Check the pipe for errors. In case of error print an error message.
-// return kFALSE in case of error, kTRUE in case of success.
+// Write all pending frames and close the pipe (or file)
 //
-Bool_t MMovieWrite::CheckPipe()
+void MMovieWrite::ClosePipe()
 {
-    if (!ferror(fPipe))
-        return kTRUE;
+    if (fEncoder)
+    {
+        const Int_t rc = fEncoder->Finish();
+        if (rc)
+            *fLog << err << "Error in pipe: " << strerror(rc) << endl;
 
-    *fLog << err << "Error in pipe: " << strerror(errno) << endl;
-    return kFALSE;
+        delete fEncoder;
+        fEncoder = 0;
+    }
+
+    if (!fPipe)
+        return;
+
+    if (fIsPipe)
+        gSystem->ClosePipe(fPipe);
+    else
+        fclose(fPipe);
+
+    fPipe = 0;
 }
 
 // --------------------------------------------------------------------------
@@ -164,9 +464,26 @@ Bool_t MMovieWrite::OpenPipe()
     //    name = Form("ppmtoy4m -B -S 420jpeg -v 0 -F %d:%d | yuv2lav -v 0 -o output%03d.avi", TMath::Nint()  TMath::Nint(fTargetLength*1000))
     //    name = "ppmtoy4m -B -F 3:1 -S 420jpeg -v 0 | yuv2lav -v 0 -o output.avi";
 
+    // Write uncompressed stream to file
+    if (fFilename.EndsWith(".y4m"))
+    {
+        fPipe = fopen(fFilename, "w");
+        if (!fPipe)
+        {
+            *fLog << err << "Cannot open file " << fFilename << ": ";
+            *fLog << strerror(errno) << endl;
+            return kFALSE;
+        }
+
+        fIsPipe  = kFALSE;
+        fEncoder = new MMovieEncoder(fPipe, fNumThreads);
+
+        *fLog << inf << "Writing YUV4MPEG2 stream to " << fFilename << "." << endl;
+        return kTRUE;
+    }
+
     TString name;
-    name  = "ppmtoy4m -B -F 24:1 -S 420jpeg -v 0 | ";
-    name += "mpeg2enc -v 0 -F 2 -I 0 -M 2 -o ";
+    name  = "mpeg2enc -v 0 -F 2 -I 0 -M 2 -o ";
     name += fFilename;
     if (!fFilename.EndsWith(".mpg"))
         name += ".mpg";
@@ -183,12 +500,14 @@ Bool_t MMovieWrite::OpenPipe()
     {
         *fLog << err;
         *fLog << "Pipe: " << name << endl;
-        *fLog << "Couldn't open pipe... aborting." << endl;
-        CheckPipe();
+        *fLog << "Couldn't open pipe: " << strerror(errno) << endl;
         return kFALSE;
     }
 
-    *fLog << inf << "Setup pipe to ppmtoy4m and mpeg2enc to encode " << fFilename << "." << endl;
+    fIsPipe  = kTRUE;
+    fEncoder = new MMovieEncoder(fPipe, fNumThreads);
+
+    *fLog << inf << "Setup pipe to mpeg2enc to encode " << fFilename << "." << endl;
 
     return kTRUE;
 
@@ -299,11 +618,7 @@ TStopwatch clockT, clock1, clock2, clock3;
 //
 Int_t MMovieWrite::PostProcess()
 {
-    if (fPipe)
-    {
-        gSystem->ClosePipe(fPipe);
-        fPipe=0;
-    }
+    ClosePipe();
 
 #ifdef USE_TIMING
     *fLog << all << endl;
@@ -471,23 +786,16 @@ void MMovieWrite::UpdateImage(TASImage &idst, TVirtualPad &pad)
 
 // --------------------------------------------------------------------------
 //
-// Write the image as ppm (raw/P6) to the pipe.
-// return kFALSE in case of error, kTRUE in case of success.
+// Queue the image for conversion and writing to the pipe (see
+// MMovieEncoder). return kFALSE in case of error, kTRUE in case of success.
 //
 Bool_t MMovieWrite::WriteImage(TASImage &img)
 {
-    // Write image header
-    fprintf(fPipe, "P6 %d %d 255\n", img.GetWidth(), img.GetHeight());
-    if (!CheckPipe())
-        return kFALSE;
-
-    // Write image data (remove alpha channel from argb data)
-    UInt_t *argb = img.GetArgbArray();
-    for (UInt_t *ptr=argb; ptr<argb+img.GetWidth()*img.GetHeight(); ptr++)
-        if (fwrite(ptr, 3, 1, fPipe)!=1)
-            break;
+    if (fEncoder->Push(img.GetArgbArray(), img.GetWidth(), img.GetHeight()))
+        return kTRUE;
 
-    return CheckPipe();
+    *fLog << err << "Error in pipe: " << strerror(fEncoder->GetErrno()) << endl;
+    return kFALSE;
 }
 
 // --------------------------------------------------------------------------
@@ -600,6 +908,59 @@ void MMovieWrite::Clean(TH1 &h, Double_t rms) const
     }
 }
 
+// --------------------------------------------------------------------------
+//
+// Interpolate the contents of all pixels in [first, last) for all frames
+// (see Interpolate)
+//
+void MMovieWrite::InterpolateRange(Double_t *frames, Int_t first, Int_t last, Int_t numframes, Float_t len) const
+{
+    const Int_t npix = fCam->GetNumPixels();
+
+    for (Int_t i=0; i<=numframes; i++)
+    {
+        // Calculate corresponding time
+        const Float_t t = len*i/numframes;// + 0.5/freq;  // Process from slice beg+0.5 to end-1.5
+
+        for (Int_t p=first; p<last; p++)
+            frames[i*npix+p] = fIn->CheckedEval(p, t);
+    }
+}
+
+// --------------------------------------------------------------------------
+//
+// Calculate the contents of all pixels for all numframes+1 frames by
+// spline interpolation and store them in frames[frame*npix+pixel].
+// The pixels are distributed in contiguous blocks over fNumThreads
+// threads.
+//
+void MMovieWrite::Interpolate(Double_t *frames, Int_t numframes, Float_t len) const
+{
+    const Int_t npix = fCam->GetNumPixels();
+
+    Int_t nthreads = fNumThreads;
+    if (nthreads<=0)
+        nthreads = thread::hardware_concurrency();
+    if (nthreads>npix)
+        nthreads = npix;
+
+    if (nthreads<=1)
+    {
+        InterpolateRange(frames, 0, npix, numframes, len);
+        return;
+    }
+
+    const Int_t step = (npix+nthreads-1)/nthreads;
+
+    vector<thread> threads;
+    for (Int_t first=0; first<npix; first+=step)
+        threads.push_back(thread(&MMovieWrite::InterpolateRange, this, frames,
+                                 first, TMath::Min(first+step, npix), numframes, len));
+
+    for (auto it=threads.begin(); it!=threads.end(); it++)
+        it->join();
+}
+
 // --------------------------------------------------------------------------
 //
 Bool_t MMovieWrite::Process(TH1 &h, TVirtualPad &c)
@@ -642,16 +1003,19 @@ Bool_t MMovieWrite::Process(TH1 &h, TVirtualPad &c)
     // Get number of pixels in camera
     const Int_t npix = fCam->GetNumPixels();
 
+    // Calculate histogram contents of all frames by spline interpolation
+    MArrayD frames((numframes+1)*npix);
+    Interpolate(frames.GetArray(), numframes, len);
+
     // Loop over all frames+1 (upper edge)
     for (Int_t i=0; i<=numframes; i++)
     {
         // Calculate corresponding time
         const Float_t t = len*i/numframes;// + 0.5/freq;  // Process from slice beg+0.5 to end-1.5
 
-        // Calculate histogram contents by spline interpolation
         for (UShort_t p=0; p<npix; p++)
         {
-            const Double_t y = (*fBad)[p].IsUnsuitable() ? 0 : fIn->CheckedEval(p, t);
+            const Double_t y = (*fBad)[p].IsUnsuitable() ? 0 : frames[i*npix+p];
             h.SetBinContent(p+1, y);
         }
 
@@ -859,6 +1223,7 @@ Int_t MMovieWrite::Process()
 //   MMovieWrite.NumEvents: 500
 //   MMovieWrite.Threshold: 2 <rms>
 //   MMovieWrite.FileName: movie.mpg
+//   MMovieWrite.NumThreads: 0
 //
 Int_t MMovieWrite::ReadEnv(const TEnv &env, TString prefix, Bool_t print)
 {
@@ -883,5 +1248,10 @@ Int_t MMovieWrite::ReadEnv(const TEnv &env, TString prefix, Bool_t print)
         fFilename = GetEnvValue(env, prefix, "FileName", fFilename);
         rc = kTRUE;
     }
+    if (IsEnvDefined(env, prefix, "NumThreads", print))
+    {
+        fNumThreads = GetEnvValue(env, prefix, "NumThreads", fNumThreads);
+        rc = kTRUE;
+    }
     return rc;
 }
@@ -16,6 +16,7 @@ class MPedestalCam;
 class MRawEvtHeader;
 class MRawRunHeader;
 class MBadPixelsCam;
+class MMovieEncoder;
 
 class MMovieWrite : public MTask
 {
@@ -30,11 +31,15 @@ private:
 
     MMovieData    *fIn;    //! Input data with splines for all pixels
 
-    FILE          *fPipe;  //! Ouput pipe to player or encoder
+    FILE          *fPipe;  //! Ouput pipe to player or encoder (or output file)
+    Bool_t         fIsPipe;//! fPipe is a pipe (not a file)
+
+    MMovieEncoder *fEncoder; //! Conversion of the frames and output to fPipe
 
     Float_t fTargetLength; // [s] Target length for stream of one event (+1 frame)
     Float_t fThreshold;    // Threshold for cleaning
     UInt_t  fNumEvents;    // Maximum number of events to encode
+    Int_t   fNumThreads;   // Number of threads for interpolation and color conversion (<=0: number of cores)
 
     TString fFilename;     // name of output file
 
@@ -48,7 +53,7 @@ private:
 
     // MMovieWrite
     Bool_t OpenPipe();
-    Bool_t CheckPipe();
+    void   ClosePipe();
 
     Double_t GetMedianPedestalRms() const;
 
@@ -64,6 +69,9 @@ private:
     Bool_t WriteImage(TASImage &img, TVirtualPad &pad);
     //Bool_t WriteImage(TVirtualPad &pad);
 
+    void InterpolateRange(Double_t *frames, Int_t first, Int_t last, Int_t numframes, Float_t len) const;
+    void Interpolate(Double_t *frames, Int_t numframes, Float_t len) const;
+
     Bool_t Process(TH1 &h, TVirtualPad &c);
 
 public:
@@ -74,6 +82,7 @@ public:
     void SetNumEvents(Int_t n) { fNumEvents = n; }
     void SetThreshold(Float_t f) { fThreshold = f; }
     void SetTargetLength(Float_t l) { fTargetLength = l; }
+    void SetNumThreads(Int_t n=0) { fNumThreads = n; }
 
     ClassDef(MMovieWrite, 0) // Task to encode a movie
 };
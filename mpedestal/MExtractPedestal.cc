@@ -146,6 +146,15 @@
 //          the results from the signal extractor, a different named MPedestalCam
 //          can be created with the function: SetNamePedestalOut(). 
 //
+//  Without extractor the sums of the slices are accumulated as integers
+//  so that the results are exact independent of the number of events.
+//
+//  Intermediate results can be published every n events with
+//  SetNumEventsPublish(n). The results are then calculated from the
+//  accumulated sums (MPedestalCam is updated and set ReadyToSave) without
+//  touching the already processed events again. This allows to update
+//  the pedestals cheaply for every pedestal event in an online analysis.
+//
 //  See also: MPedestalCam, MPedestalPix, MPedCalcPedRun, MPedCalcFromLoGain
 //
 /////////////////////////////////////////////////////////////////////////////
@@ -195,7 +204,7 @@ MExtractPedestal::MExtractPedestal(const char *name, const char *title)
     : fGeom(NULL), fPedestalsInter(NULL),
     fPedestalsOut(NULL), fExtractor(NULL), fSignal(0),
     fExtractWinFirst(0), fExtractWinSize(0), fUseSpecialPixels(kFALSE),
-    fCounter(0)
+    fCounter(0), fNumEventsPublish(0), fLastPublish(0)
 {
     fName  = name  ? name  : "MExtractPedestal";
     fTitle = title ? title : "Base class to calculate pedestals";
@@ -223,8 +232,10 @@ void MExtractPedestal::ResetArrays()
     // Reset contents of arrays.
     fSumx.Reset();
     fSumx2.Reset();
-    fSumAB0.Reset();
-    fSumAB1.Reset();
+    fSumI.assign(fSumI.size(), 0);
+    fSumI2.assign(fSumI2.size(), 0);
+    fSumAB0.assign(fSumAB0.size(), 0);
+    fSumAB1.assign(fSumAB1.size(), 0);
     fAreaSumx.Reset();
     fAreaSumx2.Reset();
     fAreaSumAB0.Reset();
@@ -466,7 +477,8 @@ Int_t MExtractPedestal::PreProcess(MParList *pList)
           return kFALSE;
   }
 
-  fCounter = 0;
+  fCounter     = 0;
+  fLastPublish = 0;
 
   return fExtractor ? fExtractor->CallPreProcess(pList) : kTRUE;
 }
@@ -476,6 +488,9 @@ Int_t MExtractPedestal::PreProcess(MParList *pList)
 // Call Calc(). If fExtractor!=NULL enclose the call in setting the
 // NoiseCalculation to fRandomCalculation
 //
+// If fNumEventsPublish>0 the intermediate results are published every
+// fNumEventsPublish processed events (see Publish())
+//
 Int_t MExtractPedestal::Process()
 {
     //
@@ -495,6 +510,12 @@ Int_t MExtractPedestal::Process()
 
     fPedestalsOut->SetNumEvents(fCounter);
 
+    if (fNumEventsPublish>0 && fCounter>=fLastPublish+fNumEventsPublish)
+    {
+        Publish();
+        fLastPublish = fCounter;
+    }
+
     return kTRUE;
 }
 
@@ -539,8 +560,11 @@ Bool_t MExtractPedestal::ReInit(MParList *pList)
 
         fSumx.  Set(npixels);
         fSumx2. Set(npixels);
-        fSumAB0.Set(npixels);
-        fSumAB1.Set(npixels);
+
+        fSumI.  assign(npixels, 0);
+        fSumI2. assign(npixels, 0);
+        fSumAB0.assign(npixels, 0);
+        fSumAB1.assign(npixels, 0);
 
         fNumEventsUsed.Set(npixels);
 
@@ -702,26 +726,40 @@ Float_t MExtractPedestal::CalcExtractor(const MRawEvtPixelIter &pixel, Int_t off
 // returned. ab0 and ab1 will contain the total sum splitted by the
 // AB-flag. If the AB-flag is invalid ab0=ab1=0 is returned.
 //
+// The even and odd slices are summed independently of the AB-flag
+// (which allows the compiler to vectorize the loop). They are assigned
+// to ab0 and ab1 afterwards according to the AB-flag and the parity
+// of the first slice.
+//
 UInt_t MExtractPedestal::CalcSums(const MRawEvtPixelIter &pixel, Int_t offset, UInt_t &ab0, UInt_t &ab1) const
 {
     const Int_t first = fExtractWinFirst+offset;
+    const Int_t num   = fExtractWinSize;
 
-    USample_t *ptr = fSignal->GetSamplesRaw(pixel.GetPixelId())+first;
-    USample_t *end = ptr + fExtractWinSize;
+    const USample_t *ptr = fSignal->GetSamplesRaw(pixel.GetPixelId())+first;
 
-    Int_t abflag = pixel.HasABFlag() + first;
+    UInt_t even = 0;
+    UInt_t odd  = 0;
 
-    UInt_t ab[2] = { 0, 0 };
-    while (ptr<end)
-        ab[abflag++ & 0x1] += *ptr++;
+    Int_t i=0;
+    for (; i<num-1; i+=2)
+    {
+        even += ptr[i];
+        odd  += ptr[i+1];
+    }
+    if (i<num)
+        even += ptr[i];
+
+    // The slice i belongs to ab[(abflag+first+i)&1]
+    const Bool_t swap = ((pixel.HasABFlag()+first)&1)==1;
 
     // This check if for old data without AB-Flag in the data
     const Bool_t valid = pixel.IsABFlagValid();
 
-    ab0 = valid ? ab[0] : 0;
-    ab1 = valid ? ab[1] : 0;
+    ab0 = valid ? (swap ? odd  : even) : 0;
+    ab1 = valid ? (swap ? even : odd)  : 0;
 
-    return ab[0]+ab[1];
+    return even+odd;
 }
 
 // ---------------------------------------------------------------------------------
@@ -738,27 +776,36 @@ Bool_t MExtractPedestal::CalcPixel(const MRawEvtPixelIter &pixel, Int_t offset,
         return kFALSE;
 
     //extract pedestal
-    UInt_t ab[2];
-    const Float_t sum = fExtractor ?
-        CalcExtractor(pixel, offset) :
-        CalcSums(pixel, offset, ab[0], ab[1]);
+    UInt_t ab[2] = { 0, 0 };
+    Float_t sum = 0;
+
+    if (fExtractor)
+    {
+        sum = CalcExtractor(pixel, offset);
+
+        fSumx[idx]  += sum;
+        fSumx2[idx] += sum*sum;
+    }
+    else
+    {
+        // Accumulate the integer sum of the slices exactly
+        const UInt_t isum = CalcSums(pixel, offset, ab[0], ab[1]);
+
+        fSumI[idx]   += isum;
+        fSumI2[idx]  += ULong64_t(isum)*isum;
+        fSumAB0[idx] += ab[0];
+        fSumAB1[idx] += ab[1];
+
+        sum = isum;
+    }
 
     if (fIntermediateStorage)
         (*fPedestalsInter)[idx].Set(sum, 0, 0, fNumEventsUsed[idx]);
 
     const Double_t sqrsum = sum*sum;
 
-    fSumx[idx]  += sum;
-    fSumx2[idx] += sqrsum;
-
     fNumEventsUsed[idx]++;
 
-    if (!fExtractor && pixel.IsABFlagValid())
-    {
-        fSumAB0[idx] += ab[0];
-        fSumAB1[idx] += ab[1];
-    }
-
     if (usespecialpixels)
         return kTRUE;
 
@@ -777,8 +824,8 @@ Bool_t MExtractPedestal::CalcPixel(const MRawEvtPixelIter &pixel, Int_t offset,
     {
         fAreaSumAB0[aidx]   += ab[0];
         fAreaSumAB1[aidx]   += ab[1];
-        fSectorSumAB0[aidx] += ab[0];
-        fSectorSumAB1[aidx] += ab[1];
+        fSectorSumAB0[sector] += ab[0];
+        fSectorSumAB1[sector] += ab[1];
     }
 
     return kTRUE;
@@ -800,8 +847,8 @@ void MExtractPedestal::CalcPixResults(const UInt_t pixid)
     if (nevts<2)
         return;
 
-    const Double_t sum  = fSumx[pixid];
-    const Double_t sum2 = fSumx2[pixid];
+    const Double_t sum  = fExtractor ? fSumx[pixid]  : Double_t(fSumI[pixid]);
+    const Double_t sum2 = fExtractor ? fSumx2[pixid] : Double_t(fSumI2[pixid]);
 
     // 1. Calculate the mean of the sums:
     Double_t ped = sum/nevts;
@@ -810,7 +857,7 @@ void MExtractPedestal::CalcPixResults(const UInt_t pixid)
     Double_t var = (sum2-sum*sum/nevts)/(nevts-1.);
 
     // 3. Calculate the amplitude of the 150MHz "AB" noise
-    Double_t abOffs = (fSumAB0[pixid] - fSumAB1[pixid]) / nevts;
+    Double_t abOffs = (Double_t(fSumAB0[pixid]) - Double_t(fSumAB1[pixid])) / nevts;
 
     // 4. Scale the mean, variance and AB-noise to the number of slices:
     ped    /= fExtractor ? fExtractor->GetNumHiGainSamples() : fExtractWinSize;
@@ -944,6 +991,41 @@ void MExtractPedestal::CalcSectorResults(const UInt_t sector)
     fPedestalsOut->GetAverageSector(sector).Set(ped, rms, abOffs, nevts);
 }
 
+// --------------------------------------------------------------------------
+//
+// Reset the accumulated sums and the number of used events of pixel pixid
+//
+void MExtractPedestal::ResetPixel(const UInt_t pixid)
+{
+    fNumEventsUsed[pixid] = 0;
+
+    fSumx[pixid]   = 0;
+    fSumx2[pixid]  = 0;
+    fSumI[pixid]   = 0;
+    fSumI2[pixid]  = 0;
+    fSumAB0[pixid] = 0;
+    fSumAB1[pixid] = 0;
+}
+
+// --------------------------------------------------------------------------
+//
+// Calculate the results from the sums accumulated so far and store them
+// in the output MPedestalCam. Nothing is recomputed from the events, the
+// accumulated sums stay untouched.
+//
+void MExtractPedestal::Publish()
+{
+    CalcPixResult();
+
+    if (!fUseSpecialPixels)
+    {
+        CalcAreaResult();
+        CalcSectorResult();
+    }
+
+    fPedestalsOut->SetReadyToSave();
+}
+
 // --------------------------------------------------------------------------
 //
 // Loop over the pixels to get the averaged pedestal
@@ -992,6 +1074,8 @@ void MExtractPedestal::Print(Option_t *o) const
     *fLog << "CheckWindow from slice " << fCheckWinFirst   << " to " << fCheckWinLast << " incl." << endl;
     *fLog << "Max.allowed signal variation: " << fMaxSignalVar << endl;
     *fLog << "Max.allowed signal absolute:  " << fMaxSignalAbs << endl;
+    if (fNumEventsPublish>0)
+        *fLog << "Publish results every:        " << fNumEventsPublish << " events" << endl;
 }
 
 // --------------------------------------------------------------------------
@@ -1001,6 +1085,7 @@ void MExtractPedestal::Print(Option_t *o) const
 //    ExtractWindowSize:      6
 //    PedestalUpdate:       yes
 //    RandomCalculation:    yes
+//    NumEventsPublish:       0
 //
 Int_t MExtractPedestal::ReadEnv(const TEnv &env, TString prefix, Bool_t print)
 {
@@ -1071,6 +1156,13 @@ Int_t MExtractPedestal::ReadEnv(const TEnv &env, TString prefix, Bool_t print)
         rc = kTRUE;
     }
 
+    // find resource for the interval of intermediate results
+    if (IsEnvDefined(env, prefix, "NumEventsPublish", print))
+    {
+        SetNumEventsPublish(GetEnvValue(env, prefix, "NumEventsPublish", (Int_t)fNumEventsPublish));
+        rc = kTRUE;
+    }
+
     // find resource for MPedestalCam
     if (IsEnvDefined(env, prefix, "NamePedestalCamInter", print))
     {
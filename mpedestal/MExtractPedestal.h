@@ -1,6 +1,8 @@
 #ifndef MARS_MExtractPedestal
 #define MARS_MExtractPedestal
 
+#include <vector>
+
 #ifndef MARS_MTask
 #include "MTask.h"
 #endif
@@ -70,10 +72,12 @@ protected:
 
   Bool_t  fUseSpecialPixels;         // Flag if the special pixels shall be treated
 
-  MArrayD fSumx;                     // sum of values
-  MArrayD fSumx2;                    // sum of squared values
-  MArrayD fSumAB0;                   // sum of ABFlag=0 slices
-  MArrayD fSumAB1;                   // sum of ABFlag=1 slices
+  MArrayD fSumx;                     // sum of values (extractor)
+  MArrayD fSumx2;                    // sum of squared values (extractor)
+  std::vector<ULong64_t> fSumI;      //! exact sum of values (sum of slices)
+  std::vector<ULong64_t> fSumI2;     //! exact sum of squared values (sum of slices)
+  std::vector<ULong64_t> fSumAB0;    //! sum of ABFlag=0 slices
+  std::vector<ULong64_t> fSumAB1;    //! sum of ABFlag=1 slices
   MArrayD fAreaSumx;                 // averaged sum of values per area idx
   MArrayD fAreaSumx2;                // averaged sum of squared values per area idx
   MArrayD fAreaSumAB0;               // averaged sum of ABFlag=0 slices per area idx
@@ -91,6 +95,9 @@ protected:
 
   UInt_t  fCounter;                  // Counter for events processed
 
+  UInt_t  fNumEventsPublish;         // Publish intermediate results every n events (0: off)
+  UInt_t  fLastPublish;              //! Value of fCounter at the last publication
+
   // MTask virtual functions
   Int_t  PreProcess(MParList *pList);
   Int_t  Process();
@@ -109,6 +116,9 @@ protected:
   void CalcSectorResult();
   void CalcAreaResult();
 
+  void ResetPixel(const UInt_t pixid);
+  void Publish();
+
   Bool_t  CalcPixel(const MRawEvtPixelIter &pixel, Int_t offset, UInt_t usespecialpixels=kFALSE);
   Float_t CalcExtractor(const MRawEvtPixelIter &pixel, Int_t offset) const;
   UInt_t  CalcSums(const MRawEvtPixelIter &pixel, Int_t offset, UInt_t &ab0, UInt_t &ab1) const;
@@ -133,6 +143,8 @@ public:
   void SetMaxSignalVar(UShort_t maxvar=40)   { fMaxSignalVar = maxvar; }
   void SetMaxSignalAbs(UShort_t maxabs=250)  { fMaxSignalAbs = maxabs; }
 
+  void SetNumEventsPublish(UInt_t n=0)       { fNumEventsPublish = n; }
+
   // names
   void SetNamePedestalCamInter(const char *name=fgNamePedestalCam) { fNamePedestalCamInter = name; }
   void SetNamePedestalCamOut  (const char *name=fgNamePedestalCam) { fNamePedestalCamOut   = name; }
@@ -215,12 +215,7 @@ void MPedCalcFromLoGain::Calc()
             continue;
 
         CalcPixResults(idx);
-
-        fNumEventsUsed[idx]=0;
-        fSumx[idx]=0;
-        fSumx2[idx]=0;
-        fSumAB0[idx]=0;
-        fSumAB1[idx]=0;
+        ResetPixel(idx);
     }
 
     if (fNumAreasDump>0 && !(GetNumExecutions() % fNumAreasDump))
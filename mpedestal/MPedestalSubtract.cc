@@ -30,6 +30,10 @@
 //  subtracts the pedestal (including the AB-offset) from the
 //  data and stores the result in MPedestalSubtractedEvt.
 //
+//  If requested by the extractor (MPedestalSubtractedEvt::SetScanRange)
+//  the position of the maximum, the raw maximum and the saturation
+//  in the extraction range are determined in the same pass.
+//
 // Input Containers:
 //   MRawEvtData
 //   MRawRunHeader
@@ -152,6 +156,24 @@ Bool_t MPedestalSubtract::ReInit(MParList *pList)
 
 // --------------------------------------------------------------------------
 //
+// Convert the raw samples [first, last) into floats and subtract the
+// pedestal. The pedestal is alternating between mean[0] and mean[1]
+// (AB-offset) starting with mean[0] in the first slice of the pixel.
+//
+void MPedestalSubtract::Subtract(Float_t *beg, const USample_t *src, Int_t first, Int_t last, Float_t div, const Float_t *mean) const
+{
+    for (Int_t i=first; i<last; i++)
+        beg[i] = Float_t(src[i])/div - mean[i&1];
+}
+
+// --------------------------------------------------------------------------
+//
+// Merge the hi- and lo-gain samples, convert them to floats and subtract
+// the pedestal.
+//
+// If a scan range is set in MPedestalSubtractedEvt the position of the
+// maximum, the raw maximum and the saturating slices in this range are
+// determined in the same pass and stored in MPedestalSubtractedEvt.
 //
 Int_t MPedestalSubtract::Process()
 {
@@ -187,6 +209,15 @@ Int_t MPedestalSubtract::Process()
     // initialize fSignal
     fSignal->InitSamples(numh+numl);//, fRawEvt->GetNumPixels(), numh+numl);
 
+    // Range in which maximum and saturation are determined while
+    // the samples are converted (see MPedestalSubtractedEvt::SetScanRange)
+    const Int_t  nums  = fSignal->GetNumSamples();
+    const Int_t  first = fSignal->GetScanFirst();
+    const Int_t  last  = fSignal->GetScanLast();
+    const UInt_t limit = fSignal->GetScanLimit();
+
+    const Bool_t doscan = first>=0 && first<=last && last<nums;
+
     // iterate over all pixels
     MRawEvtPixelIter pixel(fRawEvt);
     while (pixel.Next())
@@ -207,38 +238,77 @@ Int_t MPedestalSubtract::Process()
         Memcpy(sample,      pixel.GetHiGainSamples(), numh);
         Memcpy(sample+numh, pixel.GetLoGainSamples(), numl);
 
-        // start of destination array, end of hi-gain destination array
-        // and start of hi-gain samples
+        // start of destination array and start of raw samples
         Float_t *beg = fSignal->GetSamples(pixidx);
-        Float_t *end = beg + fSignal->GetNumSamples();
 
         const USample_t *src = sample;
 
         // if no pedestals are given just convert the data into
-        // floats and we are finished
-        if (!fPedestals)
+        // floats (no scaling, no offset)
+        Float_t div     = 1;
+        Float_t mean[2] = { 0, 0 };
+
+        if (fPedestals)
+        {
+            // get pedestal information for this pixel
+            const MPedestalPix &pedpix = (*fPedestals)[pixidx];
+
+            // pedestal information
+            const Int_t   ab  = pixel.HasABFlag() ? 1 : 0;
+            const Float_t ped = pedpix.GetPedestal();
+
+            // determine with which pedestal (+/- AB offset) to start
+            const Bool_t  swap = (ab&1)==1;
+            const Float_t offh = swap ? -pedpix.GetPedestalABoffset() : pedpix.GetPedestalABoffset();
+
+            div     = scale;
+            mean[0] = ped + offh;
+            mean[1] = ped - offh;
+        }
+
+        // Copy samples into array and substract pedestal
+        // FIXME: Shell we really subtract the pedestal from saturating slices???
+        if (!doscan)
         {
-            while (beg<end)
-                *beg++ = *src++;//Float_t(*src++)/scale;
+            Subtract(beg, src, 0, nums, div, mean);
             continue;
         }
 
-        // get pedestal information for this pixel
-        const MPedestalPix &pedpix = (*fPedestals)[pixidx];
+        // Convert the samples in front of the scan range, the scan range
+        // itself (and determine maximum and saturation in the same pass)
+        // and the samples behind the scan range.
+        Subtract(beg, src, 0, first, div, mean);
 
-        // pedestal information
-        const Int_t   ab  = pixel.HasABFlag() ? 1 : 0;
-        const Float_t ped = pedpix.GetPedestal();
+        Int_t    maxpos = first;
+        USample_t rawmax = src[first];
+        Int_t    numsat = 0;
+        Int_t    sat0   = -1;
+        Int_t    sat1   = -1;
 
-        // determine with which pedestal (+/- AB offset) to start
-        const Bool_t  swap    = (ab&1)==1;
-        const Float_t offh    = swap ? -pedpix.GetPedestalABoffset() : pedpix.GetPedestalABoffset();
-        const Float_t mean[2] = { ped + offh, ped - offh };
+        for (Int_t i=first; i<=last; i++)
+        {
+            const USample_t raw = src[i];
 
-        // Copy hi-gains into array and substract pedestal
-        // FIXME: Shell we really subtract the pedestal from saturating slices???
-        for (Float_t *ptr=beg; ptr<end; ptr++)
-            *ptr = Float_t(*src++)/scale - mean[(ptr-beg)&1];
+            beg[i] = Float_t(raw)/div - mean[i&1];
+
+            if (beg[i]>beg[maxpos])
+                maxpos = i;
+
+            if (raw>rawmax)
+                rawmax = raw;
+
+            if (raw>=limit)
+            {
+                if (sat0<0)
+                    sat0 = i;
+                sat1 = i;
+                numsat++;
+            }
+        }
+
+        Subtract(beg, src, last+1, nums, div, mean);
+
+        fSignal->SetScanResult(pixidx, maxpos-first, rawmax, numsat, sat0, sat1);
     }
 
     return kTRUE;
@@ -10,6 +10,8 @@ class MRawEvtData;
 class MPedestalCam;
 class MPedestalSubtractedEvt;
 
+typedef UShort_t USample_t;
+
 class MPedestalSubtract : public MTask
 {
 private:
@@ -29,6 +31,7 @@ private:
     Int_t  Process();
 
     void Memcpy(void *sample, void *ptr, Int_t cnt) const;
+    void Subtract(Float_t *beg, const USample_t *src, Int_t first, Int_t last, Float_t div, const Float_t *mean) const;
 
 public:
     MPedestalSubtract(const char *name=NULL, const char *title=NULL);
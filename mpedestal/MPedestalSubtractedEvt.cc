@@ -28,6 +28,14 @@
 //
 //  Storage container to store the raw FADC values.
 //
+//  If a scan range is set (SetScanRange) the task filling the samples
+//  (MPedestalSubtract) determines in the same pass the position of the
+//  pedestal subtracted maximum, the raw maximum and the saturating
+//  slices in this range. The extractors can then retrieve these values
+//  (HasScan, GetScanMaxPos, GetScanRawMax, GetScanSaturation) instead
+//  of scanning the samples again with GetMaxPos, GetRawMaxVal and
+//  GetSaturation.
+//
 /////////////////////////////////////////////////////////////////////////////
 #include "MPedestalSubtractedEvt.h"
 
@@ -47,6 +55,9 @@ using namespace std;
 //
 // And reset its contents to 0.
 //
+// If a scan range is set the arrays for the scan results are
+// initialized accordingly.
+//
 void MPedestalSubtractedEvt::InitSamples(UInt_t samples, UInt_t pixels)
 {
     fNumSamples = samples;
@@ -59,6 +70,21 @@ void MPedestalSubtractedEvt::InitSamples(UInt_t samples, UInt_t pixels)
 
     fSamples.Reset();
     fSamplesRaw.Reset();
+
+    if (fScanFirst<0)
+        return;
+
+    fScanMaxPos.Set(fNumPixels);
+    fScanRawMax.Set(fNumPixels);
+    fScanNumSat.Set(fNumPixels);
+    fScanSat0.Set(fNumPixels);
+    fScanSat1.Set(fNumPixels);
+
+    fScanMaxPos.Reset();
+    fScanRawMax.Reset();
+    fScanNumSat.Reset();
+    fScanSat0.Reset(-1);
+    fScanSat1.Reset(-1);
 }
 
 // --------------------------------------------------------------------------
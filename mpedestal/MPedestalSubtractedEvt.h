@@ -13,6 +13,9 @@
 #ifndef MARS_MArrayS
 #include "MArrayS.h"
 #endif
+#ifndef MARS_MArrayI
+#include "MArrayI.h"
+#endif
 
 typedef UShort_t USample_t;
 
@@ -25,9 +28,19 @@ private:
     UInt_t fNumSamples;       // number of samples per pixel
     UInt_t fNumPixels;        // number of pixels
 
+    Int_t  fScanFirst;        //! First slice of the scan range (<0: no scan)
+    Int_t  fScanLast;         //! Last slice of the scan range
+    UInt_t fScanLimit;        //! Saturation limit (raw) used in the scan
+
+    MArrayS fScanMaxPos;      //! Position of pedestal subtracted maximum w.r.t. fScanFirst
+    MArrayS fScanRawMax;      //! Raw maximum in the scan range
+    MArrayS fScanNumSat;      //! Number of saturating slices in the scan range
+    MArrayI fScanSat0;        //! First saturating slice (-1 if none)
+    MArrayI fScanSat1;        //! Last  saturating slice (-1 if none)
+
 public:
     MPedestalSubtractedEvt(const char *name=NULL, const char *title=NULL)
-        : fNumSamples(0), fNumPixels(0)
+        : fNumSamples(0), fNumPixels(0), fScanFirst(-1), fScanLast(-1), fScanLimit(0)
     {
         fName = name ? name : "MPedestalSubtractedEvt";
         fTitle = title ? title : "";
@@ -42,6 +55,43 @@ public:
     UInt_t   GetNumSamples() const { return fNumSamples; }
     UShort_t GetNumPixels() const  { return fNumPixels; }
 
+    // Scan of maximum and saturation done while filling the samples
+    void SetScanRange(Int_t first, Int_t last, UInt_t limit)
+    {
+        fScanFirst = first;
+        fScanLast  = last;
+        fScanLimit = limit;
+    }
+    void ResetScanRange() { fScanFirst = -1; }
+
+    Int_t  GetScanFirst() const { return fScanFirst; }
+    Int_t  GetScanLast() const  { return fScanLast; }
+    UInt_t GetScanLimit() const { return fScanLimit; }
+
+    Bool_t HasScan(Int_t first, Int_t last, UInt_t limit) const
+    {
+        return fScanFirst>=0 && fScanFirst==first && fScanLast==last && fScanLimit==limit &&
+            fScanLast<(Int_t)fNumSamples && fScanMaxPos.GetSize()==fNumPixels;
+    }
+
+    void SetScanResult(UInt_t idx, Int_t maxpos, UInt_t rawmax, Int_t num, Int_t sat0, Int_t sat1)
+    {
+        fScanMaxPos[idx] = maxpos;
+        fScanRawMax[idx] = rawmax;
+        fScanNumSat[idx] = num;
+        fScanSat0[idx]   = sat0;
+        fScanSat1[idx]   = sat1;
+    }
+
+    Int_t  GetScanMaxPos(UInt_t idx) const { return fScanMaxPos[idx]; }
+    UInt_t GetScanRawMax(UInt_t idx) const { return fScanRawMax[idx]; }
+    Int_t  GetScanSaturation(UInt_t idx, Int_t &first, Int_t &last) const
+    {
+        first = fScanSat0[idx];
+        last  = fScanSat1[idx];
+        return fScanNumSat[idx];
+    }
+
     Int_t GetSaturation(const Int_t idx, Int_t limit, Int_t &first, Int_t &last) const;
     //void  InterpolateSaturation(const Int_t idx, Int_t limit, Int_t first, Int_t last) const;
 
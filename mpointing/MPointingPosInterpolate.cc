@@ -29,6 +29,13 @@
 //   In the PreProcess, read the drive report and store it in an TSpline.
 //   In the Process, use the TSpline to calculate the PointingPos for the 
 //   time of the current event.
+//
+//   The splines are evaluated with MSpline3::EvalFast, which starts the
+//   search for the knot at the knot found for the previous event. Since
+//   the events are ordered in time this takes constant time per event.
+//   The azimuth is unwrapped before the spline is build, so that a jump
+//   between 360deg and 0deg is not interpolated. In this case the
+//   interpolated azimuth is returned in the range [0, 360).
 // 
 //  Input Containers:
 //    MRawEvtData
@@ -47,7 +54,7 @@
 #include "MLog.h"
 #include "MLogManip.h"
 
-#include <TSpline.h>
+#include "MSpline3.h"
 
 #include "MTaskList.h"
 #include "MParList.h"
@@ -72,7 +79,8 @@ const Int_t MPointingPosInterpolate::fgNumStartEvents = 1;
 //
 MPointingPosInterpolate::MPointingPosInterpolate(const char *name, const char *title)
   : fEvtTime(NULL), fPointingPos(NULL), fRunHeader(NULL), fDirIter(NULL), 
-    fSplineZd(NULL), fSplineAz(NULL), fRa(0.), fDec(0.),
+    fSplineZd(NULL), fSplineAz(NULL), fCursor(0), fAzWrapped(kFALSE),
+    fRa(0.), fDec(0.),
     fTimeMode(MPointingPosInterpolate::kEventTime)
 
 {
@@ -97,6 +105,9 @@ void MPointingPosInterpolate::Clear(Option_t *o)
     delete fSplineZd;
   if(fSplineAz)
     delete fSplineAz;
+
+  fSplineZd = NULL;
+  fSplineAz = NULL;
 }
 
 // ---------------------------------------------------------------------------
@@ -215,10 +226,28 @@ Bool_t MPointingPosInterpolate::ReadDriveReport()
 		<< nominalZd[i] << " " << nominalAz[i]  << endl;
       }
 
-    fSplineZd = new TSpline3("zenith",
-			     reportTime.GetArray(), nominalZd.GetArray(), n-1);
-    fSplineAz = new TSpline3("azimuth",
-			     reportTime.GetArray(), nominalAz.GetArray(), n-1);
+    //
+    // Unwrap the azimuth, such that the spline doesn't interpolate
+    // across a jump between 360deg and 0deg
+    //
+    fAzWrapped = kFALSE;
+    for (int i=1; i<n-1; i++)
+      {
+	const Double_t d = nominalAz[i]-nominalAz[i-1];
+	if (TMath::Abs(d)<=180)
+	  continue;
+
+	nominalAz[i] -= TMath::Nint(d/360)*360;
+	fAzWrapped = kTRUE;
+      }
+
+    fSplineZd = new MSpline3(reportTime.GetArray(), nominalZd.GetArray(), n-1);
+    fSplineAz = new MSpline3(reportTime.GetArray(), nominalAz.GetArray(), n-1);
+
+    fSplineZd->SetTitle("zenith");
+    fSplineAz->SetTitle("azimuth");
+
+    fCursor = 0;
 
     
     if (fDebug)
@@ -285,6 +314,40 @@ Int_t MPointingPosInterpolate::PreProcess( MParList *pList )
 }
 
 
+// --------------------------------------------------------------------------
+//
+//  If the azimuth was unwrapped return az in the range [0, 360)
+//
+Double_t MPointingPosInterpolate::WrapAz(Double_t az) const
+{
+  if (!fAzWrapped)
+    return az;
+
+  return az - TMath::Floor(az/360)*360;
+}
+
+// --------------------------------------------------------------------------
+//
+//  Interpolate the pointing position (zd, az) for the given time
+//  [ms, see MTime::GetTime]. ReadDriveReport must have been called.
+//
+void MPointingPosInterpolate::Eval(Double_t time, Double_t &zd, Double_t &az)
+{
+  zd = fSplineZd->EvalFast(time, fCursor);
+  az = WrapAz(fSplineAz->EvalFast(time, fCursor));
+}
+
+// --------------------------------------------------------------------------
+//
+//  Interpolate the pointing positions for n times at once, see Eval.
+//  Times in ascending order give the best performance.
+//
+void MPointingPosInterpolate::Eval(Int_t n, const Double_t *time, Double_t *zd, Double_t *az)
+{
+  for (Int_t i=0; i<n; i++)
+    Eval(time[i], zd[i], az[i]);
+}
+
 // --------------------------------------------------------------------------
 //
 //  Get the run start time, and get the pointing position for that time
@@ -363,8 +426,8 @@ Int_t MPointingPosInterpolate::Process()
 	return kERROR;
     }
 
-    const Double_t zd = fSplineZd->Eval( time );
-    const Double_t az = fSplineAz->Eval( time );
+    Double_t zd, az;
+    Eval(time, zd, az);
 
     if(TMath::Abs(zd)>90 || TMath::Abs(az)>360)
       {
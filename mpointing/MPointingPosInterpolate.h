@@ -5,15 +5,12 @@
 #include "MTask.h"
 #endif
 
-#ifndef ROOT_TSpline
-#include <TSpline.h>
-#endif
-
 #ifndef MARS_MTime
 #include "MTime.h"
 #endif
 
 class MTime;
+class MSpline3;
 class MPointingPos;
 class MRawRunHeader;
 class MDirIter;
@@ -44,8 +41,11 @@ private:
   MRawRunHeader *fRunHeader;           //! Run Header
   MDirIter      *fDirIter;             //! Dir Iter
   
-  TSpline3* fSplineZd;                 //! Zd vs. time
-  TSpline3* fSplineAz;                 //! Az vs. time
+  MSpline3* fSplineZd;                 //! Zd vs. time
+  MSpline3* fSplineAz;                 //! Az vs. time (unwrapped)
+
+  Int_t     fCursor;                   //! Last knot found in the splines
+  Bool_t    fAzWrapped;                //! Az had to be unwrapped
 
   Double_t  fRa;                       // RA of source
   Double_t  fDec;                      // Dec of source
@@ -58,6 +58,8 @@ private:
 
   Int_t  ReadEnv(const TEnv &env, TString prefix, Bool_t print);
 
+  Double_t WrapAz(Double_t az) const;
+
 public:
     
   MPointingPosInterpolate(const char *name=NULL, const char *title=NULL);
@@ -70,6 +72,9 @@ public:
   void SetTimeMode( TimeMode_t mode) { fTimeMode = mode; }
   void SetDebug( const Bool_t b=kTRUE) { fDebug = b; }
 
+  void Eval(Double_t time, Double_t &zd, Double_t &az);
+  void Eval(Int_t n, const Double_t *time, Double_t *zd, Double_t *az);
+
   void Clear(Option_t *o="");
   
   Int_t GetNumStartEvents() const { return fNumStartEvents; }
@@ -46,6 +46,7 @@
 #include "MLogManip.h"
 
 #include "MTime.h"
+#include "MParse.h"
 #include "MParList.h"
 
 ClassImp(MReport);
@@ -88,31 +89,48 @@ Bool_t MReport::CheckTag(TString &str, const char *tag) const
 //   status hour minute second millisec skip skip skip skip skip
 // The identifier is assumed to be removed.
 //
+// The numbers are converted in place with MParse (no sscanf, no copies).
+//
 // While skip are numbers which won't enter the analysis
 //
 // SetupReading must be called successfully before.
 //
 Bool_t MReport::InterpreteHeader(TString &str, Int_t ver)
 {
-    int len, state;
-    int yea, mon, day, hor, min, sec, ms;
-
-    TString fmt(fHasReportTime ?
-                " %d %d %d %d %d %d %d %d %*d %*d %*d %*d %*d %*d %*d %*d %n" :
-                " %d %d %d %d %d %d %d %d %n");
+    const char *pos = MParse::SkipBlanks(str.Data());
 
     // M1/M2 telescope number (FIXME: Readout, check?)
-    if (ver>=200805190)
-        fmt.Prepend(" %*c%*d");
+    Int_t tel;
+    const Bool_t ok = ver<200805190 || (*pos && MParse::ReadInt(++pos, tel));
+
+    // status year month day hour minute second millisecond
+    Int_t val[8];
+
+    Int_t n = 0;
+    while (ok && n<8 && MParse::ReadInt(pos, val[n]))
+        n++;
 
-    int n = sscanf(str.Data(), fmt.Data(),
-                   &state, &yea, &mon, &day, &hor, &min, &sec, &ms, &len);
     if (n!=8)
     {
         *fLog << err << "ERROR - Cannot interprete header of " << fIdentifier << " (n=" << n << ")" << endl;
         return kFALSE;
     }
 
+    // Skip the subsystem time
+    Int_t dummy;
+    for (int i=0; fHasReportTime && i<8; i++)
+        if (!MParse::ReadInt(pos, dummy))
+            break;
+
+    const Int_t state = val[0];
+    const Int_t yea   = val[1];
+    const Int_t mon   = val[2];
+    const Int_t day   = val[3];
+    const Int_t hor   = val[4];
+    const Int_t min   = val[5];
+    const Int_t sec   = val[6];
+    Int_t       ms    = val[7];
+
     if (ms==1000)
     {
         *fLog << warn << "WARNING - Milliseconds in timestamp of " << fIdentifier;
@@ -130,7 +148,7 @@ Bool_t MReport::InterpreteHeader(TString &str, Int_t ver)
         return kFALSE;
     }
 
-    str.Remove(0, len);
+    str.Remove(0, pos-str.Data());
 
     return kTRUE;
 }
@@ -43,6 +43,7 @@
 
 #include "MAstro.h"
 #include "MParList.h"
+#include "MParse.h"
 
 #include "MCameraCalibration.h"
 #include "MCameraCooling.h"
@@ -146,12 +147,15 @@ Bool_t MReportCamera::InterpreteHV(TString &str)
     Int_t i=0;
     while (pos<end)
     {
-        const Char_t hex[4] = { pos[0], pos[1], pos[2], 0 };
+        UInt_t hv;
+        const Bool_t rc = MParse::ReadHex(pos, 3, hv);
         pos += 3;
 
-        const Int_t n=sscanf(hex, "%3hx", &fHV->fHV[i++]);
-        if (n==1)
+        if (rc)
+        {
+            fHV->fHV[i++] = hv;
             continue;
+        }
 
         *fLog << warn << "WARNING - Reading hexadecimal HV information." << endl;
         return kFALSE;
@@ -171,14 +175,14 @@ Bool_t MReportCamera::InterpreteCOOL(TString &str)
     if (!CheckTag(str, "COOL "))
         return kFALSE;
 
-    Int_t len;
-
     Int_t wall, opt, center, water;
     Short_t hwall, hcenter, hip, lop, pump, ref, valv, res, fans;
-    const Int_t n=sscanf(str.Data(), "%d %d %d %d %hu %hu %hu %hu %hu %hu %hu %hu %hu %n",
-                         &wall, &opt, &center, &water, &hwall, &hcenter,
-                         &hip,  &lop, &pump, &ref, &valv, &res, &fans, &len);
-    if (n!=13)
+    const char *pos = str.Data();
+    if (!MParse::ReadInt(pos, wall) || !MParse::ReadInt(pos, opt) || !MParse::ReadInt(pos, center) ||
+        !MParse::ReadInt(pos, water) || !MParse::ReadShort(pos, hwall) || !MParse::ReadShort(pos, hcenter) ||
+        !MParse::ReadShort(pos, hip) || !MParse::ReadShort(pos, lop) || !MParse::ReadShort(pos, pump) ||
+        !MParse::ReadShort(pos, ref) || !MParse::ReadShort(pos, valv) || !MParse::ReadShort(pos, res) ||
+        !MParse::ReadShort(pos, fans))
     {
         *fLog << warn << "WARNING - Reading information of 'COOL' section." << endl;
         return kFALSE;
@@ -198,7 +202,7 @@ Bool_t MReportCamera::InterpreteCOOL(TString &str)
     fCooling->fStatusResistor      = (Bool_t)res;
     fCooling->fStatusFans          = (Bool_t)fans;
 
-    str.Remove(0, len);
+    str.Remove(0, pos-str.Data());
     str=str.Strip(TString::kLeading);
     return kTRUE;
 }
@@ -212,16 +216,14 @@ Bool_t MReportCamera::InterpreteLID(TString &str)
     if (!CheckTag(str, "LID "))
         return kFALSE;
 
-    Int_t len;
     Short_t limao, limac, limbo, limbc;
     Short_t slimao, slimac, slimbo, slimbc;
     Short_t slida, slidb, mlida, mlidb;
-    const Int_t n=sscanf(str.Data(), "%hu %hu %hu %hu %hu %hu %hu %hu %hu %hu %hu %hu %n",
-                         &limao, &limac, &limbo, &limbc,
-                         &slimao, &slimac, &slimbo, &slimbc,
-                         &slida, &slidb, &mlida, &mlidb,
-                         &len);
-    if (n!=12)
+    const char *pos = str.Data();
+    if (!MParse::ReadShort(pos, limao) || !MParse::ReadShort(pos, limac) || !MParse::ReadShort(pos, limbo) ||
+        !MParse::ReadShort(pos, limbc) || !MParse::ReadShort(pos, slimao) || !MParse::ReadShort(pos, slimac) ||
+        !MParse::ReadShort(pos, slimbo) || !MParse::ReadShort(pos, slimbc) || !MParse::ReadShort(pos, slida) ||
+        !MParse::ReadShort(pos, slidb) || !MParse::ReadShort(pos, mlida) || !MParse::ReadShort(pos, mlidb))
     {
         *fLog << warn << "WARNING - Reading information of 'LID' section." << endl;
         return kFALSE;
@@ -241,7 +243,7 @@ Bool_t MReportCamera::InterpreteLID(TString &str)
     fLids->fLidB.fStatusLid       = (Byte_t)slidb;
     fLids->fLidB.fStatusMotor     = (Byte_t)mlidb;
 
-    str.Remove(0, len);
+    str.Remove(0, pos-str.Data());
     str=str.Strip(TString::kLeading);
     return kTRUE;
 }
@@ -255,11 +257,10 @@ Bool_t MReportCamera::InterpreteHVPS(TString &str)
     if (!CheckTag(str, "HVPS "))
         return kFALSE;
 
-    Int_t len;
     Short_t c1, c2;
-    const Int_t n=sscanf(str.Data(), "%hd %hd %hd %hd %n",
-                         &fHV->fVoltageA, &fHV->fVoltageB, &c1, &c2, &len);
-    if (n!=4)
+    const char *pos = str.Data();
+    if (!MParse::ReadShort(pos, fHV->fVoltageA) || !MParse::ReadShort(pos, fHV->fVoltageB) || !MParse::ReadShort(pos, c1) ||
+        !MParse::ReadShort(pos, c2))
     {
         *fLog << warn << "WARNING - Reading information of 'HVPS' section." << endl;
         return kFALSE;
@@ -268,7 +269,7 @@ Bool_t MReportCamera::InterpreteHVPS(TString &str)
     fHV->fCurrentA = (Byte_t)c1;
     fHV->fCurrentB = (Byte_t)c2;
 
-    str.Remove(0, len);
+    str.Remove(0, pos-str.Data());
     str=str.Strip(TString::kLeading);
     return kTRUE;
 }
@@ -282,15 +283,17 @@ Bool_t MReportCamera::InterpreteLV(TString &str)
     if (!CheckTag(str, "LV "))
         return kFALSE;
 
-    Int_t len;
     Short_t vap5, vap12, van12, vbp5, vbp12, vbn12;
     Short_t valp12, vblp12, cap5, cap12, can12, cbp5, cbp12;
     Short_t cbn12, calp12, cblp12, lvps, temp, hum;
-    const Int_t n=sscanf(str.Data(), "%hd %hd %hd %hd %hd %hd %hd %hd %hd %hd %hd %hd %hd %hd %hd %hd %hd %hd %hd %n",
-                         &vap5, &vap12, &van12, &vbp5, &vbp12, &vbn12,
-                         &valp12, &vblp12, &cap5, &cap12, &can12, &cbp5, &cbp12,
-                         &cbn12, &calp12, &cblp12, &lvps, &temp, &hum, &len);
-    if (n!=19)
+    const char *pos = str.Data();
+    if (!MParse::ReadShort(pos, vap5) || !MParse::ReadShort(pos, vap12) || !MParse::ReadShort(pos, van12) ||
+        !MParse::ReadShort(pos, vbp5) || !MParse::ReadShort(pos, vbp12) || !MParse::ReadShort(pos, vbn12) ||
+        !MParse::ReadShort(pos, valp12) || !MParse::ReadShort(pos, vblp12) || !MParse::ReadShort(pos, cap5) ||
+        !MParse::ReadShort(pos, cap12) || !MParse::ReadShort(pos, can12) || !MParse::ReadShort(pos, cbp5) ||
+        !MParse::ReadShort(pos, cbp12) || !MParse::ReadShort(pos, cbn12) || !MParse::ReadShort(pos, calp12) ||
+        !MParse::ReadShort(pos, cblp12) || !MParse::ReadShort(pos, lvps) || !MParse::ReadShort(pos, temp) ||
+        !MParse::ReadShort(pos, hum))
     {
         *fLog << warn << "WARNING - Reading information of 'LV' section." << endl;
         return kFALSE;
@@ -318,7 +321,7 @@ Bool_t MReportCamera::InterpreteLV(TString &str)
     fLV->fPowerSupplyB.fCurrentNeg12V        = 0.001*cbn12;
     fLV->fPowerSupplyB.fCurrentOptLinkPos12V = 0.001*cblp12;
 
-    str.Remove(0, len);
+    str.Remove(0, pos-str.Data());
     str=str.Strip(TString::kLeading);
     return kTRUE;
 }
@@ -332,10 +335,9 @@ Bool_t MReportCamera::InterpreteAUX(TString &str)
     if (!CheckTag(str, "AUX "))
         return kFALSE;
 
-    Int_t len;
     Short_t led, fan;
-    const Int_t n=sscanf(str.Data(), "%hd %hd %n", &led, &fan, &len);
-    if (n!=2)
+    const char *pos = str.Data();
+    if (!MParse::ReadShort(pos, led) || !MParse::ReadShort(pos, fan))
     {
         *fLog << warn << "WARNING - Reading information of 'AUX' section." << endl;
         return kFALSE;
@@ -344,7 +346,7 @@ Bool_t MReportCamera::InterpreteAUX(TString &str)
     fAUX->fRequestCaosLEDs=(Bool_t)led;
     fAUX->fRequestFansFADC=(Bool_t)fan;
 
-    str.Remove(0, len);
+    str.Remove(0, pos-str.Data());
     str=str.Strip(TString::kLeading);
     return kTRUE;
 }
@@ -358,11 +360,11 @@ Bool_t MReportCamera::InterpreteCAL(TString &str)
     if (!CheckTag(str, "CAL "))
         return kFALSE;
 
-    Int_t len;
     Short_t hv, lv, cont, pin;
 
-    const Int_t n=sscanf(str.Data(), "%hd %hd %hd %hd %n", &hv, &lv, &cont, &pin, &len);
-    if (n!=4)
+    const char *pos = str.Data();
+    if (!MParse::ReadShort(pos, hv) || !MParse::ReadShort(pos, lv) || !MParse::ReadShort(pos, cont) ||
+        !MParse::ReadShort(pos, pin))
     {
         *fLog << warn << "WARNING - Reading information of 'CAL' section." << endl;
         return kFALSE;
@@ -373,7 +375,7 @@ Bool_t MReportCamera::InterpreteCAL(TString &str)
     fCalibration->fRequestContLight = (Bool_t)cont;
     fCalibration->fRequestPinDiode  = (Bool_t)pin;
 
-    str.Remove(0, len);
+    str.Remove(0, pos-str.Data());
     str=str.Strip(TString::kBoth);
     return kTRUE;
 }
@@ -387,17 +389,16 @@ Bool_t MReportCamera::InterpreteHOT(TString &str)
     if (!CheckTag(str, "HOT "))
         return kFALSE;
 
-    Int_t len;
     Int_t hot;
 
-    const Int_t n=sscanf(str.Data(), "%d %n", &hot, &len);
-    if (n!=1)
+    const char *pos = str.Data();
+    if (!MParse::ReadInt(pos, hot))
     {
         *fLog << warn << "WARNING - Reading information of 'HOT' section." << endl;
         return kFALSE;
     }
 
-    str.Remove(0, len);
+    str.Remove(0, pos-str.Data());
     str=str.Strip(TString::kBoth);
 
     return kTRUE;
@@ -413,11 +414,11 @@ Bool_t MReportCamera::InterpreteActiveLoad(TString &str)
     if (!CheckTag(str, "ACTLOAD "))
         return kFALSE;
 
-    Int_t len;
     Short_t v360a, i360a, v360b, i360b, v175a, i175a, v175b, i175b;
-    Int_t n=sscanf(str.Data(), " %hd %hd %hd %hd %hd %hd %hd %hd %n",
-                   &v360a, &i360a, &v360b, &i360b, &v175a, &i175a, &v175b, &i175b, &len);
-    if (n!=8)
+    const char *pos = str.Data();
+    if (!MParse::ReadShort(pos, v360a) || !MParse::ReadShort(pos, i360a) || !MParse::ReadShort(pos, v360b) ||
+        !MParse::ReadShort(pos, i360b) || !MParse::ReadShort(pos, v175a) || !MParse::ReadShort(pos, i175a) ||
+        !MParse::ReadShort(pos, v175b) || !MParse::ReadShort(pos, i175b))
     {
         *fLog << warn << "WARNING - Reading information of 'ACTLOAD' section." << endl;
         return kFALSE;
@@ -432,7 +433,7 @@ Bool_t MReportCamera::InterpreteActiveLoad(TString &str)
     fActiveLoad->fVoltage175B = (float)v175b*0.1;
     fActiveLoad->fIntens175B  = (float)i175b*0.01;
 
-    str.Remove(0, len);
+    str.Remove(0, pos-str.Data());
     str=str.Strip(TString::kBoth);
 
     return kTRUE;
@@ -447,11 +448,10 @@ Bool_t MReportCamera::InterpreteCentralPix(TString &str, Int_t ver)
     if (!CheckTag(str, "CPIX "))
         return kFALSE;
 
-    Int_t len;
     Short_t status;
 
-    Int_t n=sscanf(str.Data(), " %hd %n", &status, &len);
-    if (n!=1)
+    const char *pos = str.Data();
+    if (!MParse::ReadShort(pos, status))
     {
         *fLog << warn << "WARNING - Reading information of 'CPIX' section." << endl;
             return kFALSE;
@@ -459,23 +459,19 @@ Bool_t MReportCamera::InterpreteCentralPix(TString &str, Int_t ver)
 
     if (ver>=200812140)
     {
-        Int_t len2;
         Int_t dc;
-        n=sscanf(str.Data()+len, " %d %n", &dc, &len2);
-        if (n!=1)
+        if (!MParse::ReadInt(pos, dc))
         {
             *fLog << warn << "WARNING - Reading information of 'CPIX' section." << endl;
             return kFALSE;
         }
 
         fCentralPix->fDC = dc;
-
-        len += len2;
     }
 
     fCentralPix->fStatus = (Bool_t)status;
 
-    str.Remove(0, len);
+    str.Remove(0, pos-str.Data());
     str=str.Strip(TString::kBoth);
 
     return kTRUE;
@@ -490,9 +486,9 @@ Bool_t MReportCamera::InterpreteCHTEMP(TString &str)
     if (!CheckTag(str, "CHTEMP "))
         return kFALSE;
 
-    Int_t len, temp1, temp2, temp3;
-    Int_t n=sscanf(str.Data(), " %d %d %d %n", &temp1, &temp2, &temp3, &len);
-    if (n!=3)
+    Int_t temp1, temp2, temp3;
+    const char *pos = str.Data();
+    if (!MParse::ReadInt(pos, temp1) || !MParse::ReadInt(pos, temp2) || !MParse::ReadInt(pos, temp3))
     {
         *fLog << warn << "WARNING - Reading information of 'CHTEMP' section." << endl;
         return kFALSE;
@@ -502,7 +498,7 @@ Bool_t MReportCamera::InterpreteCHTEMP(TString &str)
     fAUX->fTempCountingHouse2 = temp2*0.01;
     fAUX->fTempCountingHouse3 = temp3*0.01;
 
-    str.Remove(0, len);
+    str.Remove(0, pos-str.Data());
     str=str.Strip(TString::kBoth);
 
     return kTRUE;
@@ -555,17 +551,16 @@ Bool_t MReportCamera::InterpretePSSEN(TString &str)
     if (!CheckTag(str, "PSSEN "))
         return kCONTINUE;
 
-    Int_t len;
     Int_t ps, v1, v2;
 
-    const Int_t n=sscanf(str.Data(), "%d %d %d %n", &ps, &v1, &v2, &len);
-    if (n!=3)
+    const char *pos = str.Data();
+    if (!MParse::ReadInt(pos, ps) || !MParse::ReadInt(pos, v1) || !MParse::ReadInt(pos, v2))
     {
         *fLog << warn << "WARNING - Reading information of 'PSSEN' section." << endl;
         return kFALSE;
     }
 
-    str.Remove(0, len);
+    str.Remove(0, pos-str.Data());
     str=str.Strip(TString::kBoth);
 
     return kTRUE;
@@ -580,17 +575,16 @@ Bool_t MReportCamera::InterpreteLIQ(TString &str)
     if (!CheckTag(str, "LIQ "))
         return kFALSE;
 
-    Int_t len;
     Int_t liq;
 
-    const Int_t n=sscanf(str.Data(), "%d %n", &liq, &len);
-    if (n!=1)
+    const char *pos = str.Data();
+    if (!MParse::ReadInt(pos, liq))
     {
         *fLog << warn << "WARNING - Reading information of 'LIQ' section." << endl;
         return kFALSE;
     }
 
-    str.Remove(0, len);
+    str.Remove(0, pos-str.Data());
     str=str.Strip(TString::kBoth);
 
     return kTRUE;
@@ -603,16 +597,16 @@ Bool_t MReportCamera::InterpreteLIQ(TString &str)
 Bool_t MReportCamera::InterpreteCamera(TString &str, Int_t ver)
 {
     //
-    // I have tried to do it with pure pointer arithmentics, but most of the time is spent
-    // to do the sscanf. So we gain less than 5% not using TString like it is done here.
-    Int_t len1=0;
+    // The numbers are converted with MParse directly on the string, which
+    // is only shortened once at the end.
     Short_t cal, stat, hvps, lid, lv, cool, hv, dc, led, fan, can, io, clv;
-    Int_t n;
 
-    n=sscanf(str.Data(), " %hd %hd %hd %hd %hd %hd %hd %hd %hd %hd %hd %hd %hd %n",
-             &cal, &stat, &hvps, &lid, &lv, &cool, &hv,
-             &dc, &led, &fan, &can, &io, &clv, &len1);
-    if (n!=13)
+    const char *pos = str.Data();
+    if (!MParse::ReadShort(pos, cal) || !MParse::ReadShort(pos, stat) || !MParse::ReadShort(pos, hvps) ||
+        !MParse::ReadShort(pos, lid) || !MParse::ReadShort(pos, lv) || !MParse::ReadShort(pos, cool) ||
+        !MParse::ReadShort(pos, hv) || !MParse::ReadShort(pos, dc) || !MParse::ReadShort(pos, led) ||
+        !MParse::ReadShort(pos, fan) || !MParse::ReadShort(pos, can) || !MParse::ReadShort(pos, io) ||
+        !MParse::ReadShort(pos, clv))
     {
         *fLog << warn << "WARNING - Cannot interprete status' of subsystems." << endl;
         return kFALSE;
@@ -633,19 +627,17 @@ Bool_t MReportCamera::InterpreteCamera(TString &str, Int_t ver)
     fDC->fStatus                   = (Byte_t)dc;
     fActiveLoad->fStatus           = 0xff;
 
-    Int_t len2=0;
     if (ver > 200504130)
     {
         Short_t actl;
-        n=sscanf(str.Data()+len1, " %hd %n", &actl, &len2);
-        if (n!=1)
+        if (!MParse::ReadShort(pos, actl))
         {
             *fLog << warn << "WARNING - Cannot interprete status of active load." << endl;
             return kFALSE;
         }
         fActiveLoad->fStatus = (Byte_t)actl;
     }
-    str.Remove(0, len1+len2);
+    str.Remove(0, pos-str.Data());
     str=str.Strip(TString::kLeading);
 
     return kTRUE;
@@ -32,6 +32,7 @@
 #include "MReportCurrents.h"
 
 #include "MLogManip.h"
+#include "MParse.h"
 
 #include "MParList.h"
 #include "MCameraDC.h"
@@ -71,10 +72,10 @@ Bool_t MReportCurrents::SetupReading(MParList &plist)
 //
 Int_t MReportCurrents::InterpreteBody(TString &str, Int_t ver)
 {
-    Int_t len;
     Short_t err1, err2;
-    const Int_t n=sscanf(str.Data(), " %hd %hd %n", &err1, &err2, &len);
-    if (n!=2)
+
+    const char *pos = str.Data();
+    if (!MParse::ReadShort(pos, err1) || !MParse::ReadShort(pos, err2))
     {
         *fLog << warn << "WARNING - Reading status information." << endl;
         return kCONTINUE;
@@ -85,5 +86,5 @@ Int_t MReportCurrents::InterpreteBody(TString &str, Int_t ver)
 
     // FIXME: Set fDC->fStatus ???
 
-    return fDC->Interprete(str, len);
+    return fDC->Interprete(str, pos-str.Data());
 }
@@ -70,6 +70,7 @@
 #include "MLogManip.h"
 
 #include "MAstro.h"
+#include "MParse.h"
 
 ClassImp(MReportDrive);
 
@@ -117,56 +118,55 @@ Int_t MReportDrive::InterpreteBody(TString &str, Int_t ver)
     MAstro::String2Angle(str, fDec);
     MAstro::String2Angle(str, fHa);
 
-    Int_t len;
-    Int_t n=sscanf(str.Data(), "%lf %n", &fMjd, &len);
-    if (n!=1)
+    const char *pos = str.Data();
+    if (!MParse::ReadDouble(pos, fMjd))
     {
         *fLog << warn << "WARNING - Not enough arguments." << endl;
         return kCONTINUE;
     }
 
-    str.Remove(0, len);
+    str.Remove(0, pos-str.Data());
 
     MAstro::String2Angle(str, fNominalZd);
     MAstro::String2Angle(str, fNominalAz);
     MAstro::String2Angle(str, fCurrentZd);
     MAstro::String2Angle(str, fCurrentAz);
 
-    n=sscanf(str.Data(), "%lf %lf %n", &fErrorZd, &fErrorAz, &len);
-    if (n!=2)
+    pos = str.Data();
+    if (!MParse::ReadDouble(pos, fErrorZd) || !MParse::ReadDouble(pos, fErrorAz))
     {
         *fLog << warn << "WARNING - Not enough arguments." << endl;
         return kCONTINUE;
     }
 
-    str.Remove(0, len);
+    str.Remove(0, pos-str.Data());
     str = str.Strip(TString::kBoth);
 
     if (ver>=200802200)
     {
         Int_t dummy; // Cosy armed or not
-        n=sscanf(str.Data(), "%d %n", &dummy, &len);
-        if (n!=1)
+        pos = str.Data();
+        if (!MParse::ReadInt(pos, dummy))
         {
             *fLog << warn << "WARNING - Not enough arguments." << endl;
             return kCONTINUE;
         }
 
-        str.Remove(0, len);
+        str.Remove(0, pos-str.Data());
         str = str.Strip(TString::kBoth);
     }
 
     if (ver>=200905170)
     {
         Int_t dummy; // Starguider switched on or not
-        n=sscanf(str.Data(), "%d %n", &dummy, &len);
-        if (n!=1)
+        pos = str.Data();
+        if (!MParse::ReadInt(pos, dummy))
         {
             *fLog << warn << "WARNING - Not enough arguments." << endl;
             return kCONTINUE;
         }
 
-        str.Remove(0, len);
+        str.Remove(0, pos-str.Data());
         str = str.Strip(TString::kBoth);
     }
 
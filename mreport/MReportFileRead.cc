@@ -36,6 +36,14 @@
 //     send all lines starting with 'MReportDrive::fIndetifier-REPORT'
 //     to this class.
 //
+// The file is read through a large stream buffer (kBufferSize) into
+// a line buffer which is kept between the calls to Process, as is the
+// buffer for the identifier of the report which is looked up in a
+// hash table. Hence, reading a line and finding its report doesn't
+// allocate new strings; the reports themselves still work on the line
+// (e.g. TString::Remove and Strip). The numbers are converted by the
+// reports with MParse.
+//
 //////////////////////////////////////////////////////////////////////////////
 #include "MReportFileRead.h"
 
@@ -61,12 +69,16 @@ using namespace std;
 // THashTable which allows faster access to the MReport* objects.
 //
 MReportFileRead::MReportFileRead(const char *fname, const char *name, const char *title)
-    : fFileName(fname), fVersion(-1), fIn(NULL)
+    : fFileName(fname), fVersion(-1), fBuffer(NULL), fIn(NULL)
 {
     fName  = name  ? name  : "MReportFileRead";
     fTitle = title ? title : "Read task to read general report files";
 
+    // The buffer must be set before the file is opened
+    fBuffer = new char[kBufferSize];
+
     fIn = new ifstream;
+    fIn->rdbuf()->pubsetbuf(fBuffer, kBufferSize);
 
     fList = new THashTable(1,1);
     fList->SetOwner();
@@ -80,6 +92,8 @@ MReportFileRead::~MReportFileRead()
 {
     delete fIn;
     delete fList;
+
+    delete [] fBuffer;
 }
 
 // --------------------------------------------------------------------------
@@ -187,12 +201,10 @@ Int_t MReportFileRead::PreProcess(MParList *pList)
 //
 Int_t MReportFileRead::Process()
 {
-    TString str;
-
     MReportHelp *rep=NULL;
     while (!GetReport(rep))
     {
-        str.ReadLine(*fIn);
+        fLine.ReadLine(*fIn);
         if (!*fIn)
         {
             *fLog << dbg << "EOF detected." << endl;
@@ -201,19 +213,20 @@ Int_t MReportFileRead::Process()
 
         fNumLine++;
 
-        const Int_t pos = str.First(' ');
+        const Int_t pos = fLine.First(' ');
         if (pos<=0)
             continue;
 
-        // Check for MReport{str(0,pos)}
-        rep = GetReportHelp(str(0,pos));
+        // Check for MReport{fLine(0,pos)} (fIdent keeps its buffer)
+        fIdent.Replace(0, fIdent.Length(), fLine.Data(), pos);
+        rep = GetReportHelp(fIdent);
 
         // Remove this part from the string
         if (GetReport(rep))
-            str.Remove(0, pos);
+            fLine.Remove(0, pos);
     }
 
-    const Int_t rc = rep->Interprete(str, fStart, fStop, fVersion);
+    const Int_t rc = rep->Interprete(fLine, fStart, fStop, fVersion);
 
     switch (rc)
     {
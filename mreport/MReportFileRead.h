@@ -28,7 +28,12 @@ private:
 
     Int_t   fVersion;       // File format version
 
+    TString fLine;          //! Buffer for the current line
+    TString fIdent;         //! Buffer for the identifier of the current line
+    char   *fBuffer;        //! Buffer of the input stream
+
     enum { kHasNoHeader = BIT(14) };
+    enum { kBufferSize  = 1<<20 };
 
     Int_t PreProcess(MParList *pList);
     Int_t Process();
@@ -60,6 +60,7 @@
 #include "MParList.h"
 
 #include "MLogManip.h"
+#include "MParse.h"
 
 #include "MTriggerIPR.h"
 #include "MTriggerCell.h"
@@ -125,19 +126,19 @@ Bool_t MReportTrigger::SetupReading(MParList &plist)
 //
 Bool_t MReportTrigger::InterpreteCell(TString &str)
 {
-  Int_t len=0, n, i=0;
+  Int_t i=0;
   Int_t gsNCells=32;
 
+  const char *pos = str.Data();
   for (i=0;i<gsNCells;i++)
     {
-      n = sscanf(str.Data(), " %f %n", &fCell->fCellRate[i], &len);
-      if (n!=1)
+      if (!MParse::ReadFloat(pos, fCell->fCellRate[i]))
 	{
 	  *fLog << warn << "WARNING - Cell Scaler Value #" << i << " missing." << endl;
 	  return kCONTINUE;
 	}
-      str.Remove(0, len); // Remove cell rates from report string
     }
+  str.Remove(0, pos-str.Data()); // Remove cell rates from report string
 
   str=str.Strip(TString::kLeading);  
 
@@ -222,19 +223,19 @@ Bool_t MReportTrigger::InterpreteLiveTime(TString &str)
 //
 Bool_t MReportTrigger::InterpreteBit(TString &str)
 {
-  Int_t len, n, i=0;
+  Int_t i=0;
   Int_t gsNBits=20;
   
+  const char *pos = str.Data();
   for (i=0;i<gsNBits;i++)
     {
-      n = sscanf(str.Data(), " %f %n", &fBit->fBit[i], &len);
-      if (n!=1)
+      if (!MParse::ReadFloat(pos, fBit->fBit[i]))
 	{
 	  *fLog << warn << "WARNING - Bit rate #" << i << " missing." << endl;
 	  return kCONTINUE;
 	}
-      str.Remove(0, len); // Remove output bit rates from string
     }
+  str.Remove(0, pos-str.Data()); // Remove output bit rates from string
 
   str=str.Strip(TString::kLeading);  
 
@@ -292,21 +293,20 @@ Bool_t MReportTrigger::InterpreteL1L2Table(TString &str)
 //
 Bool_t MReportTrigger::InterpreteDummy(TString &str)
 {
-  Int_t len, n, i=0;
+  Int_t i=0;
   Int_t gsNDummies=18;
   Int_t dummy;  
 
+  const char *pos = str.Data();
   for (i=0;i<gsNDummies;i++)
     {
-      n = sscanf(str.Data(), " %d %n", &dummy, &len);
-      if (n!=1)
+      if (!MParse::ReadInt(pos, dummy))
 	{
 	  *fLog << warn << "WARNING - Dummy #" << i << " missing." << endl;
 	  return kCONTINUE;
 	}
-      str.Remove(0, len); // Remove dummies from report string
-
     }
+  str.Remove(0, pos-str.Data()); // Remove dummies from report string
 
   str=str.Strip(TString::kLeading);  
 
@@ -333,14 +333,13 @@ Bool_t MReportTrigger::InterpreteIPR(TString &str)
   const char *pos = str.Data();
   const char *end = str.Data() + gsNhexIPR*8;
   
-  Int_t i=0,n,len;
-  short dummy;
+  Int_t i=0;
+  UInt_t dummy;
   while (pos < end)
     {
-      const Char_t hex[9] = { pos[0], pos[1], pos[2], pos[3],pos[4],pos[5],pos[6],pos[7],0 };
-      n = sscanf(hex, "%hx", &dummy);
+      const Bool_t rc = MParse::ReadHex(pos, 8, dummy);
       pos+=8;
-      if (n!=1)
+      if (!rc)
         {
 	  *fLog << warn << "WARNING - Rate #" << i << " missing." << endl;
 	  return kFALSE;
@@ -354,16 +353,16 @@ Bool_t MReportTrigger::InterpreteIPR(TString &str)
   // Read Individual pixel rates in dec format 
   // and save them in the MTriggerIPR container
   
+  pos = str.Data();
   for (i=0;i<gsNdecIPR;i++)
     {
-      n = sscanf(str.Data(), " %ld %n", &fIPR->fIPR[i], &len);
-      if (n!=1)
+      if (!MParse::ReadLong(pos, fIPR->fIPR[i]))
 	{
 	  *fLog << warn << "WARNING - IPR dec #" << i << " missing." << endl;
 	  return kCONTINUE;
 	}
-      str.Remove(0, len); // Remove IPR dec from report string      
     }
+  str.Remove(0, pos-str.Data()); // Remove IPR dec from report string
   
   str=str.Strip(TString::kLeading);  
 
@@ -177,6 +177,11 @@ Bool_t MExtractTimeAndCharge::ReInit(MParList *pList)
         fLoGainSwitch=0xff;
     }
 
+    // Let MPedestalSubtract determine maximum and saturation of the
+    // hi-gain range while it fills the samples
+    if (fSignal)
+        fSignal->SetScanRange(fHiGainFirst, fHiGainLast, fSaturationLimit*fRunHeader->GetScale());
+
     return kTRUE;
 }
 
@@ -240,6 +245,10 @@ Int_t MExtractTimeAndCharge::Process()
     // more than one saturating slice
     const Int_t rangehi = fHiGainLast - fHiGainFirst + 1;
 
+    // Check whether maximum and saturation of the hi-gain range have
+    // already been determined by MPedestalSubtract
+    const Bool_t hasscan = fSignal->HasScan(fHiGainFirst, fHiGainLast, satlim);
+
     MRawEvtPixelIter pixel(fRawEvt);
     while (pixel.Next())
     {
@@ -250,14 +259,18 @@ Int_t MExtractTimeAndCharge::Process()
         // Would it be better to take lastsat-firstsat?
         Int_t sathi0   = fHiGainFirst;  // First slice to extract and first saturating slice
         Int_t sathi1   = fHiGainLast;   // Last  slice to extract and last saturating slice
-        Int_t numsathi = fSignal->GetSaturation(pixidx, satlim, sathi0, sathi1);
+        Int_t numsathi = hasscan ?
+            fSignal->GetScanSaturation(pixidx, sathi0, sathi1) :
+            fSignal->GetSaturation(pixidx, satlim, sathi0, sathi1);
 
         Float_t sumhi =0., deltasumhi =-1; // Set hi-gain of MExtractedSignalPix valid
         Float_t timehi=0., deltatimehi=-1; // Set hi-gain of MArrivalTimePix valid
 
         if (numsathi<2)
         {
-            const Int_t maxposhi = fSignal->GetMaxPos(pixidx, fHiGainFirst, fHiGainLast);
+            const Int_t maxposhi = hasscan ?
+                fSignal->GetScanMaxPos(pixidx) :
+                fSignal->GetMaxPos(pixidx, fHiGainFirst, fHiGainLast);
             FindTimeAndChargeHiGain2(sig+fHiGainFirst, rangehi,
                                      sumhi, deltasumhi, timehi, deltatimehi,
                                      numsathi, maxposhi);
@@ -266,7 +279,9 @@ Int_t MExtractTimeAndCharge::Process()
         // If we have saturating slices try to get a better estimate
         // of the arrival time than timehi or sathi0. This is
         // usefull to know where to start lo-gain extraction.
-        const UInt_t maxcont = fSignal->GetRawMaxVal(pixidx, fHiGainFirst, fHiGainLast);
+        const UInt_t maxcont = hasscan ?
+            fSignal->GetScanRawMax(pixidx) :
+            fSignal->GetRawMaxVal(pixidx, fHiGainFirst, fHiGainLast);
         if (numsathi>1)
         {
             timehi = GetSaturationTime(sathi0, sig, maxcont/2)-fHiGainFirst;
@@ -374,7 +389,7 @@ Int_t MExtractTimeAndCharge::Process()
             // usefull to know where to start lo-gain extraction.
             if (numsatlo>1)
             {
-                const UInt_t maxcontlo = fSignal->GetRawMaxVal(pixidx, fHiGainFirst, fHiGainLast);
+                const UInt_t maxcontlo = maxcont;
                 timelo = GetSaturationTime(satlo0, sig, maxcontlo/2)-numh-first;
                 deltatimelo = 0;
             }
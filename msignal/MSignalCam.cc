@@ -91,6 +91,10 @@ void MSignalCam::Copy(TObject &obj) const
     cam.fSizeSubIslands = fSizeSubIslands;
     cam.fSizeMainIsland = fSizeMainIsland;
 
+    cam.fIslandSize      = fIslandSize;
+    cam.fIslandNumPixels = fIslandNumPixels;
+    cam.fIslandBox       = fIslandBox;
+
     cam.fNumPixelsSaturatedHiGain = fNumPixelsSaturatedHiGain;
     cam.fNumPixelsSaturatedLoGain = fNumPixelsSaturatedLoGain;
 
@@ -355,49 +359,32 @@ MSignalPix *MSignalCam::AddPixel(Int_t idx, Float_t nph, Float_t er)
 
 // --------------------------------------------------------------------------
 //
-// This function recursively finds all pixels of one island and assigns
-// the number num as island number to the pixel.
-//
-//  1) Check whether a pixel with the index idx exists, is unused
-//     and has not yet a island number assigned.
-//  2) Assign the island number num to the pixel
-//  3) Loop over all its neighbors taken from the geometry geom. For all
-//     neighbors recursively call this function (CalcIsland)
-//  4) Sum the size of the pixel and all neighbors newly assigned
-//     (by CalcIsland) to this island
+// Fill a flat table of the neighbors of all pixels of the geometry geom.
+// The neighbors of pixel i are neighbors[start[i]] to
+// neighbors[start[i+1]-1] in the order given by the geometry.
 //
-// Returns the sum of the pixel size.
-//
-Double_t MSignalCam::CalcIsland(const MGeomCam &geom, Int_t idx, Int_t num)
+void MSignalCam::InitNeighbors(const MGeomCam &geom, MArrayI &start, MArrayI &neighbors)
 {
-    // Get the pixel information of a pixel with this index
-    MSignalPix &pix = (*this)[idx];
-
-    // If an island number was already assigned to this pixel... do nothing.
-    if (pix.GetIdxIsland()>=0)
-        return 0;
+    const UInt_t npix = geom.GetNumPixels();
 
-    // If the pixel is an unused pixel... do nothing.
-    if (!pix.IsPixelUsed())
-        return 0;
+    start.Set(npix+1);
 
-    // Assign the new island number num to this used pixel
-    pix.SetIdxIsland(num);
-
-    // Get the geometry information (neighbors) of this pixel
-    const MGeom &gpix = geom[idx];
-
-    // Get the size of this pixel
-    Double_t size = pix.GetNumPhotons();
+    UInt_t n = 0;
+    for (UInt_t i=0; i<npix; i++)
+    {
+        start[i] = n;
+        n += geom[i].GetNumNeighbors();
+    }
+    start[npix] = n;
 
-    // Now do the same with all its neighbors and sum the
-    // sizes which they correspond to
-    const Int_t n = gpix.GetNumNeighbors();
-    for (int i=0; i<n; i++)
-        size += CalcIsland(geom, gpix.GetNeighbor(i), num);
+    neighbors.Set(n);
 
-    // return size of this (sub)cluster
-    return size;
+    for (UInt_t i=0; i<npix; i++)
+    {
+        const MGeom &gpix = geom[i];
+        for (Int_t j=0; j<gpix.GetNumNeighbors(); j++)
+            neighbors[start[i]+j] = gpix.GetNeighbor(j);
+    }
 }
 
 // --------------------------------------------------------------------------
@@ -415,13 +402,40 @@ Double_t MSignalCam::CalcIsland(const MGeomCam &geom, Int_t idx, Int_t num)
 //
 // You can access this island number of a pixel with a call to
 // MSignalPix->GetIdxIsland. The total number of islands available
-// can be accessed with MSignalCam->GetNumIslands.
+// can be accessed with MSignalCam->GetNumIslands. The size, the
+// number of pixels and the bounding box of each island are
+// available from GetIslandSize, GetIslandNumPixels and
+// GetIslandMinX/MaxX/MinY/MaxY.
 //
 // CalcIslands returns the number of islands found. If an error occurs,
 // eg the geometry has less pixels than the highest index stored, -1 is
 // returned.
 //
+// If the neighbor table is available anyway (see InitNeighbors) it is
+// more efficient to call
+// CalcIslands(const MGeomCam&, const MArrayI&, const MArrayI&)
+//
 Int_t MSignalCam::CalcIslands(const MGeomCam &geom)
+{
+    MArrayI start, neighbors;
+    InitNeighbors(geom, start, neighbors);
+
+    return CalcIslands(geom, start, neighbors);
+}
+
+// --------------------------------------------------------------------------
+//
+// Calculate the islands as described above using the flat table of
+// neighbors (see InitNeighbors).
+//
+// Each island is flooded starting from its pixel with the lowest index
+// by a depth first search with an explicit stack. The pixels are visited
+// and their signals summed in exactly the same order as by a recursive
+// search (each pixel adds the size of the sub-cluster of each of its
+// neighbors in the order of the neighbors), so that the sizes and thus
+// the order of the islands do not depend on the implementation.
+//
+Int_t MSignalCam::CalcIslands(const MGeomCam &geom, const MArrayI &start, const MArrayI &neighbors)
 {
     const UInt_t numpix = GetNumPixels();
 
@@ -431,16 +445,36 @@ Int_t MSignalCam::CalcIslands(const MGeomCam &geom)
         fNumIslands = 0;
         return -1;
     }
-/*
-    if ((UInt_t)fMaxIndex>=geom.GetNumPixels())
+
+    if (start.GetSize()<numpix+1)
     {
         *fLog << err << "ERROR - MSignalCam::CalcIslands: Size mismatch - geometry too small!" << endl;
+        fNumIslands = 0;
         return -1;
     }
-  */
-    // Create a list to hold the sizes of the islands (The maximum
-    // number of islands possible is roughly fNumPixels/4)
-    TArrayD size(numpix/3);
+
+    // Gather the pixel information once (island -1: not yet assigned)
+    MArrayI island(numpix);
+    MArrayF phot(numpix);
+
+    for (UInt_t idx=0; idx<numpix; idx++)
+    {
+        const MSignalPix &pix = (*this)[idx];
+
+        phot[idx]   = pix.GetNumPhotons();
+        island[idx] = pix.IsPixelUsed() ? pix.GetIdxIsland() : SHRT_MAX;
+    }
+
+    // Stack of the depth first search: pixel index, position in its
+    // list of neighbors and size of the sub-cluster
+    MArrayI stackidx(numpix);
+    MArrayI stackpos(numpix);
+    MArrayD stacksz(numpix);
+
+    // Sizes, number of pixels and bounding boxes of the islands
+    MArrayD size(numpix);
+    MArrayI count(numpix);
+    MArrayF box(4*numpix);
 
     // Calculate Islands
     Int_t   n=0;
@@ -448,21 +482,63 @@ Int_t MSignalCam::CalcIslands(const MGeomCam &geom)
 
     for (UInt_t idx=0; idx<numpix; idx++)
     {
-        const MSignalPix &pix = (*this)[idx];
-        if (!pix.IsPixelUsed())
+        // Only 'start' a new island for used pixels
+        // which do not yet belong to another island.
+        if (island[idx]>=0)
             continue;
 
-        // This 'if' is necessary (although it is done in GetIsland, too)
-        // because otherwise the counter (n) would be wrong.
-        // So only 'start' a new island for used pixels (selected by
-        // using the Iterator) which do not yet belong to another island.
-        if (pix.GetIdxIsland()<0)
+        island[idx] = n;
+
+        Int_t top = 0;
+        stackidx[0] = idx;
+        stackpos[0] = start[idx];
+        stacksz[0]  = phot[idx];
+
+        Float_t *b = box.GetArray()+4*n;
+        b[0] = b[1] = geom[idx].GetX();
+        b[2] = b[3] = geom[idx].GetY();
+
+        count[n] = 1;
+
+        while (top>=0)
         {
-            // Don't put this in one line! n is used twice...
-            const Double_t sz = CalcIsland(geom, idx/*pix->GetPixId()*/, n);
-            size[n++] = sz;
-            totsize += sz;
+            const Int_t i = stackidx[top];
+
+            // All neighbors done: add the size to the parent's sub-cluster
+            if (stackpos[top]==start[i+1])
+            {
+                if (top>0)
+                    stacksz[top-1] += stacksz[top];
+                top--;
+                continue;
+            }
+
+            const UInt_t k = neighbors[stackpos[top]++];
+
+            // Skip unused pixels and pixels with island number assigned
+            if (k>=numpix || island[k]>=0)
+                continue;
+
+            island[k] = n;
+
+            top++;
+            stackidx[top] = k;
+            stackpos[top] = start[k];
+            stacksz[top]  = phot[k];
+
+            const MGeom &gpix = geom[k];
+            b[0] = TMath::Min(b[0], gpix.GetX());
+            b[1] = TMath::Max(b[1], gpix.GetX());
+            b[2] = TMath::Min(b[2], gpix.GetY());
+            b[3] = TMath::Max(b[3], gpix.GetY());
+
+            count[n]++;
         }
+
+        size[n] = stacksz[0];
+        totsize += stacksz[0];
+
+        n++;
     }
 
     // Create an array holding the indices
@@ -471,23 +547,33 @@ Int_t MSignalCam::CalcIslands(const MGeomCam &geom)
     // Sort the sizes descending
     TMath::Sort(n, size.GetArray(), idxarr.GetArray(), kTRUE);
 
+    // Inverse of the sorting: new index of each island
+    MArrayI order(n);
+    for (Int_t j=0; j<n; j++)
+        order[idxarr[j]] = j;
+
     // Replace island numbers by size indices -- After this
     // islands indices are sorted by the island size
     for (UInt_t idx=0; idx<numpix; idx++)
     {
-        MSignalPix &pix = (*this)[idx];
-        if (!pix.IsPixelUsed())
+        const Int_t i = island[idx];
+        if (i==SHRT_MAX)
             continue;
 
-        const Short_t i = pix.GetIdxIsland();
+        (*this)[idx].SetIdxIsland(i>=0 && i<n ? order[i] : -1);
+    }
 
-        // Find new index
-        Short_t j;
-        for (j=0; j<n; j++)
-            if (idxarr[j]==i)
-                break;
+    // Store the properties of the islands in the new order
+    fIslandSize.Set(n);
+    fIslandNumPixels.Set(n);
+    fIslandBox.Set(4*n);
 
-        pix.SetIdxIsland(j==n ? -1 : j);
+    for (Int_t j=0; j<n; j++)
+    {
+        fIslandSize[j]      = size[idxarr[j]];
+        fIslandNumPixels[j] = count[idxarr[j]];
+        for (Int_t l=0; l<4; l++)
+            fIslandBox[4*j+l] = box[4*idxarr[j]+l];
     }
 
     // Now assign number of islands found
@@ -10,6 +10,15 @@
 #ifndef MARS_MSignalPix
 #include "MSignalPix.h"
 #endif
+#ifndef MARS_MArrayI
+#include "MArrayI.h"
+#endif
+#ifndef MARS_MArrayF
+#include "MArrayF.h"
+#endif
+#ifndef MARS_MArrayD
+#include "MArrayD.h"
+#endif
 
 class MGeomCam;
 class MSignalPix;
@@ -25,12 +34,14 @@ private:
     Float_t       fSizeSubIslands;              //!
     Float_t       fSizeMainIsland;              //!
 
+    MArrayD       fIslandSize;                  //! Size of the islands (sorted descending)
+    MArrayI       fIslandNumPixels;             //! Number of pixels of the islands
+    MArrayF       fIslandBox;                   //! Bounding box of the islands (xmin, xmax, ymin, ymax)
+
     Int_t         fNumPixelsSaturatedHiGain;
     Int_t         fNumPixelsSaturatedLoGain;
     TClonesArray *fPixels;     //-> FIXME: Change TClonesArray away from a pointer?
 
-    Double_t CalcIsland(const MGeomCam &geom, Int_t idx, Int_t num);
-
 public:
     MSignalCam(const char *name=NULL, const char *title=NULL);
     ~MSignalCam() { delete fPixels; }
@@ -55,6 +66,12 @@ public:
     Float_t GetSizeSinglePixels() const { return fSizeSinglePixels; }
     Float_t GetSizeSubIslands() const { return fSizeSubIslands; }
     Float_t GetSizeMainIsland() const { return fSizeMainIsland; }
+    Double_t GetIslandSize(Int_t i) const      { return fIslandSize[i]; }
+    Int_t    GetIslandNumPixels(Int_t i) const { return fIslandNumPixels[i]; }
+    Float_t  GetIslandMinX(Int_t i) const      { return fIslandBox[4*i];   }
+    Float_t  GetIslandMaxX(Int_t i) const      { return fIslandBox[4*i+1]; }
+    Float_t  GetIslandMinY(Int_t i) const      { return fIslandBox[4*i+2]; }
+    Float_t  GetIslandMaxY(Int_t i) const      { return fIslandBox[4*i+3]; }
     Int_t   GetNumPixelsSaturatedHiGain() const { return fNumPixelsSaturatedHiGain; }
     Int_t   GetNumPixelsSaturatedLoGain() const { return fNumPixelsSaturatedLoGain; }
 
@@ -74,7 +91,10 @@ public:
     MSignalPix &operator[](int i) const { return *(MSignalPix*)(fPixels->UncheckedAt(i)); }
 
     // Functions to change the contained data
+    static void InitNeighbors(const MGeomCam &geom, MArrayI &start, MArrayI &neighbors);
+
     Int_t CalcIslands(const MGeomCam &geom);
+    Int_t CalcIslands(const MGeomCam &geom, const MArrayI &start, const MArrayI &neighbors);
 
     // Functions for easy comparisons
     Bool_t CompareCleaning(const MSignalCam &cam) const;
@@ -218,7 +218,7 @@ Int_t MPhotonData::FillRfl(Float_t f[8])
 // Currently we exchange x and y and set y=-y to convert Corsikas coordinate
 // system intpo our own.
 //
-Int_t MPhotonData::FillCorsika(Float_t f[7], Int_t i)
+Int_t MPhotonData::FillCorsika(const Float_t f[7], Int_t i)
 {
     const UInt_t n = TMath::Nint(f[0]);
 
@@ -261,6 +261,28 @@ Int_t MPhotonData::FillCorsika(Float_t f[7], Int_t i)
     return kTRUE;
 }
 
+// --------------------------------------------------------------------------
+//
+// The height of production in the compact bunch format is stored as
+// 1000*log10(h/cm). The conversion (pow) is tabulated for all 65536
+// possible values. The table is initialized at first use.
+//
+static Float_t GetHeightCompact(Short_t lg)
+{
+    struct Table
+    {
+        Float_t fH[65536];
+        Table()
+        {
+            for (Int_t i=0; i<65536; i++)
+                fH[i] = pow(10, Short_t(i-32768)/1000.);
+        }
+    };
+
+    static const Table table;
+    return table.fH[lg+32768];
+}
+
 // --------------------------------------------------------------------------
 //
 // Set the data member according to the 8 shorts read from a eventio-file.
@@ -270,7 +292,7 @@ Int_t MPhotonData::FillCorsika(Float_t f[7], Int_t i)
 // Currently we exchange x and y and set y=-y to convert Corsikas coordinate
 // system into our own.
 //
-Int_t MPhotonData::FillEventIO(Short_t f[8])
+Int_t MPhotonData::FillEventIO(const Short_t f[8])
 {
     // From 5.5 compact_bunch:
     // https://www.mpi-hd.mpg.de/hfm/~bernlohr/iact-atmo/iact_refman.pdf
@@ -283,7 +305,7 @@ Int_t MPhotonData::FillEventIO(Short_t f[8])
     fCosU             =  f[3]/30000.;           // cos to x
 
     fTime             =  f[4]/10.;              // a relative arival time [ns]
-    fProductionHeight =  pow(10, f[5]/1000.);   // altitude of emission a.s.l. [cm]
+    fProductionHeight =  GetHeightCompact(f[5]); // altitude of emission a.s.l. [cm]
     fWavelength       =  f[7];                  // wavelength [nm]: 0 undetermined, <0 already in p.e.
 
     // Now reset all data members which are not in the stream
@@ -303,7 +325,7 @@ Int_t MPhotonData::FillEventIO(Short_t f[8])
 // Currently we exchange x and y and set y=-y to convert Corsikas coordinate
 // system into our own.
 //
-Int_t MPhotonData::FillEventIO(Float_t f[8])
+Int_t MPhotonData::FillEventIO(const Float_t f[8])
 {
     // photons in this bunch
     const UInt_t n = TMath::Nint(f[6]);
@@ -133,9 +133,9 @@ public:
     //Int_t ReadCorsikaEvt(istream &fin);
     //Int_t ReadRflEvt(istream &fin);
 
-    Int_t FillCorsika(Float_t f[7], Int_t i);
-    Int_t FillEventIO(Short_t f[8]);
-    Int_t FillEventIO(Float_t f[8]);
+    Int_t FillCorsika(const Float_t f[7], Int_t i);
+    Int_t FillEventIO(const Short_t f[8]);
+    Int_t FillEventIO(const Float_t f[8]);
     Int_t FillRfl(Float_t f[8]);
 
     ClassDef(MPhotonData, 2) //Container to store a cherenkov photon bunch from a CORSUKA file
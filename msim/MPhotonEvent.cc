@@ -99,6 +99,11 @@
 //
 // So be sure that if you want to sort your array it is really sorted.
 //
+// The generation counter (GetGeneration) is incremented by Add, Shrink,
+// Resize, Sort and when a new event is read. It allows MPhotonIndex to
+// detect that it refers to an outdated list. If you change the tags
+// directly call IncGeneration().
+//
 //
 //   Version 1:
 //   ----------
@@ -228,7 +233,7 @@ public:
 // Default constructor. It initializes all arrays with zero size.
 //
 MPhotonEvent::MPhotonEvent(const char *name, const char *title)
-    : fData("MPhotonData", 1)
+    : fData("MPhotonData", 1), fGeneration(0)
 {
     fName  = name  ? name  : "MPhotonEvent";
     fTitle = title ? title : "Corsika Event Data Information";
@@ -274,6 +279,7 @@ Int_t MPhotonEvent::Shrink(Int_t n)
 
     // Just set fLast = n -1
     static_cast<MyClonesArray&>(fData).FastShrink(n);
+    fGeneration++;
     return fData.GetEntriesFast();
 }
 
@@ -304,6 +310,7 @@ void MPhotonEvent::Resize(Int_t n)
         fData.ExpandCreate(n);      // Free memory of allocated MPhotonData
         fData.Expand(n);            // Free memory of allocated pointers
     }
+    fGeneration++;
 }
 
 // Overload the AsciiWrite method to store the informations of the photons onto disc.
@@ -375,6 +382,7 @@ MPhotonData &MPhotonEvent::Add(Int_t n)
     {
         o=fData.New(n);
     }
+    fGeneration++;
     return static_cast<MPhotonData&>(*o);
 }
 
@@ -395,6 +403,9 @@ void MPhotonEvent::Sort(Bool_t force)
     if (force)
         fData.UnSort();
 
+    if (!fData.IsSorted())
+        fGeneration++;
+
     static_cast<MyClonesArray&>(fData).UncheckedSort(); /*Sort(GetEntriesFast())*/
 }
 
@@ -560,24 +571,39 @@ void MPhotonEvent::SimWavelength(Float_t wmin, Float_t wmax)
         operator[](i).SimWavelength(wmin, wmax);
 }
 
+// --------------------------------------------------------------------------
+//
+// Read a block of compact photon bunches (eight shorts each) from an
+// EventIO file. The whole block is read at once and the bunches are
+// decoded directly into the (pre-allocated) array.
+//
 Int_t MPhotonEvent::ReadEventIoEvtCompact(MCorsikaFormat *fInFormat)
 {
    Int_t bunchHeader[3];
-   fInFormat->Read(bunchHeader, 3 * sizeof(Int_t));
+   if (!fInFormat->Read(bunchHeader, 3 * sizeof(Int_t)))
+      return kERROR;
 
-   Int_t n = 0;
+   const Int_t num = bunchHeader[2];
+   if (num<0)
+      return kERROR;
+
+   fBufferS.Set(num*8);
+   if (!fInFormat->Read(fBufferS.GetArray(), num * 8 * sizeof(Short_t)))
+      return kERROR;
 
-   for (int bunch = 0; bunch < bunchHeader[2]; bunch++)
-   {
-       Short_t buffer[8];
-       fInFormat->Read(buffer, 8 * sizeof(Short_t));
+   // Create all objects at once, they are filled in place
+   fData.ExpandCreateFast(num);
 
-       if (Add(n).FillEventIO(buffer))
-           n++;
-   }
+   const Short_t *buffer = reinterpret_cast<Short_t*>(fBufferS.GetArray());
+
+   Int_t n = 0;
+   for (int bunch = 0; bunch < num; bunch++)
+      if (operator[](n).FillEventIO(buffer + 8*bunch))
+         n++;
 
    Resize(n);
    fData.UnSort();
+   fGeneration++;
 
    SetReadyToSave();
 
@@ -586,24 +612,39 @@ Int_t MPhotonEvent::ReadEventIoEvtCompact(MCorsikaFormat *fInFormat)
 
 }
 
+// --------------------------------------------------------------------------
+//
+// Read a block of photon bunches (eight floats each) from an EventIO
+// file. The whole block is read at once and the bunches are decoded
+// directly into the (pre-allocated) array.
+//
 Int_t MPhotonEvent::ReadEventIoEvt(MCorsikaFormat *fInFormat)
 {
    Int_t  bunchHeader[3];
-   fInFormat->Read(bunchHeader, 3 * sizeof(Int_t));
+   if (!fInFormat->Read(bunchHeader, 3 * sizeof(Int_t)))
+      return kERROR;
 
-   Int_t n = 0;
+   const Int_t num = bunchHeader[2];
+   if (num<0)
+      return kERROR;
 
-   for (int bunch = 0; bunch < bunchHeader[2]; bunch++)
-      {
-      Float_t buffer[8];
-      fInFormat->Read(buffer, 8 * sizeof(Float_t));
+   fBufferF.Set(num*8);
+   if (!fInFormat->Read(fBufferF.GetArray(), num * 8 * sizeof(Float_t)))
+      return kERROR;
+
+   // Create all objects at once, they are filled in place
+   fData.ExpandCreateFast(num);
 
-      if (Add(n).FillEventIO(buffer))
+   const Float_t *buffer = fBufferF.GetArray();
+
+   Int_t n = 0;
+   for (int bunch = 0; bunch < num; bunch++)
+      if (operator[](n).FillEventIO(buffer + 8*bunch))
          n++;
-      }
 
    Resize(n);
    fData.UnSort();
+   fGeneration++;
 
    SetReadyToSave();
 
@@ -612,13 +653,21 @@ Int_t MPhotonEvent::ReadEventIoEvt(MCorsikaFormat *fInFormat)
 
 }
 
+// --------------------------------------------------------------------------
+//
+// Decode numEvents photon bunches (seven floats each) of a block from a
+// CORSIKA file directly into the (pre-allocated) array.
+//
 Int_t MPhotonEvent::ReadCorsikaEvt(Float_t * data, Int_t numEvents, Int_t arrayIdx)
 {
+   // Create all objects at once, they are filled in place
+   fData.ExpandCreateFast(numEvents);
+
    Int_t n = 0;
 
    for (Int_t event = 0; event < numEvents; event++)
       {
-      const Int_t rc = Add(n).FillCorsika(data + 7 * event, arrayIdx);
+      const Int_t rc = operator[](n).FillCorsika(data + 7 * event, arrayIdx);
 
       switch (rc)
       {
@@ -633,6 +682,7 @@ Int_t MPhotonEvent::ReadCorsikaEvt(Float_t * data, Int_t numEvents, Int_t arrayI
 
    Resize(n);
    fData.UnSort();
+   fGeneration++;
 
    SetReadyToSave();
 
@@ -641,6 +691,30 @@ Int_t MPhotonEvent::ReadCorsikaEvt(Float_t * data, Int_t numEvents, Int_t arrayI
 
 }
 
+// --------------------------------------------------------------------------
+//
+// Decode the num photon bunches (seven floats each) with the indices
+// idx[0..num-1] of a block from a CORSIKA file directly into the
+// (pre-allocated) array. The bunches must not be empty. The selection
+// of the reuse is done by the caller (see MCorsikaRead::IndexRawEvent).
+//
+Int_t MPhotonEvent::ReadCorsikaEvt(const Float_t *data, const Int_t *idx, Int_t num)
+{
+   // Create all objects at once, they are filled in place
+   fData.ExpandCreateFast(num);
+
+   for (Int_t i=0; i<num; i++)
+      if (operator[](i).FillCorsika(data + 7 * idx[i], -1) != kTRUE)
+         return kERROR;
+
+   fData.UnSort();
+   fGeneration++;
+
+   SetReadyToSave();
+
+   return kTRUE;
+}
+
 // --------------------------------------------------------------------------
 //
 // Print the array
@@ -9,6 +9,13 @@
 #include <TClonesArray.h>
 #endif
 
+#ifndef MARS_MArrayS
+#include "MArrayS.h"
+#endif
+#ifndef MARS_MArrayF
+#include "MArrayF.h"
+#endif
+
 #include <iosfwd>
 
 using namespace std;
@@ -22,12 +29,21 @@ class MPhotonEvent : public MParContainer
 private:
     TClonesArray fData;
 
+    MArrayS fBufferS;  //! Buffer for reading compact photon bunches
+    MArrayF fBufferF;  //! Buffer for reading photon bunches
+
+    UInt_t  fGeneration; //! Incremented whenever the list of photons changes
+
 public:
     MPhotonEvent(const char *name=NULL, const char *title=NULL);
 
     void Sort(Bool_t force=kFALSE);
     Bool_t IsSorted() const { return fData.IsSorted(); }
 
+    // Identifies the current content of the list (see MPhotonIndex)
+    UInt_t GetGeneration() const { return fGeneration; }
+    void   IncGeneration() { fGeneration++; }
+
     // Getter/Setter
     Int_t GetNumPhotons() const { return fData.GetEntriesFast(); }
     Int_t GetNumExternal() const;
@@ -64,6 +80,7 @@ public:
     Int_t ReadEventIoEvt(MCorsikaFormat *fInFormat);
     Int_t ReadEventIoEvtCompact(MCorsikaFormat *fInFormat);
     Int_t ReadCorsikaEvt(Float_t * data, Int_t numEvents, Int_t arrayIdx);
+    Int_t ReadCorsikaEvt(const Float_t *data, const Int_t *idx, Int_t num);
 
     // TObject
     void Paint(Option_t *o="");
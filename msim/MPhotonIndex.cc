@@ -0,0 +1,148 @@
+/* ======================================================================== *\
+!
+! *
+! * This file is part of MARS, the MAGIC Analysis and Reconstruction
+! * Software. It is distributed to you in the hope that it can be a useful
+! * and timesaving tool in analysing Data of imaging Cerenkov telescopes.
+! * It is distributed WITHOUT ANY WARRANTY.
+! *
+! * Permission to use, copy, modify and distribute this software and its
+! * documentation for any purpose is hereby granted without fee,
+! * provided that the above copyright notice appear in all copies and
+! * that both that copyright notice and this permission notice appear
+! * in supporting documentation. It is provided "as is" without express
+! * or implied warranty.
+! *
+!
+!
+!   Copyright: MAGIC Software Development, 2000-2026
+!
+!
+\* ======================================================================== */
+
+//////////////////////////////////////////////////////////////////////////////
+//
+//  MPhotonIndex
+//
+//  Index of the photons in MPhotonEvent sorted by pixel (tag), stored as
+//  a compressed row: the photons of pixel i are the entries GetFirst(i)
+//  to GetLast(i)-1, operator[] returns their indices in MPhotonEvent.
+//  The index is built by a counting sort in O(N) which keeps the order of
+//  the photons within a pixel, i.e. if MPhotonEvent is sorted in time the
+//  photons of each pixel are in time order.
+//
+//  With the index the simulation of the pixels can loop over the pixels
+//  and access the pixel objects (APDs, gains, truth information) once
+//  per pixel instead of once per photon in random order.
+//
+//  The index refers to the photon list at the time it was built. It is
+//  invalidated at the beginning of each event (Reset). Tasks which add or
+//  remove photons, change their tags or their order must either rebuild
+//  or Reset() it. IsValid() checks that the index was built for the same
+//  photon list in its current state (see MPhotonEvent::GetGeneration) and
+//  the same number of pixels.
+//
+//  See also: MSimPhotonIndex
+//
+//  Usage:
+//
+//    for (UInt_t i=0; i<index.GetNumPixels(); i++)
+//        for (Int_t k=index.GetFirst(i); k<index.GetLast(i); k++)
+//        {
+//            const MPhotonData &ph = evt[index[k]];
+//            ...
+//        }
+//
+//////////////////////////////////////////////////////////////////////////////
+#include "MPhotonIndex.h"
+
+#include "MPhotonEvent.h"
+#include "MPhotonData.h"
+
+ClassImp(MPhotonIndex);
+
+using namespace std;
+
+// --------------------------------------------------------------------------
+//
+// Default constructor.
+//
+MPhotonIndex::MPhotonIndex(const char *name, const char *title)
+    : fEvent(0), fGeneration(0), fNumPhotons(-1), fNumSkipped(0)
+{
+    fName  = name  ? name  : "MPhotonIndex";
+    fTitle = title ? title : "Index of the photons sorted by pixel";
+}
+
+// --------------------------------------------------------------------------
+//
+// Invalidate the index. This is called at the beginning of each event.
+// The arrays are kept to avoid reallocation.
+//
+void MPhotonIndex::Reset()
+{
+    fEvent      = 0;
+    fNumPhotons = -1;
+    fNumSkipped = 0;
+}
+
+// --------------------------------------------------------------------------
+//
+// Return whether the index was built for npix pixels and for evt and evt
+// has not been changed since (generation counter). Note that direct
+// changes of the tags can only be detected if MPhotonEvent::IncGeneration
+// was called.
+//
+Bool_t MPhotonIndex::IsValid(const MPhotonEvent &evt, UInt_t npix) const
+{
+    return fEvent==&evt && fGeneration==evt.GetGeneration() &&
+        fNumPhotons==evt.GetNumPhotons() && GetNumPixels()==npix;
+}
+
+// --------------------------------------------------------------------------
+//
+// Sort the indices of the photons of evt by their tag (counting sort).
+// Photons with a tag outside of [0, npix[ are not indexed, their number
+// is returned by GetNumSkipped().
+//
+void MPhotonIndex::Build(const MPhotonEvent &evt, UInt_t npix)
+{
+    const Int_t num = evt.GetNumPhotons();
+
+    fFirst.Set(npix+1);
+    fFirst.Reset();
+
+    fIdx.Set(num);
+
+    fEvent      = &evt;
+    fGeneration = evt.GetGeneration();
+    fNumPhotons = num;
+    fNumSkipped = 0;
+
+    // Count the photons per pixel
+    for (Int_t i=0; i<num; i++)
+    {
+        const Int_t tag = evt[i].GetTag();
+        if (tag<0 || tag>=(Int_t)npix)
+            fNumSkipped++;
+        else
+            fFirst[tag+1]++;
+    }
+
+    // Start index of each pixel
+    for (UInt_t i=0; i<npix; i++)
+        fFirst[i+1] += fFirst[i];
+
+    // Fill the indices. Afterwards fFirst[i] is the end of pixel i
+    for (Int_t i=0; i<num; i++)
+    {
+        const Int_t tag = evt[i].GetTag();
+        if (tag>=0 && tag<(Int_t)npix)
+            fIdx[fFirst[tag]++] = i;
+    }
+
+    // Restore the start indices
+    for (UInt_t i=npix; i>0; i--)
+        fFirst[i] = fFirst[i-1];
+    fFirst[0] = 0;
+}
@@ -0,0 +1,50 @@
+#ifndef MARS_MPhotonIndex
+#define MARS_MPhotonIndex
+
+#ifndef MARS_MParContainer
+#include "MParContainer.h"
+#endif
+
+#ifndef MARS_MArrayI
+#include "MArrayI.h"
+#endif
+
+class MPhotonEvent;
+
+class MPhotonIndex : public MParContainer
+{
+private:
+    MArrayI fFirst;       //! First entry in fIdx of each pixel (number of pixels+1 entries)
+    MArrayI fIdx;         //! Indices of the photons sorted by pixel
+
+    const MPhotonEvent *fEvent; //! Photon list the index was built for
+    UInt_t  fGeneration;  //! Its generation counter at that time
+
+    Int_t   fNumPhotons;  //! Number of photons of the event the index was built for
+    Int_t   fNumSkipped;  //! Number of photons with a tag outside of the pixel range
+
+public:
+    MPhotonIndex(const char *name=NULL, const char *title=NULL);
+
+    void Build(const MPhotonEvent &evt, UInt_t npix);
+    void Reset();
+
+    Bool_t IsValid(const MPhotonEvent &evt, UInt_t npix) const;
+
+    // Number of pixels and photons
+    UInt_t GetNumPixels() const { return fFirst.GetSize()>0 ? fFirst.GetSize()-1 : 0; }
+    Int_t  GetNumPhotons() const { return fNumPhotons; }
+    Int_t  GetNumSkipped() const { return fNumSkipped; }
+
+    // Photons of pixel i are the entries [GetFirst(i), GetLast(i)[
+    Int_t  GetFirst(UInt_t i) const { return fFirst[i]; }
+    Int_t  GetLast(UInt_t i) const  { return fFirst[i+1]; }
+    Int_t  GetNumPhotons(UInt_t i) const { return fFirst[i+1]-fFirst[i]; }
+
+    // Index of the k-th entry in the photon list
+    Int_t  operator[](UInt_t k) const { return fIdx[k]; }
+
+    ClassDef(MPhotonIndex, 0) // Index of the photons of an event sorted by pixel
+};
+
+#endif
@@ -48,6 +48,7 @@
 #include "MLogManip.h"
 
 #include "MParList.h"
+#include "MSimRandom.h"
 
 #include "MParSpline.h"
 
@@ -65,7 +66,7 @@ using namespace std;
 //  Default Constructor.
 //
 MSimAbsorption::MSimAbsorption(const char* name, const char *title)
-    : fEvt(0), fRunHeader(0), fHeader(0), fSpline(0), fParName("MParSpline"), fUseTheta(kFALSE), fForce(kFALSE)
+    : fRandom(0), fEvt(0), fRunHeader(0), fHeader(0), fSpline(0), fParName("MParSpline"), fUseTheta(kFALSE), fForce(kFALSE)
 {
     fName  = name  ? name  : "MSimAbsorption";
     fTitle = title ? title : "Task to calculate wavelength dependent absorption";
@@ -107,6 +108,10 @@ Int_t MSimAbsorption::PreProcess(MParList *pList)
 
     *fLog << inf << "Using " << (fUseTheta?"Theta":"Wavelength") << " for absorption." << endl;
 
+    fRandom = (MSimRandom*)pList->FindObject("MSimRandom");
+    if (fRandom && !fRandom->Setup(*pList))
+        return kFALSE;
+
     return kTRUE;
 }
 
@@ -152,6 +157,9 @@ Int_t MSimAbsorption::Process()
     // Get the number of photons in the list
     const Int_t num = fEvt->GetNumPhotons();
 
+    // Random number stream of this task
+    TRandom &rnd = MSimRandom::GetStream(fRandom, *this);
+
     // Counter for number of total and final events
     Int_t cnt = 0;
     for (Int_t i=0; i<num; i++)
@@ -167,8 +175,8 @@ Int_t MSimAbsorption::Process()
         const Double_t eff = fSpline->Eval(wl);
 
         // Get a random value between 0 and 1 to determine whether the photn will survive
-        // gRandom->Rndm() = [0;1[
-        if (gRandom->Rndm()>=eff)
+        // rnd.Rndm() = [0;1[
+        if (rnd.Rndm()>=eff)
             continue;
 
         // Copy the surviving events bakc in the list
@@ -10,10 +10,12 @@ class MParSpline;
 class MPhotonEvent;
 class MCorsikaRunHeader;
 class MCorsikaEvtHeader;
+class MSimRandom;
 
 class MSimAbsorption : public MTask
 {
 private:
+    MSimRandom        *fRandom;    //! Random number service (optional)
     MPhotonEvent      *fEvt;       //! Event stroing the photons
     MCorsikaRunHeader *fRunHeader; //! Corsika run header
     MCorsikaEvtHeader *fHeader;    //! Header storing event information
@@ -35,6 +35,14 @@
 //  Output Containers:
 //   MPhotonEvent
 //
+//  If UseTable is set, the transmission is tabulated at ReInit on a grid
+//  of production height above the observation level (0-50km in steps of
+//  500m), zenith angle (0-89deg in steps of 1deg) and wavelength (range
+//  of the run header in steps of 5nm) and interpolated trilinearly for
+//  each photon. The table is only recalculated if the atmosphere or the
+//  wavelength range of the run changes. Photons outside of the grid are
+//  treated with the full calculation.
+//
 //////////////////////////////////////////////////////////////////////////////
 #include "MSimAtmosphere.h"
 
@@ -46,7 +54,10 @@
 #include "MLog.h"
 #include "MLogManip.h"
 
+#include "MArrayF.h"
+
 #include "MParList.h"
+#include "MSimRandom.h"
 
 #include "MCorsikaRunHeader.h"
 #include "MPhotonEvent.h"
@@ -217,6 +228,16 @@ public:
     // Get the Earth radius to be used
     Double_t R() const { return fR; }
 
+    // Check if both atmospheres have been initialized with identical
+    // observation level, earth radius, layer boundaries and parameters
+    Bool_t IsEqual(const MAtmRayleigh &a) const
+    {
+        return fObsLevel==a.fObsLevel && fR==a.fR &&
+            memcmp(fHeight, a.fHeight, sizeof(Double_t)*5)==0 &&
+            memcmp(fAtmB, a.fAtmB, sizeof(Float_t)*4)==0 &&
+            memcmp(fAtmC, a.fAtmC, sizeof(Float_t)*4)==0;
+    }
+
     // Init an atmosphere from the data stored in MCorsikaRunHeader
     // This initialized fObsLevel, fR, fAtmB and fAtmC and
     // PreCalcRho
@@ -416,13 +437,36 @@ private:
     TGraph *fAbsCoeffOzone;
     TGraph *fAbsCoeffAerosols;
 
+    TString fNameOzone;     // Name of the file with the ozone absorption
+    TString fNameAerosols;  // Name of the file with the aerosol absorption
+
+    // Transmission tabulated on a grid of production height above the
+    // observation level, zenith angle and wavelength. The index of a node
+    // is (iz*fTableNt + it)*fTableNw + iw
+    MAtmRayleigh fTableAtm; // Atmosphere for which the table was calculated
+    MArrayF  fTable;        // Transmission at the nodes
+
+    Double_t fTableStepZ;   // [cm]  Step in height above observation level
+    Double_t fTableStepT;   // [rad] Step in zenith angle
+    Double_t fTableStepW;   // [nm]  Step in wavelength
+    Double_t fTableMinW;    // [nm]  Wavelength of the first node
+    Double_t fTableMaxW;    // [nm]  Requested upper limit in wavelength
+
+    Int_t fTableNz;         // Number of nodes in height
+    Int_t fTableNt;         // Number of nodes in zenith angle
+    Int_t fTableNw;         // Number of nodes in wavelength
+
 public:
-    MAtmosphere(const MCorsikaRunHeader &h) : fAbsCoeffOzone(0), fAbsCoeffAerosols(0)
+    MAtmosphere(const MCorsikaRunHeader &h) : fAbsCoeffOzone(0), fAbsCoeffAerosols(0),
+        fTableStepZ(0), fTableStepT(0), fTableStepW(0), fTableMinW(0), fTableMaxW(0),
+        fTableNz(0), fTableNt(0), fTableNw(0)
     {
         Init(h);//, "ozone.txt", "aerosols.txt");
     }
 
-    MAtmosphere(const char *name1=0, const char *name2=0) : fAbsCoeffOzone(0), fAbsCoeffAerosols(0)
+    MAtmosphere(const char *name1=0, const char *name2=0) : fAbsCoeffOzone(0), fAbsCoeffAerosols(0),
+        fTableStepZ(0), fTableStepT(0), fTableStepW(0), fTableMinW(0), fTableMaxW(0),
+        fTableNz(0), fTableNt(0), fTableNw(0)
     {
         if (name1)
             InitOzone(name1);
@@ -527,6 +571,11 @@ public:
 
             fAbsCoeffOzone = new TGraph(name);
             fAbsCoeffOzone->Sort();
+
+            // The transmission table is only valid for the same file
+            if (name!=fNameOzone)
+                fTable.Set(0);
+            fNameOzone = name;
         }
 
         if (!HasValidAerosol())
@@ -547,6 +596,11 @@ public:
 
             fAbsCoeffAerosols = new TGraph(name);
             fAbsCoeffAerosols->Sort();
+
+            // The transmission table is only valid for the same file
+            if (name!=fNameAerosols)
+                fTable.Set(0);
+            fNameAerosols = name;
         }
 
         if (!HasValidAerosol())
@@ -635,14 +689,13 @@ public:
         return TMath::Exp(-beta0*path);
     }
 
-    Double_t GetTransmission(const MPhotonData &ph) const
+    // Transmission for light emitted at height (a.s.l., measured in the
+    // vertical of the observer) with wavelength [nm] and zenith angle theta
+    // (sin2=sin(theta)^2)
+    Double_t GetTransmission(Double_t height, Double_t wavelength, Double_t sin2) const
     {
-        const Double_t wavelength = ph.GetWavelength();
-        const Double_t height     = ph.GetProductionHeight();
-
         // Reduce the necessary number of floating point operations
         // by storing the intermediate results
-        const Double_t sin2  = ph.GetSinW2();
         const Double_t cost  = TMath::Sqrt(1-sin2);
         const Double_t theta = TMath::ACos(cost);
 
@@ -680,6 +733,107 @@ public:
         // Calculate final transmission coefficient
         return T_Ray * T_Oz * T_Mie;
     }
+
+    Double_t GetTransmission(const MPhotonData &ph) const
+    {
+        return GetTransmission(ph.GetProductionHeight(), ph.GetWavelength(), ph.GetSinW2());
+    }
+
+    Bool_t IsTableValid() const { return fTable.GetSize()>0; }
+    Int_t  GetTableSize() const { return fTable.GetSize(); }
+
+    // --------------------------------------------------------------------------
+    //
+    // Tabulate the transmission for heights from the observation level up
+    // to zmax above, zenith angles from 0 to 89deg and wavelengths from
+    // wlmin to wlmax with the given steps (heights in cm, angles in rad,
+    // wavelengths in nm). The table is kept if it was already calculated
+    // for the same atmosphere and grid. Returns kTRUE if it was
+    // (re-)calculated.
+    //
+    Bool_t InitTable(Double_t wlmin, Double_t wlmax, Double_t zmax, Double_t dz, Double_t dt, Double_t dw)
+    {
+        if (IsTableValid() && fTableAtm.IsEqual(*this) &&
+            fTableStepZ==dz && fTableStepT==dt && fTableStepW==dw &&
+            fTableMinW==wlmin && fTableMaxW==wlmax && (fTableNz-1)*dz>=zmax)
+            return kFALSE;
+
+        fTableAtm   = *this;
+        fTableStepZ = dz;
+        fTableStepT = dt;
+        fTableStepW = dw;
+        fTableMinW  = wlmin;
+        fTableMaxW  = wlmax;
+
+        // At least two nodes in each dimension
+        fTableNz = TMath::Max(2, TMath::CeilNint(zmax/dz)+1);
+        fTableNt = TMath::Max(2, TMath::Nint(89*STEPTHETA/dt)+1);
+        fTableNw = TMath::Max(2, TMath::CeilNint((wlmax-wlmin)/dw)+1);
+
+        fTable.Set(fTableNz*fTableNt*fTableNw);
+
+        Float_t *ptr = fTable.GetArray();
+        for (Int_t iz=0; iz<fTableNz; iz++)
+        {
+            const Double_t height = fObsLevel + iz*dz;
+
+            for (Int_t it=0; it<fTableNt; it++)
+            {
+                const Double_t sint = TMath::Sin(it*dt);
+                const Double_t sin2 = sint*sint;
+
+                for (Int_t iw=0; iw<fTableNw; iw++)
+                    *ptr++ = GetTransmission(height, wlmin + iw*dw, sin2);
+            }
+        }
+
+        return kTRUE;
+    }
+
+    // --------------------------------------------------------------------------
+    //
+    // Trilinear interpolation of the transmission in the table. Photons
+    // outside of the table fall back to the full calculation.
+    //
+    Double_t GetTransmissionTable(const MPhotonData &ph) const
+    {
+        const Double_t sin2 = ph.GetSinW2();
+
+        const Double_t z = (ph.GetProductionHeight()-fObsLevel)/fTableStepZ;
+        const Double_t t = TMath::ACos(TMath::Sqrt(1-sin2))/fTableStepT;
+        const Double_t w = (ph.GetWavelength()-fTableMinW)/fTableStepW;
+
+        // The negated checks also catch invalid (NaN) values
+        if (!(z>=0 && z<=fTableNz-1 && t>=0 && t<=fTableNt-1 && w>=0 && w<=fTableNw-1))
+            return GetTransmission(ph);
+
+        const Int_t iz = TMath::Min(Int_t(z), fTableNz-2);
+        const Int_t it = TMath::Min(Int_t(t), fTableNt-2);
+        const Int_t iw = TMath::Min(Int_t(w), fTableNw-2);
+
+        const Double_t fz = z-iz;
+        const Double_t ft = t-it;
+        const Double_t fw = w-iw;
+
+        // Nodes (iz, it, iw) and the neighbours in t and z
+        const Float_t *p00 = fTable.GetArray() + (iz*fTableNt + it)*fTableNw + iw;
+        const Float_t *p01 = p00 + fTableNw;
+        const Float_t *p10 = p00 + fTableNt*fTableNw;
+        const Float_t *p11 = p10 + fTableNw;
+
+        // Interpolate in wavelength...
+        const Double_t c00 = p00[0] + fw*(p00[1]-p00[0]);
+        const Double_t c01 = p01[0] + fw*(p01[1]-p01[0]);
+        const Double_t c10 = p10[0] + fw*(p10[1]-p10[0]);
+        const Double_t c11 = p11[0] + fw*(p11[1]-p11[0]);
+
+        // ...zenith angle...
+        const Double_t c0 = c00 + ft*(c01-c00);
+        const Double_t c1 = c10 + ft*(c11-c10);
+
+        // ...and height
+        return c0 + fz*(c1-c0);
+    }
 };
 
 const Double_t MAtmosphere::STEPTHETA = 1.74533e-2; // aprox. 1 degree
@@ -697,10 +851,10 @@ const Double_t MAtmosphere::oz_conc[51]={0.3556603E-02, 0.3264150E-02, 0.2933961
 //  Default Constructor.
 //
 MSimAtmosphere::MSimAtmosphere(const char* name, const char *title)
-    : fRunHeader(0), fEvt(0), fAtmosphere(0),
+    : fRandom(0), fRunHeader(0), fEvt(0), fAtmosphere(0),
     fFileAerosols("resmc/atmosphere-aerosols.txt"),
     fFileOzone("resmc/atmosphere-ozone.txt"),
-    fForce(kFALSE)
+    fForce(kFALSE), fUseTable(kFALSE)
 {
     fName  = name  ? name  : "MSimAtmosphere";
     fTitle = title ? title : "Simulate the wavelength and height-dependant atmpsheric absorption";
@@ -732,6 +886,10 @@ Int_t MSimAtmosphere::PreProcess(MParList *pList)
     }
 
 
+    fRandom = (MSimRandom*)pList->FindObject("MSimRandom");
+    if (fRandom && !fRandom->Setup(*pList))
+        return kFALSE;
+
     return kTRUE;
 }
 
@@ -785,6 +943,17 @@ Bool_t MSimAtmosphere::ReInit(MParList *pList)
     if (!fRunHeader->Has(MCorsikaRunHeader::kRefraction))
         *fLog << warn << "WARNING - Refraction calculation disabled for Corsika data." << endl;
 
+    if (!fUseTable)
+        return kTRUE;
+
+    // Heights up to 50km above the observation level in steps of 500m,
+    // zenith angles in steps of 1deg and wavelengths in steps of 5nm
+    const Double_t wlmin = fRunHeader->GetWavelengthMin();
+    const Double_t wlmax = fRunHeader->GetWavelengthMax();
+
+    if (fAtmosphere->InitTable(wlmin, wlmax, 50e5, 5e4, TMath::DegToRad(), 5))
+        *fLog << inf << "Atmospheric transmission tabulated at " << fAtmosphere->GetTableSize() << " nodes." << endl;
+
     return kTRUE;
 }
 
@@ -804,6 +973,25 @@ Int_t MSimAtmosphere::Process()
     //         * upgoing particles
     //         * Can we take the full length until the camera into account?
 
+    // Get the atmospheric transmission for all photons first
+    // (no dependency between the photons)
+    fTransmission.Set(num);
+
+    Float_t *eff = fTransmission.GetArray();
+    if (fUseTable)
+    {
+        for (Int_t i=0; i<num; i++)
+            eff[i] = fAtmosphere->GetTransmissionTable((*fEvt)[i]);
+    }
+    else
+    {
+        for (Int_t i=0; i<num; i++)
+            eff[i] = fAtmosphere->GetTransmission((*fEvt)[i]);
+    }
+
+    // Random number stream of this task
+    TRandom &rnd = MSimRandom::GetStream(fRandom, *this);
+
     // Counter for number of total and final events
     Int_t cnt = 0;
     for (Int_t i=0; i<num; i++)
@@ -811,12 +999,9 @@ Int_t MSimAtmosphere::Process()
         // Get i-th photon from the list
         const MPhotonData &ph = (*fEvt)[i];
 
-        // Get atmospheric transmission for this photon
-        const Double_t eff = fAtmosphere->GetTransmission(ph);
-
         // Get a random value between 0 and 1 to determine whether the photon will survive
-        // gRandom->Rndm() = [0;1[
-        if (gRandom->Rndm()>=eff)
+        // rnd.Rndm() = [0;1[
+        if (rnd.Rndm()>=eff[i])
             continue;
 
         // Copy the surviving events bakc in the list
@@ -866,6 +1051,8 @@ Int_t MSimAtmosphere::Process()
 //
 // FileAerosols: resmc/atmosphere-aerosols.txt
 // FileOzone:    resmc/atmosphere-ozone.txt
+// Force:        No
+// UseTable:     No
 //
 Int_t MSimAtmosphere::ReadEnv(const TEnv &env, TString prefix, Bool_t print)
 {
@@ -889,5 +1076,11 @@ Int_t MSimAtmosphere::ReadEnv(const TEnv &env, TString prefix, Bool_t print)
         fForce = GetEnvValue(env, prefix, "Force", fForce);
     }
 
+    if (IsEnvDefined(env, prefix, "UseTable", print))
+    {
+        rc = kTRUE;
+        fUseTable = GetEnvValue(env, prefix, "UseTable", fUseTable);
+    }
+
     return rc;
 }
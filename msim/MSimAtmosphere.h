@@ -4,15 +4,20 @@
 #ifndef MARS_MTask
 #include "MTask.h"
 #endif
+#ifndef MARS_MArrayF
+#include "MArrayF.h"
+#endif
 
 class MParList;
 class MAtmosphere;
 class MPhotonEvent;
 class MCorsikaRunHeader;
+class MSimRandom;
 
 class MSimAtmosphere : public MTask
 {
 private:
+    MSimRandom        *fRandom;    //! Random number service (optional)
     MCorsikaRunHeader *fRunHeader; //! Corsika run header
     MPhotonEvent *fEvt;            //! Event stroing the photons
 
@@ -22,6 +27,9 @@ private:
     TString fFileOzone;        // Name of file with ozone absorption
 
     Bool_t fForce;             // Force execution in case efficiencies are already included (CEFFIC)
+    Bool_t fUseTable;          // Interpolate the transmission in a table calculated at ReInit
+
+    MArrayF fTransmission;     //! Transmission of the photons of the current event
 
     // MParContainer
     Int_t ReadEnv(const TEnv &env, TString prefix, Bool_t print=kFALSE);
@@ -35,6 +43,8 @@ public:
     MSimAtmosphere(const char *name=NULL, const char *title=NULL);
     ~MSimAtmosphere();
 
+    void SetUseTable(Bool_t b=kTRUE) { fUseTable = b; }
+
     ClassDef(MSimAtmosphere, 0) // Simulate the wavelength and height-dependant atmpsheric absorption
 };
 
@@ -0,0 +1,130 @@
+/* ======================================================================== *\
+!
+! *
+! * This file is part of MARS, the MAGIC Analysis and Reconstruction
+! * Software. It is distributed to you in the hope that it can be a useful
+! * and timesaving tool in analysing Data of imaging Cerenkov telescopes.
+! * It is distributed WITHOUT ANY WARRANTY.
+! *
+! * Permission to use, copy, modify and distribute this software and its
+! * documentation for any purpose is hereby granted without fee,
+! * provided that the above copyright notice appear in all copies and
+! * that both that copyright notice and this permission notice appear
+! * in supporting documentation. It is provided "as is" without express
+! * or implied warranty.
+! *
+!
+!
+!   Copyright: MAGIC Software Development, 2000-2026
+!
+!
+\* ======================================================================== */
+
+//////////////////////////////////////////////////////////////////////////////
+//
+//  MSimPhotonIndex
+//
+//  Builds the index of the photons sorted by pixel (MPhotonIndex) for
+//  the tasks which simulate the pixels one after the other (MSimAPD,
+//  MSimCamera). The number of pixels is taken from MPhotonStatistics.
+//
+//  The index is only valid as long as the photon list is not changed.
+//  Therefore the task has to be placed after the last task which adds
+//  or removes photons or changes their tags (e.g. MSimRandomPhotons,
+//  MSimAPD, MSimBundlePhotons) before the task using the index. The
+//  tasks using the index build it themselves if it is not valid, so
+//  this task is not mandatory.
+//
+//  If Sort is set the photons are sorted in time before (see
+//  MPhotonEvent::Sort), so that the photons of each pixel are in time
+//  order. This is needed by MSimAPD.
+//
+//  Input Containers:
+//   MPhotonEvent
+//   MPhotonStatistics
+//
+//  Output Containers:
+//   MPhotonIndex
+//
+//////////////////////////////////////////////////////////////////////////////
+#include "MSimPhotonIndex.h"
+
+#include "MLog.h"
+#include "MLogManip.h"
+
+#include "MParList.h"
+
+#include "MPhotonEvent.h"
+#include "MPhotonIndex.h"
+
+ClassImp(MSimPhotonIndex);
+
+using namespace std;
+
+// --------------------------------------------------------------------------
+//
+// Default Constructor.
+//
+MSimPhotonIndex::MSimPhotonIndex(const char* name, const char *title)
+    : fEvt(0), fStat(0), fIndex(0), fSort(kFALSE)
+{
+    fName  = name  ? name  : "MSimPhotonIndex";
+    fTitle = title ? title : "Task to build the index of the photons sorted by pixel";
+}
+
+// --------------------------------------------------------------------------
+//
+// Search for the needed parameter containers.
+//
+Int_t MSimPhotonIndex::PreProcess(MParList *pList)
+{
+    fEvt = (MPhotonEvent*)pList->FindObject("MPhotonEvent");
+    if (!fEvt)
+    {
+        *fLog << err << "MPhotonEvent not found... aborting." << endl;
+        return kFALSE;
+    }
+
+    fStat = (MPhotonStatistics*)pList->FindObject("MPhotonStatistics");
+    if (!fStat)
+    {
+        *fLog << err << "MPhotonStatistics not found... aborting." << endl;
+        return kFALSE;
+    }
+
+    fIndex = (MPhotonIndex*)pList->FindCreateObj("MPhotonIndex");
+    if (!fIndex)
+        return kFALSE;
+
+    return kTRUE;
+}
+
+// --------------------------------------------------------------------------
+//
+// Sort the photons (if requested) and build the index
+//
+Int_t MSimPhotonIndex::Process()
+{
+    if (fSort)
+        fEvt->Sort();
+
+    fIndex->Build(*fEvt, fStat->GetMaxIndex()+1);
+
+    return kTRUE;
+}
+
+// --------------------------------------------------------------------------
+//
+// Sort: Off
+//
+Int_t MSimPhotonIndex::ReadEnv(const TEnv &env, TString prefix, Bool_t print)
+{
+    Bool_t rc = kFALSE;
+    if (IsEnvDefined(env, prefix, "Sort", print))
+    {
+        rc = kTRUE;
+        fSort = GetEnvValue(env, prefix, "Sort", fSort);
+    }
+
+    return rc;
+}
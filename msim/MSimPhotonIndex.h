@@ -0,0 +1,37 @@
+#ifndef MARS_MSimPhotonIndex
+#define MARS_MSimPhotonIndex
+
+#ifndef MARS_MTask
+#include "MTask.h"
+#endif
+
+class MParList;
+class MPhotonEvent;
+class MPhotonStatistics;
+class MPhotonIndex;
+
+class MSimPhotonIndex : public MTask
+{
+private:
+    MPhotonEvent      *fEvt;    //! Event storing the photons
+    MPhotonStatistics *fStat;   //! Maximum pixel index
+    MPhotonIndex      *fIndex;  //! Output: photons sorted by pixel
+
+    Bool_t fSort;               // Sort the photons in time before the index is built
+
+    // MParContainer
+    Int_t ReadEnv(const TEnv &env, TString prefix, Bool_t print=kFALSE);
+
+    // MTask
+    Int_t PreProcess(MParList *pList);
+    Int_t Process();
+
+public:
+    MSimPhotonIndex(const char *name=NULL, const char *title=NULL);
+
+    void SetSort(Bool_t b=kTRUE) { fSort = b; }
+
+    ClassDef(MSimPhotonIndex, 0) // Task to build the index of the photons sorted by pixel
+};
+
+#endif
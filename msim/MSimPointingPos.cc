@@ -83,6 +83,7 @@
 #include "MLogManip.h"
 
 #include "MParList.h"
+#include "MSimRandom.h"
 
 #include "MCorsikaEvtHeader.h"
 #include "MCorsikaRunHeader.h"
@@ -98,7 +99,7 @@ using namespace std;
 //  Default Constructor.
 //
 MSimPointingPos::MSimPointingPos(const char* name, const char *title)
-    : fRunHeader(0), fEvtHeader(0), fPointing(0), fSimSourcePosition(0),
+    : fRandom(0), fRunHeader(0), fEvtHeader(0), fPointing(0), fSimSourcePosition(0),
     fOffTargetDistance(0), fOffTargetPhi(-1)
 
 {
@@ -190,6 +191,10 @@ Int_t MSimPointingPos::PreProcess(MParList *pList)
     else
         *fLog << "   a homogenous distribution up to a distance of " << -GetOffTargetDistance() << "deg " << endl;
 
+    fRandom = (MSimRandom*)pList->FindObject("MSimRandom");
+    if (fRandom && !fRandom->Setup(*pList))
+        return kFALSE;
+
     return kTRUE;
 }
 
@@ -205,17 +210,17 @@ Bool_t MSimPointingPos::ReInit(MParList *pList)
     return kTRUE;
 }
 
-void MSimPointingPos::GetDelta(Double_t &dtheta, Double_t &dphi) const
+void MSimPointingPos::GetDelta(TRandom &rnd, Double_t &dtheta, Double_t &dphi) const
 {
     if (fOffTargetDistance>0)
     {
         dtheta = fOffTargetDistance;
-        dphi   = fOffTargetPhi>=0 ? fOffTargetPhi : gRandom->Uniform(TMath::TwoPi());
+        dphi   = fOffTargetPhi>=0 ? fOffTargetPhi : rnd.Uniform(TMath::TwoPi());
     }
     else
     {
-        dtheta = TMath::Sqrt(gRandom->Uniform(fOffTargetDistance));
-        dphi   = gRandom->Uniform(TMath::TwoPi());
+        dtheta = TMath::Sqrt(rnd.Uniform(fOffTargetDistance));
+        dphi   = rnd.Uniform(TMath::TwoPi());
     }
 }
 
@@ -232,7 +237,7 @@ Int_t MSimPointingPos::Process()
 
     // Calculate off target position in local sky coordinates
     Double_t dtheta, dphi;
-    GetDelta(dtheta, dphi);
+    GetDelta(MSimRandom::GetStream(fRandom, *this), dtheta, dphi);
 
     const Double_t theta = zdCorsika*TMath::DegToRad();
     const Double_t phi   = azCorsika*TMath::DegToRad();
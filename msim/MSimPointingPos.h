@@ -5,14 +5,18 @@
 #include "MTask.h"
 #endif
 
+class TRandom;
+
 class MParList;
 class MCorsikaEvtHeader;
 class MCorsikaRunHeader;
 class MPointingPos;
+class MSimRandom;
 
 class MSimPointingPos : public MTask
 {
 private:
+    MSimRandom        *fRandom;     //! Random number service (optional)
     MCorsikaRunHeader *fRunHeader;  //! Header storing event information
     MCorsikaEvtHeader *fEvtHeader;  //! Header storing event information
     MPointingPos      *fPointing;   //! Output storing telescope pointing position in local (telescope) coordinate system
@@ -22,7 +26,7 @@ private:
     Double_t fOffTargetPhi;         // [rad] Rotation angle of the off-target position (phi==0 means south, phi=90 west) [0;2pi], phi<0 means random
 
     // MSimPointingPos
-    void GetDelta(Double_t &dtheta, Double_t &dphi) const;
+    void GetDelta(TRandom &rnd, Double_t &dtheta, Double_t &dphi) const;
 
     // MParContainer
     Int_t ReadEnv(const TEnv &env, TString prefix, Bool_t print=kFALSE);
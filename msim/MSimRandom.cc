@@ -0,0 +1,187 @@
+/* ======================================================================== *\
+!
+! *
+! * This file is part of MARS, the MAGIC Analysis and Reconstruction
+! * Software. It is distributed to you in the hope that it can be a useful
+! * and timesaving tool in analysing Data of imaging Cerenkov telescopes.
+! * It is distributed WITHOUT ANY WARRANTY.
+! *
+! * Permission to use, copy, modify and distribute this software and its
+! * documentation for any purpose is hereby granted without fee,
+! * provided that the above copyright notice appear in all copies and
+! * that both that copyright notice and this permission notice appear
+! * in supporting documentation. It is provided "as is" without express
+! * or implied warranty.
+! *
+!
+!
+!   Copyright: MAGIC Software Development, 2000-2026
+!
+!
+\* ======================================================================== */
+
+
+//////////////////////////////////////////////////////////////////////////////
+//
+//  MSimRandom
+//
+//  Random number service for the simulation tasks. If it is available in
+//  the parameter list, each task gets its own stream of random numbers
+//  (MRandomPhilox) instead of using gRandom. A stream is identified by
+//
+//    - the seed (common to all streams)
+//    - the name of the task (and an optional sub-stream index)
+//    - the run number (MCorsikaRunHeader)
+//    - the event number and the reuse number (MCorsikaEvtHeader)
+//
+//  and restarted at the beginning of each event. Therefore the random
+//  numbers of a task in an event are independent of all other tasks and
+//  of the order in which the events are processed. Single events can be
+//  reproduced, and events or parts of them (using sub-streams, e.g. one
+//  per pixel) can be simulated in parallel.
+//
+//  If no event header is available (e.g. pedestal or calibration runs)
+//  or it was never filled (event number 0, e.g. MSimRays) the number of
+//  executions of the task is used as event number.
+//
+//  Usage in a task:
+//
+//    PreProcess:
+//      fRandom = (MSimRandom*)plist->FindObject("MSimRandom");
+//      if (fRandom && !fRandom->Setup(*plist))
+//          return kFALSE;
+//
+//    Process:
+//      TRandom &rnd = MSimRandom::GetStream(fRandom, *this);
+//
+//  If fRandom is NULL gRandom is returned, i.e. without MSimRandom in the
+//  parameter list the behaviour is unchanged.
+//
+//  Resources:
+//    MSimRandom.Seed: 0
+//
+//  A seed of 0 means that the seed of gRandom is used when Setup() is
+//  called the first time (see MJob::InitRandomNumberGenerator).
+//
+//////////////////////////////////////////////////////////////////////////////
+#include "MSimRandom.h"
+
+#include <TRandom.h>
+
+#include "MLog.h"
+#include "MLogManip.h"
+
+#include "MTask.h"
+#include "MParList.h"
+#include "MRandomPhilox.h"
+
+#include "MCorsikaRunHeader.h"
+#include "MCorsikaEvtHeader.h"
+
+ClassImp(MSimRandom);
+
+using namespace std;
+
+// --------------------------------------------------------------------------
+//
+// Default constructor.
+//
+MSimRandom::MSimRandom(const char *name, const char *title)
+    : fRunHeader(0), fEvtHeader(0), fSeed(0), fIsSetup(kFALSE)
+{
+    fName  = name  ? name  : "MSimRandom";
+    fTitle = title ? title : "Random number service for the simulation tasks";
+
+    fStreams.SetOwner();
+}
+
+// --------------------------------------------------------------------------
+//
+// Search for MCorsikaRunHeader and MCorsikaEvtHeader (both optional)
+// and take the seed from gRandom if none was set. Can be called by all
+// tasks using the service, only the first call has an effect.
+//
+Bool_t MSimRandom::Setup(MParList &plist)
+{
+    if (fIsSetup)
+        return kTRUE;
+
+    fRunHeader = (MCorsikaRunHeader*)plist.FindObject("MCorsikaRunHeader");
+    fEvtHeader = (MCorsikaEvtHeader*)plist.FindObject("MCorsikaEvtHeader");
+
+    if (fSeed==0)
+        fSeed = gRandom->GetSeed();
+
+    *fLog << inf << "Random number streams initialized with seed " << fSeed << "." << endl;
+
+    fIsSetup = kTRUE;
+    return kTRUE;
+}
+
+// --------------------------------------------------------------------------
+//
+// Start the stream of the current event for the sub-stream sub of the
+// given task in rnd.
+//
+void MSimRandom::InitStream(MRandomPhilox &rnd, const MTask &task, UInt_t sub) const
+{
+    // Corsika event numbers start at 1
+    const Bool_t hdr = fEvtHeader && fEvtHeader->GetEvtNumber()>0;
+
+    const UInt_t run   = fRunHeader ? fRunHeader->GetRunNumber() : 0;
+    const UInt_t evt   = hdr ? fEvtHeader->GetEvtNumber() : task.GetNumExecutions();
+    const UInt_t reuse = hdr ? fEvtHeader->GetNumReuse()  : 0;
+
+    // The golden ratio spreads the sub-streams over the key space
+    const UInt_t key = TString(task.GetName()).Hash() + sub*0x9E3779B9;
+
+    rnd.SetSeed(fSeed);
+    rnd.SetStream(key, run, evt, reuse);
+}
+
+// --------------------------------------------------------------------------
+//
+// Return the generator of the task (created at first use) started at
+// the beginning of the stream of the current event.
+//
+TRandom &MSimRandom::GetStream(const MTask &task)
+{
+    MRandomPhilox *rnd = static_cast<MRandomPhilox*>(fStreams.FindObject(task.GetName()));
+    if (!rnd)
+    {
+        rnd = new MRandomPhilox;
+        rnd->SetName(task.GetName());
+        fStreams.Add(rnd);
+    }
+
+    InitStream(*rnd, task);
+
+    return *rnd;
+}
+
+// --------------------------------------------------------------------------
+//
+// Return rnd->GetStream(task) or gRandom if rnd is NULL.
+//
+TRandom &MSimRandom::GetStream(MSimRandom *rnd, const MTask &task)
+{
+    return rnd ? rnd->GetStream(task) : *gRandom;
+}
+
+// --------------------------------------------------------------------------
+//
+// Read the seed from the resource file:
+//
+//   MSimRandom.Seed: 0
+//
+Int_t MSimRandom::ReadEnv(const TEnv &env, TString prefix, Bool_t print)
+{
+    Bool_t rc = kFALSE;
+    if (IsEnvDefined(env, prefix, "Seed", print))
+    {
+        rc = kTRUE;
+        fSeed = GetEnvValue(env, prefix, "Seed", (Int_t)fSeed);
+    }
+
+    return rc;
+}
@@ -0,0 +1,51 @@
+#ifndef MARS_MSimRandom
+#define MARS_MSimRandom
+
+#ifndef MARS_MParContainer
+#include "MParContainer.h"
+#endif
+
+#ifndef ROOT_THashList
+#include <THashList.h>
+#endif
+
+class TRandom;
+
+class MTask;
+class MParList;
+class MRandomPhilox;
+class MCorsikaRunHeader;
+class MCorsikaEvtHeader;
+
+class MSimRandom : public MParContainer
+{
+private:
+    MCorsikaRunHeader *fRunHeader; //! Run header (run number)
+    MCorsikaEvtHeader *fEvtHeader; //! Event header (event and reuse number)
+
+    UInt_t    fSeed;     // Seed of all streams (0: seed of gRandom)
+    Bool_t    fIsSetup;  //! Setup() was called
+
+    THashList fStreams;  //! One generator per task
+
+    // MParContainer
+    Int_t ReadEnv(const TEnv &env, TString prefix, Bool_t print=kFALSE);
+
+public:
+    MSimRandom(const char *name=NULL, const char *title=NULL);
+
+    void   SetSeed(UInt_t seed) { fSeed = seed; }
+    UInt_t GetSeed() const { return fSeed; }
+
+    Bool_t Setup(MParList &plist);
+
+    void InitStream(MRandomPhilox &rnd, const MTask &task, UInt_t sub=0) const;
+
+    TRandom &GetStream(const MTask &task);
+
+    static TRandom &GetStream(MSimRandom *rnd, const MTask &task);
+
+    ClassDef(MSimRandom, 1) // Random number service for the simulation tasks
+};
+
+#endif
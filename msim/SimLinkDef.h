@@ -17,4 +17,9 @@
 
 #pragma link C++ class MSimMMCS+;
 
+#pragma link C++ class MSimRandom+;
+
+#pragma link C++ class MPhotonIndex+;
+#pragma link C++ class MSimPhotonIndex+;
+
 #endif
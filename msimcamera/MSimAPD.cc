@@ -33,7 +33,9 @@
 // that the APD is always in the same condition.
 //
 // For every photon and event the behaviour of the APD is simulated. The
-// output is set as weight to the MPhotonData containers.
+// output is set as weight to the MPhotonData containers. The APDs are
+// simulated one after the other, each with its photons in time order
+// (see MPhotonIndex).
 //
 // Remark:
 //   - The photon rate used to initialize the APD must match the one used
@@ -43,9 +45,11 @@
 //   fNameGeomCam [MGeomCam]
 //   MPhotonEvent
 //   MPhotonStatistics
+//   MPhotonIndex (built if not valid)
 //
 //  Output Containers:
 //   MPhotonEvent
+//   MPhotonIndex
 //
 //////////////////////////////////////////////////////////////////////////////
 #include "MSimAPD.h"
@@ -58,11 +62,13 @@
 
 #include "MMath.h"
 #include "MParList.h"
+#include "MSimRandom.h"
 
 #include "MGeomCam.h"
 
 #include "MPhotonEvent.h"
 #include "MPhotonData.h"
+#include "MPhotonIndex.h"
 
 #include "MPedestalCam.h"
 #include "MPedestalPix.h"
@@ -80,7 +86,7 @@ using namespace std;
 //  Default Constructor.
 //
 MSimAPD::MSimAPD(const char* name, const char *title)
-    : fGeom(0), fEvt(0), fStat(0), fType(1),
+    : fRandom(0), fGeom(0), fEvt(0), fStat(0), fIndex(0), fType(1),
     fNumCells(60), fCrosstalkCoeff(0), fDeadTime(3),
     fRecoveryTime(8.75), fAfterpulseProb1(0.11), fAfterpulseProb2(0.14)
 
@@ -128,6 +134,10 @@ Int_t MSimAPD::PreProcess(MParList *pList)
         return kFALSE;
     }
 
+    fIndex = (MPhotonIndex*)pList->FindCreateObj("MPhotonIndex");
+    if (!fIndex)
+        return kFALSE;
+
     fCrosstalkCoeffParam = (MParameterD*)pList->FindCreateObj("MParameterD","CrosstalkCoeffParam");
     if (!fCrosstalkCoeffParam)
     {
@@ -144,6 +154,10 @@ Int_t MSimAPD::PreProcess(MParList *pList)
         *fLog << " using " << fFreq << " as default for all G-APDs." << endl;
     }
 
+    fRandom = (MSimRandom*)pList->FindObject("MSimRandom");
+    if (fRandom && !fRandom->Setup(*pList))
+        return kFALSE;
+
     return kTRUE;
 }
 
@@ -264,7 +278,24 @@ Int_t MSimAPD::Process()
     // HitRandomCellRelative the array is sorted here. If it is sorted
     // already nothing will be done since the status is stored.
     // FIXME: Check that this is true and check that it is really necessary
-    fEvt->Sort();
+    if (!fEvt->IsSorted())
+    {
+        fEvt->Sort();
+        fIndex->Reset();
+    }
+
+    // Index of the photons sorted by pixel (in time order within a pixel)
+    if (!fIndex->IsValid(*fEvt, fStat->GetMaxIndex()+1))
+        fIndex->Build(*fEvt, fStat->GetMaxIndex()+1);
+
+    if (fIndex->GetNumSkipped()>0)
+    {
+        *fLog << err << "ERROR - MSimAPD: " << fIndex->GetNumSkipped() << " photons with invalid index." << endl;
+        return kERROR;
+    }
+
+    // Random number stream of this task
+    TRandom &rnd = MSimRandom::GetStream(fRandom, *this);
 
     // This tries to initialize dead and relaxing cells properly. If
     // the APD has not been initialized before the chip is randomsly
@@ -281,43 +312,43 @@ Int_t MSimAPD::Process()
         // is below 0.1%. The also creates the possible afterpulses
         // of the future and deletes later afterpulses from the list.
         // After the the time stamp fTime is set to 0.
-        static_cast<APD*>(fAPDs.UncheckedAt(idx))->Init(freq);
-    }
+        APD *a = static_cast<APD*>(fAPDs.UncheckedAt(idx));
 
-    // Get number of photons
-    const Int_t num = fEvt->GetNumPhotons();
+        a->SetRandom(&rnd);
+        a->Init(freq);
+    }
 
-    // Loop over all photons
-    for (Int_t i=0; i<num; i++)
+    // Loop over all pixels and their photons (in time order)
+    for (UInt_t idx=0; idx<fIndex->GetNumPixels(); idx++)
     {
-        // Get i-th photon
-        MPhotonData &ph = (*fEvt)[i];
-
-        // Get arrival time of photon wrt to left edge of window and its index
-        const Double_t t = ph.GetTime()-fStat->GetTimeFirst();
-        const Int_t  idx = ph.GetTag();
-        if (idx<0)
-        {
-            *fLog << err << "ERROR - MSimAPD: Invalid index -1." << endl;
-            return kERROR;
-        }
+        APD *a = static_cast<APD*>(fAPDs.UncheckedAt(idx));
 
-        if (ph.GetWeight()!=1)
+        for (Int_t k=fIndex->GetFirst(idx); k<fIndex->GetLast(idx); k++)
         {
-            *fLog << err << "ERROR - MSimAPD: Weight of " << i << "-th photon not 1, but " << ph.GetWeight() << endl;
-            ph.Print();
-            return kERROR;
+            // Get photon
+            const Int_t i = (*fIndex)[k];
+            MPhotonData &ph = (*fEvt)[i];
+
+            // Get arrival time of photon wrt to left edge of window
+            const Double_t t = ph.GetTime()-fStat->GetTimeFirst();
+
+            if (ph.GetWeight()!=1)
+            {
+                *fLog << err << "ERROR - MSimAPD: Weight of " << i << "-th photon not 1, but " << ph.GetWeight() << endl;
+                ph.Print();
+                return kERROR;
+            }
+
+            // Simulate hitting the APD at a time t after T0 (APD::fTime).
+            // Crosstalk is taken into account and the resulting signal height
+            // in effective "number of photons" is returned. Afterpulses until
+            // this time "hit" the G-APD and newly created afterpulses
+            // are stored in the list of afterpulses
+            const Double_t hits = a->HitRandomCellRelative(t);
+
+            // Set the weight to the input
+            ph.SetWeight(hits);
         }
-
-        // Simulate hitting the APD at a time t after T0 (APD::fTime).
-        // Crosstalk is taken into account and the resulting signal height
-        // in effective "number of photons" is returned. Afterpulses until
-        // this time "hit" the G-APD and newly created afterpulses
-        // are stored in the list of afterpulses
-        const Double_t hits = static_cast<APD*>(fAPDs.UncheckedAt(idx))->HitRandomCellRelative(t);
-
-        // Set the weight to the input
-        ph.SetWeight(hits);
     }
 
     // Now we have to shift the evolved time of all APDs to the end of our
@@ -370,6 +401,9 @@ Int_t MSimAPD::Process()
     // Now the newly added afterpulses have to be sorted into the array correctly
     fEvt->Sort();
 
+    // The index does not contain the afterpulses
+    fIndex->Reset();
+
     return kTRUE;
 }
 
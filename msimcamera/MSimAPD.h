@@ -13,15 +13,19 @@ class MGeomCam;
 class MParList;
 class MPhotonEvent;
 class MPhotonStatistics;
+class MPhotonIndex;
 class MPedestalCam;
 class MParameterD;
+class MSimRandom;
 
 class MSimAPD : public MTask
 {
 private:
+    MSimRandom        *fRandom;  //! Random number service (optional)
     MGeomCam          *fGeom;    //! APD geometry (used to know how many pixels we have)
     MPhotonEvent      *fEvt;     //! Event storing the photon information
     MPhotonStatistics *fStat;    //! Storing event statistics (needed for the start-time)
+    MPhotonIndex      *fIndex;   //! Photons sorted by pixel
     MPedestalCam      *fRates;   //! Accidental Photon Rates for all pixels
 
     MParameterD       *fCrosstalkCoeffParam;
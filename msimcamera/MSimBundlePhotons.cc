@@ -48,6 +48,7 @@
 
 #include "MPhotonEvent.h"
 #include "MPhotonData.h"
+#include "MPhotonIndex.h"
 
 ClassImp(MSimBundlePhotons);
 
@@ -58,7 +59,7 @@ using namespace std;
 //  Default Constructor.
 //
 MSimBundlePhotons::MSimBundlePhotons(const char* name, const char *title)
-: fEvt(0), fStat(0)//, fFileName("mreflector/dwarf-apdmap.txt")
+: fEvt(0), fStat(0), fIndex(0)//, fFileName("mreflector/dwarf-apdmap.txt")
 {
     fName  = name  ? name  : "MSimBundlePhotons";
     fTitle = title ? title : "Task to bundle (re-index) photons according to a look-up table";
@@ -84,6 +85,9 @@ Int_t MSimBundlePhotons::PreProcess(MParList *pList)
         return kFALSE;
     }
 
+    // The index of the photons must be rebuilt after bundling
+    fIndex = (MPhotonIndex*)pList->FindObject("MPhotonIndex");
+
     if (fFileName.IsNull())
         return kSKIP;
 
@@ -187,6 +191,10 @@ Int_t MSimBundlePhotons::Process()
     // Shrink the list of photons to its new size
     fEvt->Shrink(cnt);
 
+    // The tags have changed
+    if (fIndex)
+        fIndex->Reset();
+
     // Set new maximum index (Note, that this is the maximum index
     // available in the LUT, which does not necessarily correspond
     // to, e.g., the number of pixels although it should)
@@ -12,12 +12,14 @@
 class MParList;
 class MPhotonEvent;
 class MPhotonStatistics;
+class MPhotonIndex;
 
 class MSimBundlePhotons: public MTask
 {
 private:
     MPhotonEvent      *fEvt;     //! Event storing the photons
     MPhotonStatistics *fStat;    //! Event statistics needed for crosschecks
+    MPhotonIndex      *fIndex;   //! Photons sorted by pixel (optional, invalidated)
 
     TString fFileName;           // File to from which to read the lut
     MLut    fLut;                // Look-up table
@@ -52,6 +52,7 @@
 #include <TRandom.h>
 
 #include "MParList.h"
+#include "MSimRandom.h"
 #include "MTaskList.h"
 
 #include "MLog.h"
@@ -79,7 +80,7 @@ using namespace std;
 //  Default Constructor.
 //
 MSimCalibrationSignal::MSimCalibrationSignal(const char* name, const char *title)
-    : fParList(0), fGeom(0), fPulse(0), fPulsePos(0), fTrigger(0),
+    : fRandom(0), fParList(0), fGeom(0), fPulse(0), fPulsePos(0), fTrigger(0),
     fRunHeader(0), fEvtHeader(0),  fEvt(0), fStat(0),
     fNumEvents(1000), fNumPhotons(5), fTimeJitter(1)
 {
@@ -154,6 +155,10 @@ Int_t MSimCalibrationSignal::PreProcess(MParList *pList)
     // A new file has been opened and new headers have been read.
     //  --> ReInit tasklist
     //
+    fRandom = (MSimRandom*)pList->FindObject("MSimRandom");
+    if (fRandom && !fRandom->Setup(*pList))
+        return kFALSE;
+
     return kTRUE;
 }
 
@@ -191,13 +196,16 @@ Int_t MSimCalibrationSignal::Process()
     if (!CallReInit())
         return kERROR;
 
+    // Random number stream of this task
+    TRandom &rnd = MSimRandom::GetStream(fRandom, *this);
+
     Int_t cnt = 0;
     if (fRunHeader->IsCalibrationRun())
     {
         for (UInt_t idx=0; idx<fGeom->GetNumPixels(); idx++)
         {
             // FIXME: Scale number of photons with the pixel size!
-            const Int_t num = gRandom->Poisson(fNumPhotons);
+            const Int_t num = rnd.Poisson(fNumPhotons);
 
             // FIXME: How does the distribution look like? Poissonian?
             for (Int_t i=0; i<num; i++)
@@ -205,7 +213,7 @@ Int_t MSimCalibrationSignal::Process()
                 MPhotonData &ph = fEvt->Add(cnt++);
 
                 // FIMXE: Is this the correct distribution
-                const Float_t tm = gRandom->Gaus(0, fTimeJitter);
+                const Float_t tm = rnd.Gaus(0, fTimeJitter);
 
                 ph.SetPrimary(MMcEvtBasic::kArtificial);
                 ph.SetTag(idx);
@@ -13,10 +13,12 @@ class MPhotonStatistics;
 class MParameterD;
 class MRawRunHeader;
 class MRawEvtHeader;
+class MSimRandom;
 
 class MSimCalibrationSignal : public MRead
 {
 private:
+    MSimRandom        *fRandom;     //! Random number service (optional)
     MParList          *fParList;    //! Store pointer to MParList for initializing ReInit
     MGeomCam          *fGeom;       //! Camera geometry to know the number of expected pixels
     MParSpline        *fPulse;      //! Pulse Shape to get pulse width from
@@ -32,14 +32,42 @@
 //  Input Containers:
 //   MPhotonEvent
 //   MPhotonStatistics
+//   MPhotonIndex (built if not valid)
 //   MRawRunHeader
 //
 //  Output Containers:
 //   MAnalogChannels
 //
+//  If TimeBuckets n>0 is set, the photons of each pixel are accumulated
+//  in time buckets of 1/n samples before the pulses are added. The pulse
+//  shape is tabulated once in steps of 1/n samples and added once per
+//  non-empty bucket with the summed amplitude. At high night-sky
+//  background rates many photons share a bucket and the evaluation of
+//  the spline for each photon is avoided. The arrival times are rounded
+//  to the nearest bucket, i.e. they are accurate to 1/(2n) samples.
+//
+//  The photons are sorted by pixel (MPhotonIndex) and the channels are
+//  simulated independently (electronic noise, pulses and truth
+//  information). If the random number service MSimRandom is available
+//  the channels are distributed over fNumThreads threads (<=0 means the
+//  number of cores) and each channel uses its own random number stream
+//  (sub-stream of the task), so that the result does not depend on the
+//  number of threads. Without MSimRandom all channels are simulated in a
+//  single thread using gRandom.
+//
+//  If a library of recorded pedestal traces is available (PedestalLibrary
+//  [MMatrix], one trace per row in the units of the analog signal) the
+//  electronic noise is not simulated as gaussian noise but copied from
+//  the library, starting at a random position of a random trace. The
+//  traces are baseline subtracted, the offset (DefaultOffset and AC
+//  coupling) is added as for the gaussian noise.
+//
 //////////////////////////////////////////////////////////////////////////////
 #include "MSimCamera.h"
 
+#include <thread>
+#include <vector>
+
 #include <TF1.h>
 #include <TRandom.h>            // Needed for TRandom
 
@@ -52,9 +80,12 @@
 #include "MParSpline.h"
 
 #include "MParList.h"
+#include "MSimRandom.h"
+#include "MRandomPhilox.h"
 
 #include "MPhotonEvent.h"
 #include "MPhotonData.h"
+#include "MPhotonIndex.h"
 
 #include "MPedestalCam.h"
 #include "MPedestalPix.h"
@@ -76,10 +107,11 @@ using namespace std;
 //  Default Constructor.
 //
 MSimCamera::MSimCamera(const char* name, const char *title)
-    : fEvt(0), fStat(0), fRunHeader(0), fElectronicNoise(0), fGain(0),
+    : fRandom(0), fEvt(0), fStat(0), fIndex(0), fRunHeader(0), fElectronicNoise(0), fGain(0),
       fCamera(0), fMcEvt(0),fCrosstalkCoeffParam(0), fSpline(0), fBaselineGain(kFALSE),
       fDefaultOffset(-1), fDefaultNoise(-1), fDefaultGain(-1), fACFudgeFactor(0),
-      fACTimeConstant(0)
+      fACTimeConstant(0), fTimeBuckets(0), fPulseTableMin(0), fNumThreads(0),
+      fFreq(0), fShift(0), fBucketMin(0), fNumBuckets(0)
 
 {
     fName  = name  ? name  : "MSimCamera";
@@ -115,6 +147,10 @@ Int_t MSimCamera::PreProcess(MParList *pList)
         return kFALSE;
     }
 
+    fIndex = (MPhotonIndex*)pList->FindCreateObj("MPhotonIndex");
+    if (!fIndex)
+        return kFALSE;
+
     fRunHeader = (MRawRunHeader *)pList->FindObject("MRawRunHeader");
     if (!fRunHeader)
     {
@@ -251,9 +287,88 @@ Int_t MSimCamera::PreProcess(MParList *pList)
     if (fBaselineGain)
         *fLog << inf << "Gain is also applied to the electronic noise." << endl;
 
+    MMatrix *lib = (MMatrix*)pList->FindObject("PedestalLibrary", "MMatrix");
+    if (lib)
+        InitNoiseLibrary(*lib);
+
+    if (fNoiseFirst.GetSize()>1)
+        *fLog << inf << "Electronic noise is taken from " << fNoiseFirst.GetSize()-1 << " recorded pedestal traces." << endl;
+
+    if (fTimeBuckets>0)
+    {
+        InitPulseTable();
+        *fLog << inf << "Photons are accumulated in " << fTimeBuckets << " time buckets per sample." << endl;
+    }
+
+    fRandom = (MSimRandom*)pList->FindObject("MSimRandom");
+    if (fRandom && !fRandom->Setup(*pList))
+        return kFALSE;
+
     return kTRUE;
 }
 
+// --------------------------------------------------------------------------
+//
+// Tabulate the pulse shape in steps of 1/fTimeBuckets samples in the
+// same range [xmin, xmax[ in which MAnalogSignal::AddPulse evaluates
+// the spline.
+//
+void MSimCamera::InitPulseTable()
+{
+    const Int_t kmin = TMath::CeilNint(fSpline->GetXmin()*fTimeBuckets);
+    const Int_t kmax = TMath::CeilNint(fSpline->GetXmax()*fTimeBuckets)-1;
+
+    fPulseTableMin = kmin;
+    fPulseTable.Set(kmax>=kmin ? kmax-kmin+1 : 0);
+
+    for (Int_t k=kmin; k<=kmax; k++)
+        fPulseTable[k-kmin] = fSpline->Eval(Double_t(k)/fTimeBuckets);
+}
+
+// --------------------------------------------------------------------------
+//
+// Copy the recorded pedestal traces (one per row) from the library into
+// fNoiseTraces and subtract the baseline (mean) of each trace. Empty
+// rows are skipped. An empty library switches back to gaussian noise.
+//
+void MSimCamera::InitNoiseLibrary(const MMatrix &lib)
+{
+    UInt_t n = 0;
+    for (auto it=lib.fM.begin(); it!=lib.fM.end(); it++)
+        n += it->size();
+
+    fNoiseTraces.Set(n);
+    fNoiseFirst.Set(0);
+
+    if (n==0)
+        return;
+
+    MArrayI first(lib.fM.size()+1);
+
+    UInt_t num = 0;
+    UInt_t pos = 0;
+    for (auto it=lib.fM.begin(); it!=lib.fM.end(); it++)
+    {
+        const UInt_t len = it->size();
+        if (len==0)
+            continue;
+
+        Double_t mean = 0;
+        for (UInt_t i=0; i<len; i++)
+            mean += (*it)[i];
+        mean /= len;
+
+        for (UInt_t i=0; i<len; i++)
+            fNoiseTraces[pos+i] = (*it)[i]-mean;
+
+        first[num++] = pos;
+        pos += len;
+    }
+    first[num] = pos;
+
+    fNoiseFirst.Set(num+1, first.GetArray());
+}
+
 // --------------------------------------------------------------------------
 //
 // FIXME: For now this is a workaround to set a baseline and the
@@ -286,177 +401,123 @@ Bool_t MSimCamera::ReInit(MParList *plist)
 
 // --------------------------------------------------------------------------
 //
-// fStat->GetMaxIndex must return the maximum index possible
-// (equiv. number of pixels) not just the maximum index stored!
+// Simulate the analog signal of channel i: the electronic noise and the
+// pulses of all photons of pixel i. Also the truth information of the
+// pixel is filled. Only data of pixel i is written, so that different
+// channels can be simulated in parallel. Returns the weight of the
+// photons from the shower.
 //
-Int_t MSimCamera::Process()
+Double_t MSimCamera::SimulateChannel(UInt_t i, TRandom &rnd)
 {
-    // Calculate start time, end time and corresponding number of samples
-    const Double_t freq = fRunHeader->GetFreqSampling()/1000.;
+    MAnalogSignal &sig = (*fCamera)[i];
 
-    // FIXME: Should we use a higher sampling here?
-
-    const Double_t start = fStat->GetTimeFirst()*freq;
-    const Double_t end   = fStat->GetTimeLast() *freq;
-
-    const UInt_t   nlen  = TMath::CeilNint(end-start);
+    // Get the ResidualTimeSpread Parameter
+    const Double_t residualTimeSpread = fResidualTimeSpread->GetVal();
 
-    // Get number of pixels/channels
-    const UInt_t npix = fStat->GetMaxIndex()+1;
+    // Jens Buss on residual time spread:
+    // randomly draw an additional time offset to be added to the arrivaltime 
+    // from a gaussian normal distribution with a given standard deviation 
+    const Double_t timeoffset = rnd.Gaus(0.0, residualTimeSpread);
 
-    if (npix>(UInt_t)fElectronicNoise->GetSize())
-    {
-        *fLog << err << "ERROR - More indices (" << npix << ") ";
-        *fLog << "assigned than existing in camera (";
-        *fLog << fElectronicNoise->GetSize() << ")!" << endl;
-        return kERROR;
-    }
+    const MPedestalPix &pix = (*fElectronicNoise)[i];
 
-    const Double_t pl = fSpline->GetXmin()*freq;
-    const Double_t pr = fSpline->GetXmax()*freq;
+    const Double_t val = pix.GetPedestal();
+    const Double_t rms = pix.GetPedestalRms();
 
-    // Init the arrays and set the range which will contain valid data
-    fCamera->Init(npix, nlen);
-    fCamera->SetValidRange(TMath::FloorNint(pr), TMath::CeilNint(nlen+pl));
+    // FTemme: Implementation of AC-coupling:
+    // to calculate the value of the accoupling per slice I use the
+    // following equation:
+    // accouplingPerSlice = accidentalPhotonRate * (1 + crossTalkProb)
+    //       * areaOfOnePulse / samplingRate;
+    // Therefore I need the following variables
+    // Double_t accidentalPhotonRate; // [MHz]
+    // Float_t crossTalkProb;         // [1]
+    // Double_t areaOfOnePulse;       // [ADC-Counts * s]
+    // Double_t samplingRate;         // [slices * MHz]
 
-    Double_t timeoffset[npix];
+    // The accidental photon rate is stored in GHz, so we have to multiply
+    // with 1E3 to get MHz:
+    const MPedestalPix &accPhoPix = (*fAccidentalPhotons)[i];
 
+    const Double_t accidentalPhotonRate = accPhoPix.GetPedestal() * 1e3; //[MHz]
 
-    // Add electronic noise to empty channels
-    for (UInt_t i=0; i<npix; i++)
+    Double_t currentAccidentalPhotonRate = accidentalPhotonRate;
+    if (fACTimeConstant!=0)
     {
+        const Double_t accidentalPhotons      = fACTimeConstant * accidentalPhotonRate;
+        const Double_t sigmaAccidentalPhotons = TMath::Sqrt(accidentalPhotons);
 
-        // Get the ResidualTimeSpread Parameter
-        const Double_t residualTimeSpread = fResidualTimeSpread->GetVal();
-
-        // Jens Buss on residual time spread:
-        // randomly draw an additional time offset to be added to the arrivaltime 
-        // from a gaussian normal distribution with a given standard deviation 
-        timeoffset[i] = gRandom->Gaus(0.0, residualTimeSpread);
-        const MPedestalPix &pix = (*fElectronicNoise)[i];
-
-        const Double_t val = pix.GetPedestal();
-        const Double_t rms = pix.GetPedestalRms();
-
-        // FTemme: Implementation of AC-coupling:
-        // to calculate the value of the accoupling per slice I use the
-        // following equation:
-        // accouplingPerSlice = accidentalPhotonRate * (1 + crossTalkProb)
-        //       * areaOfOnePulse / samplingRate;
-        // Therefore I need the following variables
-        // Double_t accidentalPhotonRate; // [MHz]
-        // Float_t crossTalkProb;         // [1]
-        // Double_t areaOfOnePulse;       // [ADC-Counts * s]
-        // Double_t samplingRate;         // [slices * MHz]
-
-        // The accidental photon rate is stored in GHz, so we have to multiply
-        // with 1E3 to get MHz:
-        const MPedestalPix &accPhoPix = (*fAccidentalPhotons)[i];
-
-        const Double_t accidentalPhotonRate = accPhoPix.GetPedestal() * 1e3; //[MHz]
-
-        Double_t currentAccidentalPhotonRate = accidentalPhotonRate;
-        if (fACTimeConstant!=0)
-        {
-            const Double_t accidentalPhotons      = fACTimeConstant * accidentalPhotonRate;
-            const Double_t sigmaAccidentalPhotons = TMath::Sqrt(accidentalPhotons);
+        const Double_t gaus = rnd.Gaus(accidentalPhotons,sigmaAccidentalPhotons);
 
-            const Double_t gaus = gRandom->Gaus(accidentalPhotons,sigmaAccidentalPhotons);
+        currentAccidentalPhotonRate = gaus / fACTimeConstant;
+    }
 
-            currentAccidentalPhotonRate = gaus / fACTimeConstant;
-        }
+    // Get the CrosstalkCoefficient Parameter
+    const Double_t crossTalkProb = fCrosstalkCoeffParam->GetVal();
 
-        // Get the CrosstalkCoefficient Parameter
-        const Double_t crossTalkProb = fCrosstalkCoeffParam->GetVal();
+    // To get the area of one Pulse, I only need to calculate the Integral
+    // of the Pulse Shape, which is stored in fSpline. Because the spline is
+    // normalized to a maximal amplitude of 1.0, I had to multiply it with
+    // the Default gain [ADC-Counts * s]
+    const Double_t areaOfOnePulse = fSpline->Integral() * fDefaultGain;
 
-        // To get the area of one Pulse, I only need to calculate the Integral
-        // of the Pulse Shape, which is stored in fSpline. Because the spline is
-        // normalized to a maximal amplitude of 1.0, I had to multiply it with
-        // the Default gain [ADC-Counts * s]
-        const Double_t areaOfOnePulse = fSpline->Integral() * fDefaultGain;
+    // The sampling rate I get from the RunHeader:
+    const Double_t samplingRate = fRunHeader->GetFreqSampling(); // [slices * MHz]
 
-        // The sampling rate I get from the RunHeader:
-        const Double_t samplingRate = fRunHeader->GetFreqSampling(); // [slices * MHz]
+    const Double_t accouplingPerSlice = currentAccidentalPhotonRate
+        * (1 + crossTalkProb + fACFudgeFactor)
+        * areaOfOnePulse / samplingRate;
 
-        const Double_t accouplingPerSlice = currentAccidentalPhotonRate
-            * (1 + crossTalkProb + fACFudgeFactor)
-            * areaOfOnePulse / samplingRate;
+    // The accoupling is substracted from the timeline by decreasing the
+    // mean of the gaussian noise which is added
 
-        // The accoupling is substracted from the timeline by decreasing the
-        // mean of the gaussian noise which is added
+    // Sorry, the name "pedestal" is misleading here
+    // FIXME: Simulate gain fluctuations
+    const Double_t gain = (*fGain)[i].GetPedestal();
 
-        if (!fBaselineGain)
-        {
-            (*fCamera)[i].AddGaussianNoise(rms, val - accouplingPerSlice);
-            continue;
-        }
-        // Sorry, the name "pedestal" is misleading here
-        // FIXME: Simulate gain fluctuations
-        const Double_t gain = (*fGain)[i].GetPedestal();
-
-        // FIXME: We might add the base line here already.
-        // FIXME: How stable is the offset?
-        // FIXME: Should we write a container AppliedGain for MSImTrigger?
+    // FIXME: We might add the base line here already.
+    // FIXME: How stable is the offset?
+    // FIXME: Should we write a container AppliedGain for MSImTrigger?
+    const Double_t scale = fBaselineGain ? gain : 1;
 
-        (*fCamera)[i].AddGaussianNoise(rms*gain, (val - accouplingPerSlice)*gain);
-    }
+    if (fNoiseFirst.GetSize()>1)
+        sig.AddNoise(fNoiseTraces, fNoiseFirst, (val - accouplingPerSlice)*scale, scale, &rnd);
+    else
+        sig.AddGaussianNoise(rms*scale, (val - accouplingPerSlice)*scale, &rnd);
 
-    // FIXME: Simulate correlations with neighboring pixels
-
-    const Int_t num = fEvt->GetNumPhotons();
-
-    // A random shift, uniformely distributed within one slice, to make sure that
-    // the first photon is not always aligned identically with a sample edge.
-    // FIXME: Make it switchable
-    const Float_t rndm = gRandom->Uniform();
+    // Get the ResidualTimeSpread Parameter
+    const Double_t gapdTimeJitter = fGapdTimeJitter->GetVal();
 
-    // FIXME: Shell we add a random shift of [0,1] samples per channel?
-    //        Or maybe per channel and run?
+    // Time buckets of this pixel and the list of the filled ones
+    Float_t *buckets = fTimeBuckets>0 ? fBuckets.GetArray()+i*fNumBuckets : 0;
+    Int_t   *used    = fTimeBuckets>0 ? fBucketsUsed.GetArray()+fIndex->GetFirst(i) : 0;
+    Int_t    nused   = 0;
 
     Double_t tot = 0;
 
-    for (int i=0 ; i<1440 ; i++)
-    {
-        (*fTruePhotons->cherenkov_photons_weight)[i] = 0;
-        (*fTruePhotons->cherenkov_photons_number)[i] = 0;
-        (*fTruePhotons->cherenkov_arrival_time_mean)[i] = 0;
-        (*fTruePhotons->cherenkov_arrival_time_variance)[i] = 0;
-        (*fTruePhotons->muon_cherenkov_photons_weight)[i] = 0;
-        (*fTruePhotons->muon_cherenkov_photons_number)[i] = 0;
-        (*fTruePhotons->cherenkov_arrival_time_min)[i] = 10000;
-        (*fTruePhotons->cherenkov_arrival_time_max)[i] = 0;
-        (*fTruePhotons->noise_photons_weight)[i] = 0;
-    }
-
-    //--------------------------------------------------------------------------
-
-    // Get the ResidualTimeSpread Parameter
-    const Double_t gapdTimeJitter = fGapdTimeJitter->GetVal();
-    
     // Simulate pulses
-    for (Int_t i=0; i<num; i++)
+    for (Int_t k=fIndex->GetFirst(i); k<fIndex->GetLast(i); k++)
     {
-        const MPhotonData &ph = (*fEvt)[i];
+        const MPhotonData &ph = (*fEvt)[(*fIndex)[k]];
 
-        const UInt_t   idx = ph.GetTag();
-        Double_t t   = (ph.GetTime()-fStat->GetTimeFirst())*freq+rndm;// - fSpline->GetXmin();
+        Double_t t = (ph.GetTime()-fStat->GetTimeFirst())*fFreq+fShift;// - fSpline->GetXmin();
 
         // Sebastian Mueller and Dominik Neise on fix time offsets:
         // We add a fix temporal offset to the relative arrival time of the 
         // individual pixel. The offsets are stored in the
         // fFixTimeOffsetsBetweenPixelsInNs -> fM matrix. We identify the first
         // column to hold the offsets in ns.
-        t = t + freq*fFixTimeOffsetsBetweenPixelsInNs->fM[idx][0];
+        t = t + fFreq*fFixTimeOffsetsBetweenPixelsInNs->fM[i][0];
 
         // Jens Buss on residual time spread:
         // add random time offset to the arrivaltimes
-        t = t + timeoffset[idx];
+        t = t + timeoffset;
 
         // FIXME: Time jitter?
         // Jens Buss on GapdTimeJitter
         // add also a time offset to arrival times of single photons
         // TODO: change to ns, use: fRunHeader->GetFreqSampling()
-        Double_t timeJitter = gRandom->Gaus(0.0, gapdTimeJitter);
+        Double_t timeJitter = rnd.Gaus(0.0, gapdTimeJitter);
         t = t + timeJitter;
 
         // FIXME: Add additional routing here?
@@ -465,40 +526,205 @@ Int_t MSimCamera::Process()
         if (ph.GetPrimary()!=MMcEvt::kNightSky && ph.GetPrimary()!=MMcEvt::kArtificial)
         {
             tot += ph.GetWeight();
-            (*fTruePhotons->cherenkov_photons_weight)[idx] += ph.GetWeight();
-            (*fTruePhotons->cherenkov_photons_number)[idx] += 1;
 
-            (*fTruePhotons->cherenkov_arrival_time_mean)[idx] += t;
-            (*fTruePhotons->cherenkov_arrival_time_variance)[idx] += t*t;
+            (*fTruePhotons->cherenkov_photons_weight)[i] += ph.GetWeight();
+            (*fTruePhotons->cherenkov_photons_number)[i] += 1;
+
+            (*fTruePhotons->cherenkov_arrival_time_mean)[i] += t;
+            (*fTruePhotons->cherenkov_arrival_time_variance)[i] += t*t;
 
             if (ph.GetPrimary()==MMcEvt::kMUON)
             {
-                (*fTruePhotons->muon_cherenkov_photons_weight)[idx] += ph.GetWeight();
-                (*fTruePhotons->muon_cherenkov_photons_number)[idx] += 1;
+                (*fTruePhotons->muon_cherenkov_photons_weight)[i] += ph.GetWeight();
+                (*fTruePhotons->muon_cherenkov_photons_number)[i] += 1;
             }
 
             // find min
-            if (t < (*fTruePhotons->cherenkov_arrival_time_min)[idx] )
+            if (t < (*fTruePhotons->cherenkov_arrival_time_min)[i] )
             {
-                (*fTruePhotons->cherenkov_arrival_time_min)[idx] = t;
+                (*fTruePhotons->cherenkov_arrival_time_min)[i] = t;
             }
             // find max
-            if (t > (*fTruePhotons->cherenkov_arrival_time_max)[idx] )
+            if (t > (*fTruePhotons->cherenkov_arrival_time_max)[i] )
             {
-               (*fTruePhotons->cherenkov_arrival_time_max)[idx] = t;
+               (*fTruePhotons->cherenkov_arrival_time_max)[i] = t;
             }
         }
         else
         {
-            (*fTruePhotons->noise_photons_weight)[idx] += ph.GetWeight();
+            (*fTruePhotons->noise_photons_weight)[i] += ph.GetWeight();
         }
 
-        // Sorry, the name "pedestal" is misleading here
-        // FIXME: Simulate gain fluctuations
-        const Double_t gain = (*fGain)[idx].GetPedestal();
-
         // === FIXME === FIXME === FIXME === Frequency!!!!
-        (*fCamera)[idx].AddPulse(*fSpline, t, ph.GetWeight()*gain);
+        if (fTimeBuckets==0)
+        {
+            sig.AddPulse(*fSpline, t, ph.GetWeight()*gain);
+            continue;
+        }
+
+        // Photons outside of the range don't contribute
+        const Int_t c = TMath::Nint(t*fTimeBuckets)-fBucketMin;
+        if (c<0 || c>=fNumBuckets)
+            continue;
+
+        // Remember the bucket when it is filled the first time. If it is
+        // listed twice the second time it is empty already.
+        if (buckets[c]==0)
+            used[nused++] = c;
+
+        buckets[c] += ph.GetWeight()*gain;
+    }
+
+    // Add the pulses of all filled buckets and reset the buckets
+    for (Int_t k=0; k<nused; k++)
+    {
+        const Int_t c = used[k];
+
+        const Float_t amp = buckets[c];
+        if (amp==0)
+            continue;
+
+        buckets[c] = 0;
+
+        sig.AddPulse(fPulseTable, fPulseTableMin, fTimeBuckets, c+fBucketMin, amp);
+    }
+
+    return tot;
+}
+
+// --------------------------------------------------------------------------
+//
+// Simulate the channels ithread, ithread+nthreads, ... of the npix channels.
+// Channel i uses the sub-stream i+1 of the random number service, so that
+// the result does not depend on the number of threads. The weight of the
+// photons from the shower is added to tot[ithread].
+//
+void MSimCamera::SimulateChannels(UInt_t ithread, UInt_t nthreads, UInt_t npix, Double_t *tot)
+{
+    MRandomPhilox rnd;
+
+    for (UInt_t i=ithread; i<npix; i+=nthreads)
+    {
+        fRandom->InitStream(rnd, *this, i+1);
+        tot[ithread] += SimulateChannel(i, rnd);
+    }
+}
+
+// --------------------------------------------------------------------------
+//
+// fStat->GetMaxIndex must return the maximum index possible
+// (equiv. number of pixels) not just the maximum index stored!
+//
+Int_t MSimCamera::Process()
+{
+    // Calculate start time, end time and corresponding number of samples
+    const Double_t freq = fRunHeader->GetFreqSampling()/1000.;
+
+    // FIXME: Should we use a higher sampling here?
+
+    const Double_t start = fStat->GetTimeFirst()*freq;
+    const Double_t end   = fStat->GetTimeLast() *freq;
+
+    const UInt_t   nlen  = TMath::CeilNint(end-start);
+
+    // Get number of pixels/channels
+    const UInt_t npix = fStat->GetMaxIndex()+1;
+
+    if (npix>(UInt_t)fElectronicNoise->GetSize())
+    {
+        *fLog << err << "ERROR - More indices (" << npix << ") ";
+        *fLog << "assigned than existing in camera (";
+        *fLog << fElectronicNoise->GetSize() << ")!" << endl;
+        return kERROR;
+    }
+
+    const Double_t pl = fSpline->GetXmin()*freq;
+    const Double_t pr = fSpline->GetXmax()*freq;
+
+    // Init the arrays and set the range which will contain valid data
+    fCamera->Init(npix, nlen);
+    fCamera->SetValidRange(TMath::FloorNint(pr), TMath::CeilNint(nlen+pl));
+
+    // Random number stream of this task
+    TRandom &rnd = MSimRandom::GetStream(fRandom, *this);
+
+    // A random shift, uniformely distributed within one slice, to make sure that
+    // the first photon is not always aligned identically with a sample edge.
+    // FIXME: Make it switchable
+    fShift = rnd.Uniform();
+
+    // FIXME: Shell we add a random shift of [0,1] samples per channel?
+    //        Or maybe per channel and run?
+
+    fFreq = freq;
+
+    // Range of the time buckets (in units of 1/fTimeBuckets samples) which
+    // can contribute to the samples [0, nlen[
+    fBucketMin  = TMath::FloorNint(-fSpline->GetXmax()*fTimeBuckets)-1;
+    fNumBuckets = TMath::CeilNint((nlen-fSpline->GetXmin())*fTimeBuckets)+2-fBucketMin;
+
+    for (int i=0 ; i<1440 ; i++)
+    {
+        (*fTruePhotons->cherenkov_photons_weight)[i] = 0;
+        (*fTruePhotons->cherenkov_photons_number)[i] = 0;
+        (*fTruePhotons->cherenkov_arrival_time_mean)[i] = 0;
+        (*fTruePhotons->cherenkov_arrival_time_variance)[i] = 0;
+        (*fTruePhotons->muon_cherenkov_photons_weight)[i] = 0;
+        (*fTruePhotons->muon_cherenkov_photons_number)[i] = 0;
+        (*fTruePhotons->cherenkov_arrival_time_min)[i] = 10000;
+        (*fTruePhotons->cherenkov_arrival_time_max)[i] = 0;
+        (*fTruePhotons->noise_photons_weight)[i] = 0;
+    }
+
+    // Index of the photons sorted by pixel
+    if (!fIndex->IsValid(*fEvt, npix))
+        fIndex->Build(*fEvt, npix);
+
+    // The buckets are reset after use, so growing them is sufficient
+    if (fTimeBuckets>0)
+    {
+        if (fBuckets.GetSize()<npix*fNumBuckets)
+            fBuckets.Set(npix*fNumBuckets);
+        if (fBucketsUsed.GetSize()<(UInt_t)fIndex->GetNumPhotons())
+            fBucketsUsed.Set(fIndex->GetNumPhotons());
+    }
+
+    // FIXME: Simulate correlations with neighboring pixels
+
+    Double_t tot = 0;
+
+    if (!fRandom)
+    {
+        // gRandom can only be used from a single thread
+        for (UInt_t i=0; i<npix; i++)
+            tot += SimulateChannel(i, rnd);
+    }
+    else
+    {
+        Int_t nthreads = fNumThreads>0 ? fNumThreads : thread::hardware_concurrency();
+        if (nthreads>(Int_t)npix)
+            nthreads = npix;
+        if (nthreads<1)
+            nthreads = 1;
+
+        // Weight of the photons from the shower per thread
+        vector<Double_t> sum(nthreads, 0);
+
+        if (nthreads==1)
+            SimulateChannels(0, 1, npix, sum.data());
+        else
+        {
+            vector<thread> threads;
+            for (Int_t i=0; i<nthreads; i++)
+                threads.push_back(thread(&MSimCamera::SimulateChannels, this,
+                                         i, nthreads, npix, sum.data()));
+
+            for (auto it=threads.begin(); it!=threads.end(); it++)
+                it->join();
+        }
+
+        for (auto it=sum.begin(); it!=sum.end(); it++)
+            tot += *it;
     }
 
     for (unsigned int i=0 ; i < 1440 ; i++)
@@ -518,6 +744,8 @@ Int_t MSimCamera::Process()
 // --------------------------------------------------------------------------
 //
 // BaselineGain: Off
+// TimeBuckets:  0
+// NumThreads:   0
 //
 Int_t MSimCamera::ReadEnv(const TEnv &env, TString prefix, Bool_t print)
 {
@@ -553,6 +781,16 @@ Int_t MSimCamera::ReadEnv(const TEnv &env, TString prefix, Bool_t print)
         rc = kTRUE;
         fACTimeConstant = GetEnvValue(env, prefix, "ACTimeConstant", fACTimeConstant);
     }
+    if (IsEnvDefined(env, prefix, "TimeBuckets", print))
+    {
+        rc = kTRUE;
+        fTimeBuckets = GetEnvValue(env, prefix, "TimeBuckets", (Int_t)fTimeBuckets);
+    }
+    if (IsEnvDefined(env, prefix, "NumThreads", print))
+    {
+        rc = kTRUE;
+        fNumThreads = GetEnvValue(env, prefix, "NumThreads", fNumThreads);
+    }
 
     return rc;
 }
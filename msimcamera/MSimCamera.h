@@ -6,26 +6,33 @@
 #endif
 
 #include "MArrayF.h"
+#include "MArrayI.h"
 #include "MMatrix.h"
 
 class MMcEvt;
 class MParList;
 class MPhotonEvent;
 class MPhotonStatistics;
+class MPhotonIndex;
 class MRawRunHeader;
 class MAnalogChannels;
 class MPedestalCam;
 class MArrayF;
 class MTruePhotonsPerPixelCont;
 
+class TRandom;
+
 class MSpline3;
 class MParameterD;
+class MSimRandom;
 
 class MSimCamera : public MTask
 {
 private:
+    MSimRandom        *fRandom;          //! Random number service (optional)
     MPhotonEvent      *fEvt;             //! Event stroing the photons
     MPhotonStatistics *fStat;            //! Valid time range of the phootn event
+    MPhotonIndex      *fIndex;           //! Photons sorted by pixel
     MRawRunHeader     *fRunHeader;       //! Sampling frequency
     MPedestalCam      *fElectronicNoise; //! Electronic noise (baseline and rms)
     MPedestalCam      *fGain;            //! Electronic noise (baseline and rms)
@@ -54,6 +61,29 @@ private:
 
     Double_t fACTimeConstant;
 
+    UInt_t   fTimeBuckets;   // Number of time buckets per sample (0: add the pulse of each photon individually)
+
+    MArrayF  fPulseTable;    //! Pulse shape tabulated in steps of 1/fTimeBuckets samples
+    Int_t    fPulseTableMin; //! Index of the first entry of fPulseTable (in units of 1/fTimeBuckets)
+    MArrayF  fBuckets;       //! Summed amplitudes per pixel and time bucket
+    MArrayI  fBucketsUsed;   //! Indices of the filled buckets (per pixel starting at MPhotonIndex::GetFirst)
+
+    Int_t    fNumThreads;    // Number of threads (<=0: number of cores)
+
+    Double_t fFreq;          //! Sampling frequency of the current event [GHz]
+    Float_t  fShift;         //! Random shift of all photons of the current event [samples]
+    Int_t    fBucketMin;     //! First time bucket of the current event
+    Int_t    fNumBuckets;    //! Number of time buckets per pixel of the current event
+
+    MArrayF  fNoiseTraces;   //! Recorded pedestal traces (baseline subtracted) one after the other
+    MArrayI  fNoiseFirst;    //! First sample of each trace in fNoiseTraces (number of traces+1 entries)
+
+    // MSimCamera
+    void     InitPulseTable();
+    void     InitNoiseLibrary(const MMatrix &lib);
+    Double_t SimulateChannel(UInt_t i, TRandom &rnd);
+    void     SimulateChannels(UInt_t ithread, UInt_t nthreads, UInt_t npix, Double_t *tot);
+
     // MParContainer
     Int_t ReadEnv(const TEnv &env, TString prefix, Bool_t print);
 
@@ -65,6 +95,9 @@ private:
 public:
     MSimCamera(const char *name=NULL, const char *title=NULL);
 
+    void SetTimeBuckets(UInt_t n=0) { fTimeBuckets = n; }
+    void SetNumThreads(Int_t n=0)   { fNumThreads = n; }
+
     ClassDef(MSimCamera, 0) // Task to simulate the electronic noise and to convert photons into pulses
 };
 
@@ -45,6 +45,7 @@
 #include "MLogManip.h"
 
 #include "MParList.h"
+#include "MSimRandom.h"
 
 #include "MPhotonEvent.h"
 #include "MPhotonData.h"
@@ -58,7 +59,7 @@ using namespace std;
 //  Default Constructor.
 //
 MSimExcessNoise::MSimExcessNoise(const char* name, const char *title)
-: fEvt(0), fExcessNoise(0.2)
+: fRandom(0), fEvt(0), fExcessNoise(0.2)
 {
     fName  = name  ? name  : "MSimExcessNoise";
     fTitle = title ? title : "Task to simulate the excess dependant noise (conversion photon to signal height)";
@@ -79,6 +80,10 @@ Int_t MSimExcessNoise::PreProcess(MParList *pList)
 
     *fLog << inf << "Excess Noise Factor in use " << fExcessNoise << "%" << endl;
 
+    fRandom = (MSimRandom*)pList->FindObject("MSimRandom");
+    if (fRandom && !fRandom->Setup(*pList))
+        return kFALSE;
+
     return kTRUE;
 }
 
@@ -88,6 +93,8 @@ Int_t MSimExcessNoise::PreProcess(MParList *pList)
 //
 Int_t MSimExcessNoise::Process()
 {
+    TRandom &rnd = MSimRandom::GetStream(fRandom, *this);
+
     const UInt_t num = fEvt->GetNumPhotons();
     for (UInt_t i=0; i<num; i++)
     {
@@ -97,7 +104,7 @@ Int_t MSimExcessNoise::Process()
         if (oldw<0)
             continue;
 
-        const Float_t neww = gRandom->Gaus(oldw, fExcessNoise*TMath::Sqrt(oldw));
+        const Float_t neww = rnd.Gaus(oldw, fExcessNoise*TMath::Sqrt(oldw));
         ph.SetWeight(neww);
     }
 
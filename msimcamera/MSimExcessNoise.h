@@ -7,10 +7,12 @@
 
 class MParList;
 class MPhotonEvent;
+class MSimRandom;
 
 class MSimExcessNoise : public MTask
 {
 private:
+    MSimRandom   *fRandom;  //! Random number service (optional)
     MPhotonEvent *fEvt;     //! Event storing the photons
 
     Double_t fExcessNoise;
@@ -44,6 +44,7 @@
 #include "MLogManip.h"
 
 #include "MParList.h"
+#include "MSimRandom.h"
 
 #include "MPhotonEvent.h"
 #include "MPhotonData.h"
@@ -57,7 +58,7 @@ using namespace std;
 //  Default Constructor.
 //
 MSimPSF::MSimPSF(const char* name, const char *title)
-    : fEvt(0), fSigma(-1)
+    : fRandom(0), fEvt(0), fSigma(-1)
 {
     fName  = name  ? name  : "MSimPSF";
     fTitle = title ? title : "Task to do a naiv simulation of the psf by smearout in the camera plane";
@@ -79,6 +80,10 @@ Int_t MSimPSF::PreProcess(MParList *pList)
         return kFALSE;
     }
 
+    fRandom = (MSimRandom*)pList->FindObject("MSimRandom");
+    if (fRandom && !fRandom->Setup(*pList))
+        return kFALSE;
+
     return kTRUE;
 }
 
@@ -90,6 +95,9 @@ Int_t MSimPSF::Process()
 {
     const UInt_t num = fEvt->GetNumPhotons();
 
+    // Random number stream of this task
+    TRandom &rnd = MSimRandom::GetStream(fRandom, *this);
+
     // Loop over all mirrors
     for (UInt_t i=0; i<num; i++)
     {
@@ -97,7 +105,7 @@ Int_t MSimPSF::Process()
         MPhotonData &ph = (*fEvt)[i];
 
         // Get random gaussian shift
-        const TVector2 v(gRandom->Gaus(0, fSigma), gRandom->Gaus(0, fSigma));
+        const TVector2 v(rnd.Gaus(0, fSigma), rnd.Gaus(0, fSigma));
 
         // Add random smear out
         ph.SetPosition(ph.GetPos2()+v);
@@ -7,10 +7,12 @@
 
 class MParList;
 class MPhotonEvent;
+class MSimRandom;
 
 class MSimPSF : public MTask
 {
 private:
+    MSimRandom   *fRandom; //! Random number service (optional)
     MPhotonEvent *fEvt;   //! Event stroing the photons
 
     Double_t      fSigma; //  Gaussian sigma of the smearout
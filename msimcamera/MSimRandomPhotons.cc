@@ -116,6 +116,7 @@
 #include "MLogManip.h"
 
 #include "MParList.h"
+#include "MSimRandom.h"
 
 #include "MGeomCam.h"
 #include "MGeom.h"
@@ -141,7 +142,7 @@ using namespace std;
 //  Default Constructor.
 //
 MSimRandomPhotons::MSimRandomPhotons(const char* name, const char *title)
-    : fGeom(0), fEvt(0), fStat(0), /*fEvtHeader(0),*/ fRunHeader(0),
+    : fRandom(0), fGeom(0), fEvt(0), fStat(0), /*fEvtHeader(0),*/ fRunHeader(0),
     fRates(0), fSimulateWavelength(kFALSE), fNameGeomCam("MGeomCam"),
     fFileNameNSB("resmc/night-sky-la-palma.txt")
 {
@@ -422,6 +423,10 @@ Int_t MSimRandomPhotons::PreProcess(MParList *pList)
         return kFALSE;
     }
 
+    fRandom = (MSimRandom*)pList->FindObject("MSimRandom");
+    if (fRandom && !fRandom->Setup(*pList))
+        return kFALSE;
+
     return kTRUE;
 }
 
@@ -454,6 +459,9 @@ Int_t MSimRandomPhotons::Process()
     const Double_t start = fStat->GetTimeFirst();
     const Double_t end   = fStat->GetTimeLast();
 
+    // Random number stream of this task
+    TRandom &rnd = MSimRandom::GetStream(fRandom, *this);
+
     // Loop over all pixels
     for (UInt_t idx=0; idx<npix; idx++)
     {
@@ -471,7 +479,7 @@ Int_t MSimRandomPhotons::Process()
         {
             // Get a random time for the photon.
             // The differences are exponentially distributed.
-            t += MMath::RndmExp(avglen);
+            t += MMath::RndmExp(avglen, &rnd);
 
             // Check if we reached the end of the useful time window
             if (t>end)
@@ -494,7 +502,7 @@ Int_t MSimRandomPhotons::Process()
                 const Float_t wmin = fRunHeader->GetWavelengthMin();
                 const Float_t wmax = fRunHeader->GetWavelengthMax();
 
-                ph.SetWavelength(TMath::Nint(gRandom->Uniform(wmin, wmax)));
+                ph.SetWavelength(TMath::Nint(rnd.Uniform(wmin, wmax)));
             }
         }
     }
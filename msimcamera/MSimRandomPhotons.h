@@ -12,10 +12,12 @@ class MPhotonEvent;
 class MPhotonStatistics;
 class MCorsikaRunHeader;
 class MPedestalCam;
+class MSimRandom;
 
 class MSimRandomPhotons : public MTask
 {
 private:
+    MSimRandom        *fRandom;  //! Random number service (optional)
     MGeomCam          *fGeom;    //! container with the geometry
     MPhotonEvent      *fEvt;     //! Event storing the photons
     MPhotonStatistics *fStat;    //! Container storing evenet statistics
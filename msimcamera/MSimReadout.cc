@@ -36,6 +36,9 @@
 // jitter or is a real part of the electronics. Such effects should
 // be simulated somewhere else.
 //
+// The channels are digitized independently and distributed over
+// fNumThreads threads (<=0 means the number of cores).
+//
 //
 //  Input Containers:
 //   MGeomCam
@@ -51,6 +54,9 @@
 //////////////////////////////////////////////////////////////////////////////
 #include "MSimReadout.h"
 
+#include <thread>
+#include <vector>
+
 #include "MLog.h"
 #include "MLogManip.h"
 
@@ -79,7 +85,7 @@ using namespace std;
 //
 MSimReadout::MSimReadout(const char* name, const char *title)
     : fRunHeader(0), fEvtHeader(0), fCamera(0), fPulsePos(0), fTrigger(0), fData(0),
-    fConversionFactor(1)
+    fConversionFactor(1), fNumThreads(0)
 {
     fName  = name  ? name  : "MSimReadout";
     fTitle = title ? title : "Task to simulate the analog readout (FADCs)";
@@ -152,81 +158,14 @@ Bool_t MSimReadout::ReInit(MParList *plist)
 
 // ------------------------------------------------------------------------
 //
-// Convert (digitize) the analog channels into digital (FADC) data.
+// Digitize the nslices samples starting at trig of the channels
+// [first, last[ into the buffer.
 //
-Int_t MSimReadout::Process()
+void MSimReadout::Digitize(UInt_t first, UInt_t last, Int_t trig, Int_t nslices, MArrayI *buffer) const
 {
-    // Sanity checks
-    if (fData->GetNumLoGainSamples()>0)
-    {
-        *fLog << err << "ERROR - MSimReadout: Lo-gains not implemented yet." << endl;
-        return kERROR;
-    }
-
-    // Make sure that we have not more analog channels than pixels
-    // FIXME: Is this really necessary?
-    if (fCamera->GetNumChannels()>fData->GetNumPixels())
-    {
-        *fLog << err;
-        *fLog << "ERROR - Number of analog channels " << fCamera->GetNumChannels();
-        *fLog << " exceeds number of pixels " << fData->GetNumPixels() << endl;
-        return kERROR;
-    }
-
-    if (fTrigger->GetVal()<0)
-    {
-        *fLog << err << "ERROR - MSimReadout: MSimReadout executed for an event which has no trigger." << endl;
-        return kERROR;
-    }
-
-    // Get the intended pulse position and convert it to slices
-    const Float_t pulpos = fPulsePos->GetVal()*fRunHeader->GetFreqSampling()/1000.;
-
-    // Get trigger position and correct for intended pulse position
-    const Int_t trig = TMath::CeilNint(fTrigger->GetVal()-pulpos);
-
-    // Check if the position is valid
-    if (trig<0)
-    {
-        *fLog << err;
-        *fLog << "ERROR - Trigger position before analog signal." << endl;
-        *fLog << "        Trigger:  " << fTrigger->GetVal() << endl;
-        *fLog << "        PulsePos: " << pulpos << endl;
-        return kERROR;
-    }
-
-    // Get Number of samples in analog channels
-    const Int_t nsamp = fCamera->GetNumSamples();
-
-    // Get number of samples to be digitized
-    const Int_t nslices = fData->GetNumSamples();
-
-    // Check if the whole requested signal can be digitized
-    if (trig+nslices>nsamp)
-    {
-        *fLog << err << "ERROR - Trigger position beyond valid analog signal range." << endl;
-        *fLog << "        Trigger:    " << fTrigger->GetVal() << endl;
-        *fLog << "        PulsePos:   " << pulpos << endl;
-        *fLog << "        SamplesIn:  " << nsamp << endl;
-        *fLog << "        SamplesOut: " << nslices << endl;
-        return kERROR;
-    }
-
     const Float_t offset    = 0;//128;
-    // FTemme: Don't need this anymore:
-//    const UInt_t  max       = fData->GetMax();
-//    const UInt_t  min       = fData->GetMin();
-
 
-    // FIXME: Take this into account
-//    const UInt_t scale      = 16;
-//    const UInt_t resolution = 12;
-
-    // Digitize into a buffer
-    MArrayI buffer(nslices*fData->GetNumPixels());
-
-    // Loop over all channels/pixels
-    for (UInt_t i=0; i<fCamera->GetNumChannels(); i++)
+    for (UInt_t i=first; i<last; i++)
     {
         // Get i-th canalog hannel
         const MAnalogSignal &sig = (*fCamera)[i];
@@ -307,13 +246,112 @@ Int_t MSimReadout::Process()
             // but I don't see why this should be possible.
             Int_t digitized_value = TMath::Nint(slice);
             if (digitized_value > 2047) // positive overflow
-                buffer[nslices*i + j] = 0x0800; // <-- +2048
+                (*buffer)[nslices*i + j] = 0x0800; // <-- +2048
             else if (digitized_value < -2048)
-                buffer[nslices*i + j] = 0xF7FF; // <-- -2049
+                (*buffer)[nslices*i + j] = 0xF7FF; // <-- -2049
             else
-                buffer[nslices*i + j] = digitized_value;
+                (*buffer)[nslices*i + j] = digitized_value;
         }
     }
+}
+
+// ------------------------------------------------------------------------
+//
+// Convert (digitize) the analog channels into digital (FADC) data.
+//
+Int_t MSimReadout::Process()
+{
+    // Sanity checks
+    if (fData->GetNumLoGainSamples()>0)
+    {
+        *fLog << err << "ERROR - MSimReadout: Lo-gains not implemented yet." << endl;
+        return kERROR;
+    }
+
+    // Make sure that we have not more analog channels than pixels
+    // FIXME: Is this really necessary?
+    if (fCamera->GetNumChannels()>fData->GetNumPixels())
+    {
+        *fLog << err;
+        *fLog << "ERROR - Number of analog channels " << fCamera->GetNumChannels();
+        *fLog << " exceeds number of pixels " << fData->GetNumPixels() << endl;
+        return kERROR;
+    }
+
+    if (fTrigger->GetVal()<0)
+    {
+        *fLog << err << "ERROR - MSimReadout: MSimReadout executed for an event which has no trigger." << endl;
+        return kERROR;
+    }
+
+    // Get the intended pulse position and convert it to slices
+    const Float_t pulpos = fPulsePos->GetVal()*fRunHeader->GetFreqSampling()/1000.;
+
+    // Get trigger position and correct for intended pulse position
+    const Int_t trig = TMath::CeilNint(fTrigger->GetVal()-pulpos);
+
+    // Check if the position is valid
+    if (trig<0)
+    {
+        *fLog << err;
+        *fLog << "ERROR - Trigger position before analog signal." << endl;
+        *fLog << "        Trigger:  " << fTrigger->GetVal() << endl;
+        *fLog << "        PulsePos: " << pulpos << endl;
+        return kERROR;
+    }
+
+    // Get Number of samples in analog channels
+    const Int_t nsamp = fCamera->GetNumSamples();
+
+    // Get number of samples to be digitized
+    const Int_t nslices = fData->GetNumSamples();
+
+    // Check if the whole requested signal can be digitized
+    if (trig+nslices>nsamp)
+    {
+        *fLog << err << "ERROR - Trigger position beyond valid analog signal range." << endl;
+        *fLog << "        Trigger:    " << fTrigger->GetVal() << endl;
+        *fLog << "        PulsePos:   " << pulpos << endl;
+        *fLog << "        SamplesIn:  " << nsamp << endl;
+        *fLog << "        SamplesOut: " << nslices << endl;
+        return kERROR;
+    }
+
+    // FTemme: Don't need this anymore:
+//    const UInt_t  max       = fData->GetMax();
+//    const UInt_t  min       = fData->GetMin();
+
+
+    // FIXME: Take this into account
+//    const UInt_t scale      = 16;
+//    const UInt_t resolution = 12;
+
+    // Digitize into a buffer
+    MArrayI buffer(nslices*fData->GetNumPixels());
+
+    // Loop over all channels/pixels. The channels are independent and
+    // distributed in contiguous blocks over the threads.
+    const UInt_t nch = fCamera->GetNumChannels();
+
+    Int_t nthreads = fNumThreads>0 ? fNumThreads : thread::hardware_concurrency();
+    if (nthreads>(Int_t)nch)
+        nthreads = nch;
+
+    if (nthreads<=1)
+        Digitize(0, nch, trig, nslices, &buffer);
+    else
+    {
+        const UInt_t step = (nch+nthreads-1)/nthreads;
+
+        vector<thread> threads;
+        for (UInt_t first=0; first<nch; first+=step)
+            threads.push_back(thread(&MSimReadout::Digitize, this,
+                                     first, TMath::Min(first+step, nch),
+                                     trig, nslices, &buffer));
+
+        for (auto it=threads.begin(); it!=threads.end(); it++)
+            it->join();
+    }
 
     // Set samples as raw-data
     fData->Set(buffer);
@@ -334,6 +372,7 @@ Int_t MSimReadout::Process()
 // Read the parameters from the resource file.
 //
 //  ConversionFactor: 1
+//  NumThreads:       0
 //
 Int_t MSimReadout::ReadEnv(const TEnv &env, TString prefix, Bool_t print)
 {
@@ -343,6 +382,11 @@ Int_t MSimReadout::ReadEnv(const TEnv &env, TString prefix, Bool_t print)
         rc = kTRUE;
         fConversionFactor = GetEnvValue(env, prefix, "ConversionFactor", fConversionFactor);
     }
+    if (IsEnvDefined(env, prefix, "NumThreads", print))
+    {
+        rc = kTRUE;
+        fNumThreads = GetEnvValue(env, prefix, "NumThreads", fNumThreads);
+    }
 
     return rc;
 }
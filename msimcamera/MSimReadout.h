@@ -11,6 +11,7 @@ class MRawEvtData;
 class MRawRunHeader;
 class MRawEvtHeader;
 class MAnalogChannels;
+class MArrayI;
 
 class MSimReadout : public MTask
 {
@@ -25,6 +26,10 @@ private:
 
     Double_t fConversionFactor;    // Conversion factor (arbitrary) from analog signal to FADC counts
 
+    Int_t    fNumThreads;          // Number of threads (<=0: number of cores)
+
+    void Digitize(UInt_t first, UInt_t last, Int_t trig, Int_t nslices, MArrayI *buffer) const;
+
     // MTask
     Int_t  PreProcess(MParList *pList);
     Int_t  Process();
@@ -36,6 +41,8 @@ private:
 public:
     MSimReadout(const char *name=NULL, const char *title=NULL);
 
+    void SetNumThreads(Int_t n=0) { fNumThreads = n; }
+
     ClassDef(MSimReadout, 0) // Task to simulate the analog readout (FADCs)
 };
 
@@ -140,18 +140,19 @@ TVector2 MMirror::operator-(const MMirror &m) const
 // Simulate the PSF. Therefor we smear out the given normal vector
 // with a gaussian.
 //
-// Returns a vector which can be added to the normal vector.
+// Returns a vector which can be added to the normal vector. If no
+// generator rnd is given gRandom is used.
 //
 // FIXME: What is the correct focal distance to be given here?
 //        Can the smearing be imporved?
 //
-TVector3 MMirror::SimPSF(const TVector3 &n, Double_t F, Double_t psf) const
+TVector3 MMirror::SimPSF(const TVector3 &n, Double_t F, Double_t psf, TRandom *rnd) const
 {
     //const TVector3 n( x, y, -d)         // Normal vector of the mirror
     const TVector3 xy(-n.Y(), n.X(), 0);  // Normal vector in x/y plane
 
     Double_t gx, gy;
-    gRandom->Rannor(gx, gy);         // 2D random Gauss distribution
+    (rnd ? rnd : gRandom)->Rannor(gx, gy); // 2D random Gauss distribution
 
     psf /= 2;                        // The factor two because of the doubleing of the angle in the reflection
     psf /= F;                        // Scale the Gauss to the size of the PSF
@@ -5,6 +5,8 @@
 #include <TRotation.h>
 #endif
 
+class TRandom;
+
 class MQuaternion;
 
 class MMirror : public TObject
@@ -74,16 +76,16 @@ public:
     virtual Double_t GetMaxR() const=0;// { return TMath::Max(fMaxRX, fMaxRY); }
     virtual Double_t GetA() const=0;// { return TMath::Max(fMaxRX, fMaxRY); }
 
-    TVector3 SimPSF(const TVector3 &n, Double_t F, Double_t psf) const;
-    TVector3 SimPSF(const TVector3 &n) const
+    TVector3 SimPSF(const TVector3 &n, Double_t F, Double_t psf, TRandom *rnd=0) const;
+    TVector3 SimPSF(const TVector3 &n, TRandom *rnd=0) const
     {
-        return SimPSF(n, fFocalLength, fSigmaPSF/10); // Convert from mm to cm
+        return SimPSF(n, fFocalLength, fSigmaPSF/10, rnd); // Convert from mm to cm
     }
 
-    Bool_t ExecuteMirror(MQuaternion &p, MQuaternion &u) const;
+    Bool_t ExecuteMirror(MQuaternion &p, MQuaternion &u, TRandom *rnd=0) const;
 
     // ----- Basic function for parabolic mirror -----
-    Bool_t ExecuteReflection(MQuaternion &p, MQuaternion &u) const;
+    Bool_t ExecuteReflection(MQuaternion &p, MQuaternion &u, TRandom *rnd=0) const;
 
     // ----- Mirror specialized functions -----
 
@@ -9,6 +9,8 @@
 #include <TObjArray.h>
 #endif
 
+class TRandom;
+
 class MQuaternion;
 class MMirror;
 
@@ -49,7 +51,7 @@ public:
 
     virtual Bool_t CanHit(const MQuaternion &p) const;
 
-    Int_t ExecuteReflector(MQuaternion &p, MQuaternion &u) const;
+    Int_t ExecuteReflector(MQuaternion &p, MQuaternion &u, TRandom *rnd=0) const;
 
     void SetSigmaPSF(Double_t psf);
 
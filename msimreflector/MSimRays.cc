@@ -50,6 +50,7 @@
 #include "MLogManip.h"
 
 #include "MParList.h"
+#include "MSimRandom.h"
 
 #include "MQuaternion.h"
 
@@ -68,7 +69,7 @@ using namespace std;
 //  Default Constructor.
 //
 MSimRays::MSimRays(const char* name, const char *title)
-    : fEvt(0), fReflector(0), fPointPos(0), fSource(0),
+    : fRandom(0), fEvt(0), fReflector(0), fPointPos(0), fSource(0),
     fNumPhotons(1000), fHeight(-1),
     fNameReflector("MReflector"), fNamePointPos("MPointingPos"),
     fNameSource("Source")
@@ -111,6 +112,10 @@ Int_t MSimRays::PreProcess(MParList *pList)
         return kFALSE;
     }
 
+    fRandom = (MSimRandom*)pList->FindObject("MSimRandom");
+    if (fRandom && !fRandom->Setup(*pList))
+        return kFALSE;
+
     return kTRUE;
 }
 
@@ -158,14 +163,17 @@ Int_t MSimRays::Process()
     rot.RotateX( zd); // Rotate point on ground to align it with the telescope axis
     rot.RotateZ(-az); // tilt the point from ground to make it parallel to the mirror plane
 
+    // Random number stream of this task
+    TRandom &rnd = MSimRandom::GetStream(fRandom, *this);
+
     Int_t idx = 0;
     while (idx<num)
     {
         MPhotonData &dat = *static_cast<MPhotonData*>(arr.UncheckedAt(idx));
 
         Double_t x, y;
-        const Double_t r = gRandom->Uniform();
-        gRandom->Circle(x, y, maxr*TMath::Sqrt(r));
+        const Double_t r = rnd.Uniform();
+        rnd.Circle(x, y, maxr*TMath::Sqrt(r));
 /*
         Double_t ra = gRandom->Uniform(maxr);
         Double_t ph = gRandom->Uniform(TMath::TwoPi());
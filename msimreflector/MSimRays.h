@@ -12,10 +12,12 @@ class MPhotonEvent;
 class MCorsikaEvtHeader;
 
 class MReflector;
+class MSimRandom;
 
 class MSimRays : public MTask
 {
 private:
+    MSimRandom    *fRandom;     //! Random number service (optional)
     MPhotonEvent  *fEvt;        //! Event storing the photons
     MReflector    *fReflector;  //! Geometry of the reflector
     MPointingPos  *fPointPos;   //! Direction the telescope is pointing to
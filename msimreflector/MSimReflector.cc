@@ -39,9 +39,29 @@
 //  if you use MSimPSF to emulate a PSF by moving photons randomly
 //  on the focal plane. To switch off this check set detector margin to -1.
 //
+//  If the random number service MSimRandom is available the photons are
+//  processed in chunks of fixed size distributed over fNumThreads threads
+//  (<=0 means the number of cores). Each chunk uses its own random number
+//  stream (sub-stream of the task) and writes its output to its own range
+//  of the output arrays. The ranges are concatenated in order afterwards,
+//  so that the result does not depend on the number of threads. Without
+//  MSimRandom all photons are processed in a single thread using gRandom.
+//
+//  The photons are also stored in the mirror plane (MirrorPlane0: all
+//  photons, MirrorPlane2: not absorbed by the camera housing and can hit
+//  the reflector, MirrorPlane3: reflected) and in the focal plane
+//  (MirrorPlane4). Only those planes are filled which are used by a
+//  MFillH or MWriteRootFile in the task list (the others are empty),
+//  unless ForceMirrorPlanes is set. With SampleRate n>1 only every n-th
+//  photon is stored in the planes, e.g. for diagnostics of large
+//  productions.
+//
 //////////////////////////////////////////////////////////////////////////////
 #include "MSimReflector.h"
 
+#include <thread>
+#include <vector>
+
 #include <TMath.h>
 #include <TRandom.h>
 
@@ -51,6 +71,9 @@
 #include "MLogManip.h"
 
 #include "MParList.h"
+#include "MTaskList.h"
+#include "MSimRandom.h"
+#include "MRandomPhilox.h"
 
 #include "MQuaternion.h"
 #include "MMirror.h"
@@ -65,6 +88,9 @@
 
 #include "MPointingPos.h"
 
+#include "MFillH.h"
+#include "MWriteRootFile.h"
+
 ClassImp(MSimReflector);
 
 using namespace std;
@@ -72,15 +98,19 @@ using namespace std;
 // USEFUL CORSIKA OPTIONS:
 //  NOCLONG
 
+// Number of photons per chunk processed with one random number stream
+static const Int_t kChunkSize = 4096;
+
 // --------------------------------------------------------------------------
 //
 //  Default Constructor.
 //
 MSimReflector::MSimReflector(const char* name, const char *title)
-    : fEvt(0), fMirror0(0), fMirror1(0), fMirror2(0), fMirror3(0),
+    : fRandom(0), fEvt(0), fMirror0(0), fMirror1(0), fMirror2(0), fMirror3(0),
     fMirror4(0), /*fRunHeader(0),*/ fEvtHeader(0), fReflector(0),
     fGeomCam(0), fPointing(0), fNameReflector("MReflector"),
-    fDetectorFrame(0), fDetectorMargin(0)
+    fDetectorFrame(0), fDetectorMargin(0), fNumThreads(0),
+    fForceMirrorPlanes(kFALSE), fSampleRate(1), fMirrorPlanes(0), fFocalLength(0)
 {
     fName  = name  ? name  : "MSimReflector";
     fTitle = title ? title : "Task to calculate reflection os a mirror";
@@ -88,7 +118,31 @@ MSimReflector::MSimReflector(const char* name, const char *title)
 
 // --------------------------------------------------------------------------
 //
-// Search for the necessary parameter containers.
+// Return whether a MFillH or MWriteRootFile in the task list (or one of
+// its sub-lists) uses the container name.
+//
+Bool_t MSimReflector::IsUsed(const MTaskList &tlist, const char *name)
+{
+    TIter Next(tlist.GetList());
+    TObject *o=0;
+    while ((o=Next()))
+    {
+        if (o->InheritsFrom(MTaskList::Class()) && IsUsed(*static_cast<MTaskList*>(o), name))
+            return kTRUE;
+
+        if (o->InheritsFrom(MFillH::Class()) && static_cast<MFillH*>(o)->GetParContainerName()==name)
+            return kTRUE;
+
+        if (o->InheritsFrom(MWriteRootFile::Class()) && static_cast<MWriteRootFile*>(o)->HasContainer(name))
+            return kTRUE;
+    }
+    return kFALSE;
+}
+
+// --------------------------------------------------------------------------
+//
+// Search for the necessary parameter containers. Check which of the
+// mirror planes are used by other tasks.
 //
 Int_t MSimReflector::PreProcess(MParList *pList)
 {
@@ -163,6 +217,28 @@ Int_t MSimReflector::PreProcess(MParList *pList)
         return kFALSE;
     }
 
+    fRandom = (MSimRandom*)pList->FindObject("MSimRandom");
+    if (fRandom && !fRandom->Setup(*pList))
+        return kFALSE;
+
+    // Without task list (should not happen) fill all planes
+    const MTaskList *tlist = (MTaskList*)pList->FindObject("MTaskList");
+
+    fMirrorPlanes = 0;
+    for (Int_t i=0; i<5; i++)
+        if (fForceMirrorPlanes || !tlist || IsUsed(*tlist, Form("MirrorPlane%d", i)))
+            fMirrorPlanes |= 1<<i;
+
+    *fLog << inf << "Filled mirror planes:";
+    for (Int_t i=0; i<5; i++)
+        if (fMirrorPlanes&(1<<i))
+            *fLog << " " << i;
+    if (!fMirrorPlanes)
+        *fLog << " none";
+    if (fSampleRate>1)
+        *fLog << " (every " << fSampleRate << ". photon)";
+    *fLog << endl;
+
     return kTRUE;
 }
 
@@ -257,7 +333,7 @@ Int_t MSimReflector::PreProcess(MParList *pList)
 // random gaussian) and then the trajectory is reflected on the
 // resulting normal vector.
 //
-Bool_t MMirror::ExecuteReflection(MQuaternion &p, MQuaternion &u) const
+Bool_t MMirror::ExecuteReflection(MQuaternion &p, MQuaternion &u, TRandom *rnd) const
 {
     // If the z-componenet of the direction vector is normalized to 1
     // the calculation of the incident points becomes very simple and
@@ -308,7 +384,7 @@ Bool_t MMirror::ExecuteReflection(MQuaternion &p, MQuaternion &u) const
     TVector3 n(p.X(), p.Y(), -d);
 
     if (fSigmaPSF>0)
-        n += SimPSF(n);
+        n += SimPSF(n, rnd);
 
     // Changes also the sign of the z-direction of flight
     // This is faster giving identical results
@@ -326,7 +402,7 @@ Bool_t MMirror::ExecuteReflection(MQuaternion &p, MQuaternion &u) const
 // Depending on whether the mirror was hit kTRUE or kFALSE is returned.
 // It the mirror was not hit the result coordinates are wrong.
 //
-Bool_t MMirror::ExecuteMirror(MQuaternion &p, MQuaternion &u) const
+Bool_t MMirror::ExecuteMirror(MQuaternion &p, MQuaternion &u, TRandom *rnd) const
 {
     // Move the mirror to the point of origin and rotate the position into
     // the individual mirrors coordinate frame.
@@ -345,7 +421,7 @@ Bool_t MMirror::ExecuteMirror(MQuaternion &p, MQuaternion &u) const
 
     // Now try to  propagate the photon from the plane to the mirror
     // and reflect its direction vector on the mirror.
-    if (!ExecuteReflection(p, u))
+    if (!ExecuteReflection(p, u, rnd))
         return kFALSE;
 
     // Derotate from mirror coordinates and shift the photon back to
@@ -375,7 +451,7 @@ Bool_t MMirror::ExecuteMirror(MQuaternion &p, MQuaternion &u) const
 // intelligent way of finding the right mirror then just testing all
 // this could be accelerated a lot.
 //
-Int_t MReflector::ExecuteReflector(MQuaternion &p, MQuaternion &u) const
+Int_t MReflector::ExecuteReflector(MQuaternion &p, MQuaternion &u, TRandom *rnd) const
 {
     //static const TObjArray *arr = &((MMirror*)fMirrors[0])->fNeighbors;
 
@@ -411,7 +487,7 @@ Int_t MReflector::ExecuteReflector(MQuaternion &p, MQuaternion &u) const
         // Check if this mirror is hit, and if it is hit return
         // the reflected position and direction vector.
         // If the mirror is missed we go on with the next mirror.
-        if (!mirror.ExecuteMirror(q, v))
+        if (!mirror.ExecuteMirror(q, v, rnd))
             continue;
 
         // We hit a mirror. Restore the local copy of position and
@@ -429,53 +505,24 @@ Int_t MReflector::ExecuteReflector(MQuaternion &p, MQuaternion &u) const
 
 // --------------------------------------------------------------------------
 //
-// Converts the photons into the telscope coordinate frame using the
-// pointing position from MPointingPos.
-//
-// Reflects all photons on all mirrors and stores the final photons on
-// the focal plane. Also intermediate photons are stored for debugging.
+// Reflect the photons [first, last) of the event. The output of the
+// i-th step is written to the entries first, first+1, ... of the
+// corresponding array (fMirror0, fMirror2, fMirror3, fMirror4 and the
+// event itself) and the number of entries is counted in cnt[i]. Since
+// never more photons are written than read, ranges of different calls
+// do not overlap.
 //
-Int_t MSimReflector::Process()
+void MSimReflector::Reflect(Int_t first, Int_t last, TRandom &rnd, UInt_t cnt[6])
 {
-    // Get arrays from event container
-    TClonesArray &arr  = fEvt->GetArray();
-
-    // Because we knwo in advance what the maximum storage space could
-    // be we allocated it in advance (or shrink it if it was extremely
-    // huge before)
-    // Note, that the drawback is that an extremly large event
-    //       will take about five times its storage space
-    //       for a moment even if a lot from it is unused.
-    //       It will be freed in the next step.
-    fMirror0->Resize(arr.GetEntriesFast()); // Free memory of allocated MPhotonData
-    fMirror2->Resize(arr.GetEntriesFast()); // Free memory of allocated MPhotonData
-    fMirror3->Resize(arr.GetEntriesFast()); // Free memory of allocated MPhotonData
-    fMirror4->Resize(arr.GetEntriesFast()); // Free memory of allocated MPhotonData
-
-    // Initialize mirror properties
-    const Double_t F = fGeomCam->GetCameraDist()*100; // Focal length [cm]
-
-    // Local sky coordinates (direction of telescope axis)
-    const Double_t zd = fPointing->GetZdRad();  // x==north
-    const Double_t az = fPointing->GetAzRad();
-
-    // Rotation matrix to derotate sky
-    // For the new coordinate system see the Wiki
-    TRotation rot;    // The signs are positive because we align the incident point on ground to the telescope axis
-    rot.RotateZ( az); // Rotate point on ground to align it with the telescope axis
-    rot.RotateX(-zd); // tilt the point from ground to make it parallel to the mirror plane
-
-    // Now get the impact point from Corsikas output
-    const TVector3 impact(fEvtHeader->GetX(), fEvtHeader->GetY(), 0);
+    TClonesArray &arr = fEvt->GetArray();
 
-    // Counter for number of total and final events
-    UInt_t cnt[6] = { 0, 0, 0, 0, 0, 0 };
-
-    const Int_t num = arr.GetEntriesFast();
-    for (Int_t idx=0; idx<num; idx++)
+    for (Int_t idx=first; idx<last; idx++)
     {
         MPhotonData *dat = static_cast<MPhotonData*>(arr.UncheckedAt(idx));
 
+        // Which mirror planes get a copy of this photon
+        const Byte_t store = idx%fSampleRate==0 ? fMirrorPlanes : 0;
+
         // w is pointing away from the direction the photon comes from
         // CORSIKA-orig: x(north), y(west),  z(up), t(time)
         // NOW:          x(east),  y(north), z(up), t(time)
@@ -484,13 +531,13 @@ Int_t MSimReflector::Process()
 
         // Shift the coordinate system to the telescope. Corsika's
         // coordinate system is always w.r.t. to the particle axis
-        p -= impact;
+        p -= fImpact;
 
         // Rotate the coordinates into the reflector's coordinate system.
         // It is assumed that the z-plane is parallel to the focal plane.
         // (The reflector coordinate system is defined by the telescope orientation)
-        p *= rot;
-        w *= rot;
+        p *= fRotation;
+        w *= fRotation;
 
         // ---> Simulate star-light!
         // w.fVectorPart.SetXYZ(0.2/17, 0.2/17, -(1-TMath::Hypot(0.3, 0.2)/17));
@@ -502,26 +549,25 @@ Int_t MSimReflector::Process()
         dat->SetPosition(p); 
         dat->SetDirection(w);
 
-        (*fMirror0)[cnt[0]++] = *dat;
-        //*static_cast<MPhotonData*>(cpy0.UncheckedAt(cnt[0]++)) = *dat;
+        if (store&1)
+            (*fMirror0)[first+cnt[0]++] = *dat;
 
         // Check if the photon has hit the camera housing and holding
         if (fGeomCam->HitFrame(p, w, fDetectorFrame))
             continue;
 
         // FIXME: Do we really need this one??
-        //(*fMirror1)[cnt[1]++] = *dat;
-        //*static_cast<MPhotonData*>(cpy1.UncheckedAt(cnt[1]++)) = *dat;
+        //(*fMirror1)[first+cnt[1]++] = *dat;
 
         // Check if the reflector can be hit at all
         if (!fReflector->CanHit(p))
             continue;
 
-        (*fMirror2)[cnt[2]++] = *dat;
-        //*static_cast<MPhotonData*>(cpy2.UncheckedAt(cnt[2]++)) = *dat;
+        if (store&4)
+            (*fMirror2)[first+cnt[2]++] = *dat;
 
         // Now execute the reflection of the photon on the mirrors' surfaces
-        const Int_t num = fReflector->ExecuteReflector(p, w);
+        const Int_t num = fReflector->ExecuteReflector(p, w, &rnd);
         if (num<0)
             continue;
 
@@ -535,17 +581,17 @@ Int_t MSimReflector::Process()
         // also dat.fMirrorTag is set to num:
         dat->SetMirrorTag(num);
 
-        (*fMirror3)[cnt[3]++] = *dat;
-        //*static_cast<MPhotonData*>(cpy3.UncheckedAt(cnt[3]++)) = *dat;
+        if (store&8)
+            (*fMirror3)[first+cnt[3]++] = *dat;
 
         // Propagate the photon along its trajectory to the focal plane z=F
-        p.PropagateZ(w, F);
+        p.PropagateZ(w, fFocalLength);
 
         // Store new position
         dat->SetPosition(p);
 
-        (*fMirror4)[cnt[4]++] = *dat;
-        //*static_cast<MPhotonData*>(cpy4.UncheckedAt(cnt[4]++)) = *dat;
+        if (store&16)
+            (*fMirror4)[first+cnt[4]++] = *dat;
 
         // FIXME: It make make sense to move this out of this class
         // It is detector specific not reflector specific
@@ -554,17 +600,136 @@ Int_t MSimReflector::Process()
             continue;
 
         // Copy this event to the next 'new' in the list
-        *static_cast<MPhotonData*>(arr.UncheckedAt(cnt[5]++)) = *dat;
+        *static_cast<MPhotonData*>(arr.UncheckedAt(first+cnt[5]++)) = *dat;
+    }
+}
+
+// --------------------------------------------------------------------------
+//
+// Reflect the chunks ithread, ithread+nthreads, ... of the num photons of
+// the event. Chunk c uses the sub-stream c+1 of the random number service
+// and stores its counters in cnt[6*c] to cnt[6*c+5].
+//
+void MSimReflector::ReflectChunks(UInt_t ithread, UInt_t nthreads, Int_t num, UInt_t *cnt)
+{
+    MRandomPhilox rnd;
+
+    const Int_t nchunks = (num+kChunkSize-1)/kChunkSize;
+    for (Int_t c=ithread; c<nchunks; c+=nthreads)
+    {
+        fRandom->InitStream(rnd, *this, c+1);
+        Reflect(c*kChunkSize, TMath::Min(num, (c+1)*kChunkSize), rnd, cnt+6*c);
+    }
+}
+
+// --------------------------------------------------------------------------
+//
+// Move the entries written by the chunks (see MSimReflector::Reflect)
+// in order to the beginning of the array. k is the index of the counter.
+// Returns the total number of entries.
+//
+static UInt_t Concatenate(MPhotonEvent &evt, const UInt_t *cnt, Int_t nchunks, Int_t k)
+{
+    UInt_t n = 0;
+    for (Int_t c=0; c<nchunks; c++)
+    {
+        const UInt_t first = c*kChunkSize;
+        for (UInt_t i=0; i<cnt[6*c+k]; i++, n++)
+            if (n!=first+i)
+                evt[n] = evt[first+i];
+    }
+    return n;
+}
+
+// --------------------------------------------------------------------------
+//
+// Converts the photons into the telscope coordinate frame using the
+// pointing position from MPointingPos.
+//
+// Reflects all photons on all mirrors and stores the final photons on
+// the focal plane. Also intermediate photons are stored for debugging.
+//
+Int_t MSimReflector::Process()
+{
+    // Get arrays from event container
+    TClonesArray &arr  = fEvt->GetArray();
+
+    // Because we knwo in advance what the maximum storage space could
+    // be we allocated it in advance (or shrink it if it was extremely
+    // huge before)
+    // Note, that the drawback is that an extremly large event
+    //       will take about five times its storage space
+    //       for a moment even if a lot from it is unused.
+    //       It will be freed in the next step.
+    // Mirror planes which are not used stay empty.
+    fMirror0->Resize(fMirrorPlanes&1  ? arr.GetEntriesFast() : 0); // Free memory of allocated MPhotonData
+    fMirror2->Resize(fMirrorPlanes&4  ? arr.GetEntriesFast() : 0); // Free memory of allocated MPhotonData
+    fMirror3->Resize(fMirrorPlanes&8  ? arr.GetEntriesFast() : 0); // Free memory of allocated MPhotonData
+    fMirror4->Resize(fMirrorPlanes&16 ? arr.GetEntriesFast() : 0); // Free memory of allocated MPhotonData
+
+    // Initialize mirror properties
+    fFocalLength = fGeomCam->GetCameraDist()*100; // Focal length [cm]
+
+    // Local sky coordinates (direction of telescope axis)
+    const Double_t zd = fPointing->GetZdRad();  // x==north
+    const Double_t az = fPointing->GetAzRad();
+
+    // Rotation matrix to derotate sky
+    // For the new coordinate system see the Wiki
+    fRotation = TRotation(); // The signs are positive because we align the incident point on ground to the telescope axis
+    fRotation.RotateZ( az);  // Rotate point on ground to align it with the telescope axis
+    fRotation.RotateX(-zd);  // tilt the point from ground to make it parallel to the mirror plane
+
+    // Now get the impact point from Corsikas output
+    fImpact.SetXYZ(fEvtHeader->GetX(), fEvtHeader->GetY(), 0);
+
+    const Int_t num = arr.GetEntriesFast();
+
+    // Counter for number of total and final events
+    UInt_t n[6] = { 0, 0, 0, 0, 0, 0 };
+
+    if (!fRandom)
+        // gRandom can only be used from a single thread
+        Reflect(0, num, *gRandom, n);
+    else
+    {
+        const Int_t nchunks = (num+kChunkSize-1)/kChunkSize;
+
+        Int_t nthreads = fNumThreads>0 ? fNumThreads : thread::hardware_concurrency();
+        if (nthreads>nchunks)
+            nthreads = nchunks;
+
+        // Counters of all chunks
+        vector<UInt_t> cnt(6*nchunks, 0);
+
+        if (nthreads<=1)
+            ReflectChunks(0, 1, num, cnt.data());
+        else
+        {
+            vector<thread> threads;
+            for (Int_t i=0; i<nthreads; i++)
+                threads.push_back(thread(&MSimReflector::ReflectChunks, this,
+                                         i, nthreads, num, cnt.data()));
+
+            for (auto it=threads.begin(); it!=threads.end(); it++)
+                it->join();
+        }
+
+        n[0] = Concatenate(*fMirror0, cnt.data(), nchunks, 0);
+        n[2] = Concatenate(*fMirror2, cnt.data(), nchunks, 2);
+        n[3] = Concatenate(*fMirror3, cnt.data(), nchunks, 3);
+        n[4] = Concatenate(*fMirror4, cnt.data(), nchunks, 4);
+        n[5] = Concatenate(*fEvt,     cnt.data(), nchunks, 5);
     }
 
     // Now we shrink the array to a storable size (for details see
     // MPhotonEvent::Shrink).
-    fMirror0->Shrink(cnt[0]);
-    //fMirror1->Shrink(cnt[1]);
-    fMirror2->Shrink(cnt[2]);
-    fMirror3->Shrink(cnt[3]);
-    fMirror4->Shrink(cnt[4]);
-    fEvt->Shrink(cnt[5]);
+    fMirror0->Shrink(n[0]);
+    //fMirror1->Shrink(n[1]);
+    fMirror2->Shrink(n[2]);
+    fMirror3->Shrink(n[3]);
+    fMirror4->Shrink(n[4]);
+    fEvt->Shrink(n[5]);
 
     // Doesn't seem to be too time consuming. But we could also sort later!
     //  (after cones, inside the camera)
@@ -583,6 +748,9 @@ Int_t MSimReflector::Process()
 // --------------------------------------------------------------------------
 //
 // DetectorMargin: 0
+// NumThreads: 0
+// ForceMirrorPlanes: No
+// SampleRate: 1
 //
 Int_t MSimReflector::ReadEnv(const TEnv &env, TString prefix, Bool_t print)
 {
@@ -597,6 +765,21 @@ Int_t MSimReflector::ReadEnv(const TEnv &env, TString prefix, Bool_t print)
         rc = kTRUE;
         fDetectorMargin = GetEnvValue(env, prefix, "DetectorMargin", 0);
     }
+    if (IsEnvDefined(env, prefix, "NumThreads", print))
+    {
+        rc = kTRUE;
+        fNumThreads = GetEnvValue(env, prefix, "NumThreads", fNumThreads);
+    }
+    if (IsEnvDefined(env, prefix, "ForceMirrorPlanes", print))
+    {
+        rc = kTRUE;
+        SetForceMirrorPlanes(GetEnvValue(env, prefix, "ForceMirrorPlanes", fForceMirrorPlanes));
+    }
+    if (IsEnvDefined(env, prefix, "SampleRate", print))
+    {
+        rc = kTRUE;
+        SetSampleRate(GetEnvValue(env, prefix, "SampleRate", (Int_t)fSampleRate));
+    }
 
     return rc;
 }
@@ -5,17 +5,26 @@
 #include "MTask.h"
 #endif
 
+#ifndef ROOT_TRotation
+#include <TRotation.h>
+#endif
+
+class TRandom;
+
 class MParList;
 class MGeomCam;
 class MPointingPos;
 class MPhotonEvent;
 class MCorsikaEvtHeader;
 
+class MTaskList;
 class MReflector;
+class MSimRandom;
 
 class MSimReflector : public MTask
 {
 private:
+    MSimRandom       *fRandom;     //! Random number service (optional)
     MPhotonEvent     *fEvt;        //! Event  storing the photons
     MPhotonEvent     *fMirror0;    //! Event  storing the photons in the mirror plane (w/o camera shadow)
     MPhotonEvent     *fMirror1;    //! Event  storing the photons in the mirror plane (w/  camera shadow)
@@ -35,6 +44,23 @@ private:
     Double_t fDetectorFrame;     // A disk of radius DetectorFrame around the focal point absorbing photons
     Double_t fDetectorMargin;    // A margin around the detector (MGeomCam::HitCamera) in which photons are also stored
 
+    Int_t    fNumThreads;        // Number of threads (<=0: number of cores)
+
+    Bool_t   fForceMirrorPlanes; // Fill all mirror planes even if they are not used
+    UInt_t   fSampleRate;        // Store only every n-th photon in the mirror planes
+
+    Byte_t   fMirrorPlanes;      //! Bit i: MirrorPlane<i> is filled
+
+    TRotation fRotation;         //! Rotation from the ground into the reflector frame (current event)
+    TVector3  fImpact;           //! Impact point (current event)
+    Double_t  fFocalLength;      //! Focal length [cm]
+
+    // MSimReflector
+    void Reflect(Int_t first, Int_t last, TRandom &rnd, UInt_t cnt[6]);
+    void ReflectChunks(UInt_t ithread, UInt_t nthreads, Int_t num, UInt_t *cnt);
+
+    static Bool_t IsUsed(const MTaskList &tlist, const char *name);
+
     // MParContainer
     Int_t ReadEnv(const TEnv &env, TString prefix, Bool_t print);
 
@@ -52,6 +78,11 @@ public:
     void SetDetectorFrame(Double_t cm=0)  { fDetectorFrame  = cm; }
     void SetDetectorMargin(Double_t mm=0) { fDetectorMargin = mm; }
 
+    void SetNumThreads(Int_t n=0) { fNumThreads = n; }
+
+    void SetForceMirrorPlanes(Bool_t b=kTRUE) { fForceMirrorPlanes = b; }
+    void SetSampleRate(UInt_t n=1) { fSampleRate = n==0 ? 1 : n; }
+
     ClassDef(MSimReflector, 0) // Task to calculate reflection on a mirror
 };
 
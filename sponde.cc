@@ -12,6 +12,7 @@
 #include "MArgs.h"
 #include "MArray.h"
 #include "MDirIter.h"
+#include "MDirIndex.h"
 
 #include "MStatusDisplay.h"
 
@@ -73,6 +74,7 @@ static void Usage()
     gLog << "   --config=sponde.rc        Resource file [default=sponde.rc]" << endl;
     gLog << "   --ind=path                Path to mc/star files [default=datacenter path]"  << endl;
     gLog << "   --ins=path                Path to sequence files [default=datacenter path]"   << endl;
+    gLog << "   --dir-index=file          Store/read the directory listings to/from file"   << endl;
     gLog << "   --dataset=number          Choose a dataset from a collection of datasets"     << endl;
     gLog << "                             in your file (for more details see MDataSet)"       << endl;
     gLog << endl;
@@ -124,6 +126,7 @@ int main(int argc, char **argv)
     const Int_t   kNumDataset    = arg.GetIntAndRemove("--dataset=", -1);
     const TString kPathDataFiles = arg.GetStringAndRemove("--ind=",  "");
     const TString kPathSequences = arg.GetStringAndRemove("--ins=",  "");
+    const TString kDirIndex      = arg.GetStringAndRemove("--dir-index=", "");
     const Bool_t  kDebugMem     =  arg.HasOnlyAndRemove("--debug-mem");
     Int_t  kDebugEnv = arg.HasOnlyAndRemove("--debug-env") ? 1 : 0;
     kDebugEnv = arg.GetIntAndRemove("--debug-env=", kDebugEnv);
@@ -203,6 +206,13 @@ int main(int argc, char **argv)
     if (kDebugMem)
         TObject::SetObjectStat(kTRUE);
 
+    //
+    // Index of the directory listings to speed up finding the files
+    // (written back to the file at exit if it has changed)
+    //
+    MDirIndex index(kDirIndex.IsNull() ? 0 : kDirIndex.Data());
+    MDirIter::SetIndex(&index);
+
     //
     // Setup sequence and check its validity
     //